@@ -2,22 +2,24 @@
 // blinn-phong.frag by Hudson Schumaker
 // Copyright (c) 2020-2025 SchumakerTeam. All Rights Reserved.
 //
-// Fragment shader for blinn-phong.
+// Fragment shader for blinn-phong, lit by the point light of the frame.
 //-----------------------------------------------------------------------------
 #version 410 core
 
+#include "include/frame.glsl"
+
 in vec2 TexCoord;
 in vec3 FragPos;
 in vec3 Normal;
 
 uniform sampler2D texture_map;
-uniform vec3 lightPos;	 // for diffuse
-uniform vec3 lightColor; // for diffuse
-uniform vec3 viewPos;	 // for specular
 
 out vec4 frag_color;
 
 void main() {
+    vec3 lightPos   = pointLight.position.xyz; // for diffuse
+    vec3 lightColor = pointLight.diffuse.rgb;  // for diffuse
+
     // Ambient ---------------------------------------------------------
     float ambientFactor = 0.1;
     vec3 ambient = lightColor * ambientFactor;
@@ -32,7 +34,7 @@ void main() {
 	float shininess = 32.0;
 	float specularFactor = 0.8;
 	
-    vec3 viewDir  = normalize(viewPos - FragPos);
+    vec3 viewDir  = normalize(eye.xyz - FragPos);
 	vec3 halfDir  = normalize(lightDir + viewDir);
 	float NDotH   = max(dot(normal, halfDir), 0.0);
 	vec3 specular = lightColor * specularFactor * pow(NDotH, shininess);
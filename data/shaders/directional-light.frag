@@ -1,44 +1,46 @@
 #version 410 core
 
-struct Material {
-    vec3 ambient;
-    vec3 specular;
-    float shininess;
-    sampler2D diffuseMap;
-};
+// DE_TWO_SIDED: cards, back faces are lit from behind and show texture1
+
+#include "include/frame.glsl"
+#include "include/material.glsl"
 
-struct Light {
-	vec3 direction;
-	vec3 ambient;
-	vec3 diffuse;
-	vec3 specular;
-};
-  
 in vec2 TexCoord;
 in vec3 FragPos;
 in vec3 Normal;
 
-uniform Light light;
-uniform Material material;
-uniform vec3 eye;
+uniform sampler2D texture0; // diffuse map
+#ifdef DE_TWO_SIDED
+uniform sampler2D texture1; // diffuse map of the back face
+#endif
 
 out vec4 frag_color;
 
 void main() { 
+    vec3 normal = normalize(Normal);
+#ifdef DE_TWO_SIDED
+    vec3 albedo = gl_FrontFacing ? texture(texture0, TexCoord).rgb 
+                                 : texture(texture1, TexCoord).rgb;
+    if (!gl_FrontFacing) {
+        normal = -normal; // Flip normal for the back face
+    }
+#else
+    vec3 albedo = texture(texture0, TexCoord).rgb;
+#endif
+
     // Ambient -------------------------------------------------------------------------
-    vec3 ambient = light.ambient * material.ambient * vec3(texture(material.diffuseMap, TexCoord));
+    vec3 ambient = light.ambient.rgb * material.ambient.rgb * albedo;
   	
     // Diffuse -------------------------------------------------------------------------
-    vec3  normal   = normalize(Normal);
-	vec3  lightDir = normalize(-light.direction);
+	vec3  lightDir = normalize(-light.direction.xyz);
 	float NdotL    = max(dot(normal, lightDir), 0.0);
-    vec3  diffuse  = light.diffuse * NdotL * vec3(texture(material.diffuseMap, TexCoord));
+    vec3  diffuse  = light.diffuse.rgb * NdotL * albedo;
     
     // Specular - Blinn-Phong ----------------------------------------------------------
-	vec3 viewDir  = normalize(eye - FragPos);
+	vec3 viewDir  = normalize(eye.xyz - FragPos);
 	vec3 halfDir  = normalize(lightDir + viewDir);
 	float NDotH   = max(dot(normal, halfDir), 0.0);
-	vec3 specular = light.specular * material.specular * pow(NDotH, material.shininess);
+	vec3 specular = light.specular.rgb * material.specular.rgb * pow(NDotH, material.shininess);
 		
     frag_color = vec4(ambient + diffuse + specular, 1.0);
 }
@@ -1,20 +1,62 @@
 #version 410 core
 
-layout (location = 0) in vec3 aPosition;			
-layout (location = 1) in vec3 aNormal;	
+// DE_PACKED_VERTEX: meshes in a packed vertex format, positions are dequantized and normals oct decoded
+// DE_INSTANCED: model and normal matrix come from the instance buffer, one draw for many objects
+
+#ifdef DE_PACKED_VERTEX
+layout (location = 0) in vec3 aPosition; // float or int16, see dequantScale/dequantOffset
+layout (location = 1) in vec2 aNormal;   // octahedral encoded, snorm16
+layout (location = 2) in vec2 aTexCoord; // half float
+#else
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
+#endif
+
+#include "include/frame.glsl"
 
-uniform mat4 model;		 // model matrix
-uniform mat4 view;		 // view matrix
-uniform mat4 projection; // projection matrix
+#ifdef DE_INSTANCED
+layout (location = 3) in mat4 aModel;        // locations 3 to 6
+layout (location = 7) in mat3 aNormalMatrix; // locations 7 to 9, scaled inverse transpose of the model
+#else
+uniform mat4 model; // model matrix
+#endif
+
+#ifdef DE_PACKED_VERTEX
+uniform vec3 dequantScale;  // per-mesh position scale (1.0 for float positions)
+uniform vec3 dequantOffset; // per-mesh position offset (0.0 for float positions)
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+#endif
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 
 void main() {
+#ifdef DE_PACKED_VERTEX
+    vec3 position = aPosition * dequantScale + dequantOffset;
+    vec3 normal   = octDecode(aNormal);
+#else
+    vec3 position = aPosition;
+    vec3 normal   = aNormal;
+#endif
+
+#ifdef DE_INSTANCED
+    mat4 model = aModel;
+    mat3 normalMatrix = aNormalMatrix;
+#else
+    mat3 normalMatrix = mat3(transpose(inverse(model)));
+#endif
+
 	TexCoord = aTexCoord;
-    FragPos  = vec3(model * vec4(aPosition, 1.0));		  // vertex position in world space
-    Normal   = mat3(transpose(inverse(model))) * aNormal; // normal direction in world space
-	gl_Position = projection * view *  model * vec4(aPosition, 1.0);
+    FragPos  = vec3(model * vec4(position, 1.0));		 // vertex position in world space
+    Normal   = normalMatrix * normal; // normal direction in world space
+	gl_Position = projection * view * model * vec4(position, 1.0);
 }
@@ -1,17 +1,20 @@
 #version 410 core
 
+#include "include/frame.glsl"
+
 in vec3 FragPos;  // Fragment position in world space
 in vec3 Normal;   // Interpolated normal
 in vec2 TexCoords;
 
 out vec4 FragColor;
 
-uniform vec3 eye;           // Camera position
 uniform sampler2D texture0; // Card base texture
-uniform vec3 lightPos;      // Light source position
-uniform vec3 lightColor;    // Light color
 
 void main() {
+    // Lit by the point light of the frame
+    vec3 lightPos   = pointLight.position.xyz;
+    vec3 lightColor = pointLight.diffuse.rgb;
+
     // Base color from texture
     vec3 albedo = texture(texture0, TexCoords).rgb;
 
@@ -22,7 +25,7 @@ void main() {
     vec3 lightDir = normalize(lightPos - FragPos);
     
     // View direction
-    vec3 viewDir = normalize(eye - FragPos);
+    vec3 viewDir = normalize(eye.xyz - FragPos);
     
     // Reflect light (specular)
     vec3 reflectDir = reflect(-lightDir, normal);
@@ -0,0 +1,36 @@
+// Shared by every lit shader, the layout matches frame_block_t in de_frame.c
+
+struct DirectionalLight {
+	vec4 direction;
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+};
+
+struct PointLight {
+	vec4 position;
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+	vec4 attenuation; // constant, linear, quadratic
+};
+
+struct SpotLight {
+	vec4 position;
+	vec4 direction;
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+	vec4 cone;        // cos inner, cos outer, 1 when on
+	vec4 attenuation; // constant, linear, quadratic
+};
+
+// Uploaded once per frame and shared by every program, see de_frame.c
+layout (std140) uniform FrameBlock {
+	mat4 view;
+	mat4 projection;
+	vec4 eye;
+	DirectionalLight light;
+	PointLight pointLight;
+	SpotLight spotLight;
+};
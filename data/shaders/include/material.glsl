@@ -0,0 +1,7 @@
+// One buffer per distinct material, the layout matches material_block_t in de_material.c
+layout (std140) uniform MaterialBlock {
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+	float shininess;
+} material;
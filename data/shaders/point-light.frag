@@ -1,52 +1,38 @@
 #version 410 core
 
-struct Material {
-	vec3 ambient;
-    sampler2D diffuseMap;
-    vec3 specular;
-    float shininess;
-};
-
-struct PointLight {
-	vec3 position;
-	vec3 ambient;
-	vec3 diffuse;
-	vec3 specular;
-
-	float constant;  // Kc
-	float linear;    // Kl
-	float quadratic; // Kq
-};
+#include "include/frame.glsl"
+#include "include/material.glsl"
 
 in vec2 TexCoord;
 in vec3 FragPos;
 in vec3 Normal;
 
-uniform PointLight pointLight;
-uniform Material material;
-uniform vec3 viewPos;
+uniform sampler2D texture0; // diffuse map
 
 out vec4 frag_color;
 
 void main() {
+    vec3 albedo = texture(texture0, TexCoord).rgb;
+
     // Ambient ------------------------------------------------------------------------------
-	vec3 ambient = pointLight.ambient * material.ambient * vec3(texture(material.diffuseMap, TexCoord));
+	vec3 ambient = pointLight.ambient.rgb * material.ambient.rgb * albedo;
   	
     // Diffuse ------------------------------------------------------------------------------
     vec3 normal   = normalize(Normal); 
-    vec3 lightDir = normalize(pointLight.position - FragPos);
+    vec3 lightDir = normalize(pointLight.position.xyz - FragPos);
     float NdotL   = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse  = pointLight.diffuse * NdotL * vec3(texture(material.diffuseMap, TexCoord));
+    vec3 diffuse  = pointLight.diffuse.rgb * NdotL * albedo;
     
     // Specular - Blinn-Phong --------------------------------------------------------------
-	vec3 viewDir  = normalize(viewPos - FragPos);
+	vec3 viewDir  = normalize(eye.xyz - FragPos);
 	vec3 halfDir  = normalize(lightDir + viewDir);
 	float NDotH   = max(dot(normal, halfDir), 0.0);
-	vec3 specular = pointLight.specular * material.specular * pow(NDotH, material.shininess);
+	vec3 specular = pointLight.specular.rgb * material.specular.rgb * pow(NDotH, material.shininess);
 	
 	// Attenuation using Kc, Kl, Kq ---------------------------------------------------------
-	float d = length(pointLight.position - FragPos);  // distance to light
-	float attenuation = 1.0 / (pointLight.constant + pointLight.linear * d + pointLight.quadratic * (d * d));
+	vec3 k = pointLight.attenuation.xyz;
+	float d = length(pointLight.position.xyz - FragPos);  // distance to light
+	float attenuation = 1.0 / (k.x + k.y * d + k.z * (d * d));
 
 	diffuse *= attenuation;
 	specular *= attenuation;
@@ -4,9 +4,9 @@ layout (location = 0) in vec3 aPosition;
 layout (location = 1) in vec3 aNormal;	
 layout (location = 2) in vec2 aTexCoord;
 
-uniform mat4 model;		 // model matrix
-uniform mat4 view;		 // view matrix
-uniform mat4 projection; // projection matrix
+#include "include/frame.glsl"
+
+uniform mat4 model; // model matrix
 
 out vec3 FragPos;
 out vec3 Normal;
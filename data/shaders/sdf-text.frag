@@ -0,0 +1,18 @@
+#version 410 core
+
+// Text from signed distance field pages, drawn with sprite.vert.
+// The edge is at 0.5, antialiased over about a pixel at any size.
+
+in vec2 TexCoord;
+in vec4 Color;
+
+uniform sampler2D texture0; // distance field, red channel
+
+out vec4 frag_color;
+
+void main() {
+    float distance = texture(texture0, TexCoord).r;
+    float width = max(fwidth(distance), 0.0001);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    frag_color = vec4(Color.rgb, Color.a * alpha);
+}
@@ -0,0 +1,12 @@
+#version 410 core
+
+in vec2 TexCoord;
+in vec4 Color;
+
+uniform sampler2D texture0;
+
+out vec4 frag_color;
+
+void main() {
+    frag_color = texture(texture0, TexCoord) * Color;
+}
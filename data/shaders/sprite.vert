@@ -0,0 +1,18 @@
+#version 410 core
+
+// Sprite batch: pixel positions, the color is multiplied with the texture
+
+layout (location = 0) in vec2 aPosition;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+uniform mat4 projection; // window pixels, origin at the top-left
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main() {
+    gl_Position = projection * vec4(aPosition, 0.0, 1.0);
+    TexCoord = aTexCoord;
+    Color = aColor;
+}
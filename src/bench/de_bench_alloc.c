@@ -0,0 +1,87 @@
+/**
+* @file de_bench_alloc.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "de_bench_alloc.h"
+
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+// Every block carries its size in a header, padded to keep 16-byte alignment
+#define BENCH_ALLOC_HEADER 16
+
+static bench_alloc_stats_t stats;
+
+static void bench_alloc_track(size_t added, size_t removed) {
+	stats.current_bytes += added;
+	stats.current_bytes -= removed;
+	if (stats.current_bytes > stats.peak_bytes) {
+		stats.peak_bytes = stats.current_bytes;
+	}
+}
+
+void* bench_malloc(size_t size) {
+	char* block = (char*)malloc(size + BENCH_ALLOC_HEADER);
+	if (block == NULL) {
+		return NULL;
+	}
+	*(size_t*)block = size;
+	stats.allocations++;
+	bench_alloc_track(size, 0);
+	return block + BENCH_ALLOC_HEADER;
+}
+
+void* bench_calloc(size_t count, size_t size) {
+	void* memory = bench_malloc(count * size);
+	if (memory != NULL) {
+		memset(memory, 0, count * size);
+	}
+	return memory;
+}
+
+void* bench_realloc(void* memory, size_t size) {
+	if (memory == NULL) {
+		return bench_malloc(size);
+	}
+	if (size == 0) {
+		bench_free(memory);
+		return NULL;
+	}
+
+	char* block = (char*)memory - BENCH_ALLOC_HEADER;
+	size_t old_size = *(size_t*)block;
+	char* grown = (char*)realloc(block, size + BENCH_ALLOC_HEADER);
+	if (grown == NULL) {
+		return NULL;
+	}
+	*(size_t*)grown = size;
+	if (size > old_size) {
+		stats.allocations++;
+	}
+	bench_alloc_track(size, old_size);
+	return grown + BENCH_ALLOC_HEADER;
+}
+
+void bench_free(void* memory) {
+	if (memory == NULL) {
+		return;
+	}
+	char* block = (char*)memory - BENCH_ALLOC_HEADER;
+	bench_alloc_track(0, *(size_t*)block);
+	free(block);
+}
+
+void bench_alloc_reset(void) {
+	stats.allocations = 0;
+	stats.peak_bytes = stats.current_bytes;
+}
+
+bench_alloc_stats_t bench_alloc_stats(void) {
+	return stats;
+}
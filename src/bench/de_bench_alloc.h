@@ -0,0 +1,32 @@
+/**
+* @file de_bench_alloc.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include <stdlib.h>
+#include <string.h>
+
+// Force-included in every translation unit of de_bench_io, so the engine code
+// allocates through these counters without any change to its sources.
+typedef struct {
+	size_t allocations;   // malloc, calloc and growing realloc calls
+	size_t current_bytes;
+	size_t peak_bytes;
+} bench_alloc_stats_t;
+
+void* bench_malloc(size_t size);
+void* bench_calloc(size_t count, size_t size);
+void* bench_realloc(void* memory, size_t size);
+void bench_free(void* memory);
+
+void bench_alloc_reset(void);
+bench_alloc_stats_t bench_alloc_stats(void);
+
+#define malloc(size) bench_malloc(size)
+#define calloc(count, size) bench_calloc(count, size)
+#define realloc(memory, size) bench_realloc(memory, size)
+#define free(memory) bench_free(memory)
@@ -0,0 +1,299 @@
+/**
+* @file de_bench_io.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../include/pch.h"
+#include "../include/de_mesh.h"
+#include "../include/de_obj_loader.h"
+#include "de_bench_alloc.h"
+#include <psapi.h>
+#include <direct.h>
+
+// Headless import benchmark: generates a deterministic OBJ corpus and times
+// obj_load plus everything mesh_import runs after it, writing the results as JSON.
+//
+// usage: de_bench_io [--corpus DIR] [--out FILE] [--max-triangles N] [--runs N]
+
+#define BENCH_DEFAULT_CORPUS "bench_corpus"
+#define BENCH_DEFAULT_OUT "de_bench_io.json"
+#define BENCH_DEFAULT_MAX_TRIANGLES 10000000
+#define BENCH_PATH_SIZE 512
+
+typedef enum {
+	OBJ_VARIANT_FULL,   // f v/vt/vn
+	OBJ_VARIANT_NORMAL, // f v//vn
+	OBJ_VARIANT_UV,     // f v/vt
+	OBJ_VARIANT_PLAIN,  // f v
+	OBJ_VARIANTS
+} obj_variant_t;
+
+static const char* variant_names[OBJ_VARIANTS] = { "v_vt_vn", "v_vn", "v_vt", "v" };
+static const int corpus_sizes[] = { 1000, 10000, 100000, 1000000, 10000000 };
+
+typedef struct {
+	char name[64];
+	int triangles;
+	obj_variant_t variant;
+	long long file_bytes;
+
+	double parse_seconds;
+	double process_seconds;
+	double pack_seconds;
+	double total_seconds;
+
+	int vertices;
+	int lod_count;
+	int meshlet_count;
+	size_t allocations;
+	size_t peak_heap_bytes;
+	size_t peak_rss_bytes;
+} bench_result_t;
+
+static double bench_now(void) {
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+static size_t bench_peak_rss(void) {
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+}
+
+static long long bench_file_size(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return -1;
+	}
+	_fseeki64(file, 0, SEEK_END);
+	long long size = _ftelli64(file);
+	fclose(file);
+	return size;
+}
+
+static float bench_height(float x, float z) {
+	return 0.25f * sinf(x * 0.37f) * cosf(z * 0.23f);
+}
+
+static void bench_generate_obj(const char* path, int triangles, obj_variant_t variant) {
+	FILE* file = fopen(path, "w");
+	if (file == NULL) {
+		fprintf(stderr, "failed to create corpus file: %s.\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	// Rolling height field on a grid with two triangles per cell
+	int cells = triangles / 2;
+	int width = (int)sqrt((double)cells);
+	int depth = cells / width;
+	bool has_uv = variant == OBJ_VARIANT_FULL || variant == OBJ_VARIANT_UV;
+	bool has_normal = variant == OBJ_VARIANT_FULL || variant == OBJ_VARIANT_NORMAL;
+
+	fprintf(file, "# de_bench_io corpus: %d triangles, %s\n", width * depth * 2, variant_names[variant]);
+	for (int z = 0; z <= depth; z++) {
+		for (int x = 0; x <= width; x++) {
+			fprintf(file, "v %.6f %.6f %.6f\n", (float)x, bench_height((float)x, (float)z), (float)z);
+		}
+	}
+	if (has_uv) {
+		for (int z = 0; z <= depth; z++) {
+			for (int x = 0; x <= width; x++) {
+				fprintf(file, "vt %.6f %.6f\n", (float)x / width, (float)z / depth);
+			}
+		}
+	}
+	if (has_normal) {
+		for (int z = 0; z <= depth; z++) {
+			for (int x = 0; x <= width; x++) {
+				float dx = 0.25f * 0.37f * cosf(x * 0.37f) * cosf(z * 0.23f);
+				float dz = -0.25f * 0.23f * sinf(x * 0.37f) * sinf(z * 0.23f);
+				float length = sqrtf(dx * dx + 1.0f + dz * dz);
+				fprintf(file, "vn %.6f %.6f %.6f\n", -dx / length, 1.0f / length, -dz / length);
+			}
+		}
+	}
+
+	for (int z = 0; z < depth; z++) {
+		for (int x = 0; x < width; x++) {
+			int a = z * (width + 1) + x + 1;
+			int b = a + 1;
+			int c = a + width + 1;
+			int d = c + 1;
+			int quad[2][3] = { { a, c, b }, { b, c, d } };
+			for (int t = 0; t < 2; t++) {
+				fputc('f', file);
+				for (int k = 0; k < 3; k++) {
+					int i = quad[t][k];
+					switch (variant) {
+					case OBJ_VARIANT_FULL:   fprintf(file, " %d/%d/%d", i, i, i); break;
+					case OBJ_VARIANT_NORMAL: fprintf(file, " %d//%d", i, i); break;
+					case OBJ_VARIANT_UV:     fprintf(file, " %d/%d", i, i); break;
+					default:                 fprintf(file, " %d", i); break;
+					}
+				}
+				fputc('\n', file);
+			}
+		}
+	}
+	fclose(file);
+}
+
+static void bench_run_case(const char* path, bench_result_t* result) {
+	bench_alloc_reset();
+
+	double start = bench_now();
+	mesh_t* mesh = mesh_new();
+	if (!obj_load(mesh, path)) {
+		exit(EXIT_FAILURE);
+	}
+	double parsed = bench_now();
+
+	mesh_process(mesh);
+	double processed = bench_now();
+
+	// CPU half of mesh_upload: vertex packing and index narrowing
+	quantized_vertex_t* vertices = mesh_vertex_to_quantized_buffer(mesh);
+	void* indices = mesh->vertex_count < 65536 ? (void*)mesh_index_to_gl_buffer_u16(mesh) : (void*)mesh_index_to_gl_buffer(mesh);
+	free(vertices);
+	free(indices);
+	double packed = bench_now();
+
+	bench_alloc_stats_t stats = bench_alloc_stats();
+	result->parse_seconds = parsed - start;
+	result->process_seconds = processed - parsed;
+	result->pack_seconds = packed - processed;
+	result->total_seconds = packed - start;
+	result->vertices = mesh->vertex_count;
+	result->lod_count = mesh->lod_count;
+	result->meshlet_count = mesh->meshlet_count;
+	result->allocations = stats.allocations;
+	result->peak_heap_bytes = stats.peak_bytes;
+	result->peak_rss_bytes = bench_peak_rss();
+
+	mesh_delete(mesh);
+}
+
+static void bench_write_json(const char* path, const bench_result_t* results, int count, int runs) {
+	FILE* file = fopen(path, "w");
+	if (file == NULL) {
+		fprintf(stderr, "failed to write results: %s.\n", path);
+		return;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"benchmark\": \"de_bench_io\",\n");
+#ifdef _DEBUG
+	fprintf(file, "  \"configuration\": \"debug\",\n");
+#else
+	fprintf(file, "  \"configuration\": \"release\",\n");
+#endif
+	fprintf(file, "  \"timestamp\": %lld,\n", (long long)time(NULL));
+	fprintf(file, "  \"runs\": %d,\n", runs);
+	fprintf(file, "  \"cases\": [\n");
+	for (int i = 0; i < count; i++) {
+		const bench_result_t* r = &results[i];
+		double megabytes = (double)r->file_bytes / (1024.0 * 1024.0);
+		fprintf(file, "    {\n");
+		fprintf(file, "      \"name\": \"%s\",\n", r->name);
+		fprintf(file, "      \"triangles\": %d,\n", r->triangles);
+		fprintf(file, "      \"variant\": \"%s\",\n", variant_names[r->variant]);
+		fprintf(file, "      \"file_bytes\": %lld,\n", r->file_bytes);
+		fprintf(file, "      \"vertices\": %d,\n", r->vertices);
+		fprintf(file, "      \"lods\": %d,\n", r->lod_count);
+		fprintf(file, "      \"meshlets\": %d,\n", r->meshlet_count);
+		fprintf(file, "      \"parse_seconds\": %.6f,\n", r->parse_seconds);
+		fprintf(file, "      \"process_seconds\": %.6f,\n", r->process_seconds);
+		fprintf(file, "      \"pack_seconds\": %.6f,\n", r->pack_seconds);
+		fprintf(file, "      \"total_seconds\": %.6f,\n", r->total_seconds);
+		fprintf(file, "      \"parse_mb_per_sec\": %.3f,\n", r->parse_seconds > 0.0 ? megabytes / r->parse_seconds : 0.0);
+		fprintf(file, "      \"vertices_per_sec\": %.1f,\n", r->total_seconds > 0.0 ? r->vertices / r->total_seconds : 0.0);
+		fprintf(file, "      \"allocations\": %zu,\n", r->allocations);
+		fprintf(file, "      \"peak_heap_bytes\": %zu,\n", r->peak_heap_bytes);
+		fprintf(file, "      \"peak_rss_bytes\": %zu\n", r->peak_rss_bytes);
+		fprintf(file, "    }%s\n", i + 1 < count ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+	fclose(file);
+}
+
+int main(int argc, char* argv[]) {
+	const char* corpus = BENCH_DEFAULT_CORPUS;
+	const char* out = BENCH_DEFAULT_OUT;
+	int max_triangles = BENCH_DEFAULT_MAX_TRIANGLES;
+	int runs = 1;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+			corpus = argv[++i];
+		}
+		else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+			out = argv[++i];
+		}
+		else if (strcmp(argv[i], "--max-triangles") == 0 && i + 1 < argc) {
+			max_triangles = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+			runs = atoi(argv[++i]);
+			runs = runs < 1 ? 1 : runs;
+		}
+	}
+	_mkdir(corpus);
+
+	int size_count = (int)(sizeof(corpus_sizes) / sizeof(corpus_sizes[0]));
+	bench_result_t* results = (bench_result_t*)calloc((size_t)size_count * OBJ_VARIANTS, sizeof(bench_result_t));
+	if (results == NULL) {
+		fprintf(stderr, "failed to allocate memory for results.\n");
+		return EXIT_FAILURE;
+	}
+
+	int count = 0;
+	for (int s = 0; s < size_count && corpus_sizes[s] <= max_triangles; s++) {
+		for (int v = 0; v < OBJ_VARIANTS; v++) {
+			bench_result_t* result = &results[count++];
+			result->triangles = corpus_sizes[s];
+			result->variant = (obj_variant_t)v;
+			snprintf(result->name, sizeof(result->name), "grid_%d_%s", corpus_sizes[s], variant_names[v]);
+
+			// The corpus is deterministic, files from an earlier run are reused
+			char path[BENCH_PATH_SIZE];
+			snprintf(path, sizeof(path), "%s/%s.obj", corpus, result->name);
+			if (bench_file_size(path) <= 0) {
+				printf("generating %s\n", path);
+				bench_generate_obj(path, corpus_sizes[s], (obj_variant_t)v);
+			}
+			result->file_bytes = bench_file_size(path);
+
+			// Keep the fastest run of each case
+			bench_result_t best;
+			for (int r = 0; r < runs; r++) {
+				bench_result_t run = *result;
+				bench_run_case(path, &run);
+				if (r == 0 || run.total_seconds < best.total_seconds) {
+					best = run;
+				}
+			}
+			*result = best;
+
+			printf("%-28s %10.3f ms  %8.2f MB/s  %12.0f verts/s  %zu allocs\n", result->name, result->total_seconds * 1000.0,
+				result->parse_seconds > 0.0 ? result->file_bytes / (1024.0 * 1024.0) / result->parse_seconds : 0.0,
+				result->total_seconds > 0.0 ? result->vertices / result->total_seconds : 0.0, result->allocations);
+		}
+	}
+
+	bench_write_json(out, results, count, runs);
+	printf("results written to %s\n", out);
+
+	free(results);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/**
+* @file de_bench_shader.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../include/pch.h"
+#include "../include/de_util.h"
+#include "../include/de_program.h"
+
+// Startup shader benchmark: builds every program and variant the engine ships, once one after
+// the other the way program_compile does and once as a batch that begins all builds
+// before reading any status back, writing the results as JSON.
+//
+// Meant to run on Mesa llvmpipe so the numbers are comparable between machines:
+// put Mesa's opengl32.dll next to the executable and set GALLIUM_DRIVER=llvmpipe.
+// Set MESA_SHADER_CACHE_DISABLE=true as well, or the second round only measures the disk cache.
+//
+// Run from the folder holding data/shaders.
+//
+// usage: de_bench_shader [--out FILE] [--runs N]
+
+#define BENCH_DEFAULT_OUT "de_bench_shader.json"
+#define BENCH_DEFINES_SIZE (SHADER_DEFINES_SIZE + 64)
+
+typedef struct {
+	const char* vert;
+	const char* frag;
+	shader_key_t key;
+} bench_program_t;
+
+static const bench_program_t bench_programs[] = {
+	{ "basic.vert", "basic.frag", SHADER_KEY_NONE },
+	{ "cube.vert", "cube.frag", SHADER_KEY_NONE },
+	{ "directional-light.vert", "directional-light.frag", SHADER_KEY_NONE },
+	{ "directional-light.vert", "directional-light.frag", SHADER_PACKED_VERTEX },
+	{ "directional-light.vert", "directional-light.frag", SHADER_TWO_SIDED },
+	{ "directional-light.vert", "directional-light.frag", SHADER_PACKED_VERTEX | SHADER_INSTANCED },
+	{ "blinn-phong.vert", "blinn-phong.frag", SHADER_KEY_NONE },
+	{ "blinn-phong-materials.vert", "blinn-phong-materials.frag", SHADER_KEY_NONE },
+	{ "fresnel.vert", "fresnel.frag", SHADER_KEY_NONE },
+	{ "point-light.vert", "point-light.frag", SHADER_KEY_NONE },
+	{ "spot-light.vert", "spot-light.frag", SHADER_KEY_NONE },
+	{ "sprite.vert", "sprite.frag", SHADER_KEY_NONE },
+	{ "sprite.vert", "sdf-text.frag", SHADER_KEY_NONE },
+};
+#define BENCH_PROGRAM_COUNT (int)(sizeof(bench_programs) / sizeof(bench_programs[0]))
+
+typedef struct {
+	double serial_seconds;
+	double batch_seconds;
+	double batch_issue_seconds; // time until every build was begun, what the caller is blocked for
+	int failures;
+} bench_result_t;
+
+static double bench_now(void) {
+	return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
+}
+
+// Every run injects its own define so the driver cannot hand back a program it built before
+static void bench_defines(char* defines, int run, int mode, shader_key_t key) {
+	char variant[SHADER_DEFINES_SIZE];
+	shader_key_defines(key, variant, sizeof(variant));
+	snprintf(defines, BENCH_DEFINES_SIZE, "#define DE_BENCH_RUN %d\n%s", run * 2 + mode, variant);
+}
+
+static double bench_serial(int run, int* failures) {
+	char defines[BENCH_DEFINES_SIZE];
+
+	double start = bench_now();
+	for (int i = 0; i < BENCH_PROGRAM_COUNT; i++) {
+		bench_defines(defines, run, 0, bench_programs[i].key);
+		char* vertex_path = create_shader_path(bench_programs[i].vert);
+		char* fragment_path = create_shader_path(bench_programs[i].frag);
+		program_t program;
+		program_init(&program);
+		*failures += !program_compile_defines(&program, vertex_path, fragment_path, defines);
+		program_delete(&program);
+		free(vertex_path);
+		free(fragment_path);
+	}
+	glFinish();
+	return bench_now() - start;
+}
+
+static double bench_batch(int run, int* failures, double* issue_seconds) {
+	char defines[BENCH_DEFINES_SIZE];
+	program_t programs[BENCH_PROGRAM_COUNT];
+	program_build_t builds[BENCH_PROGRAM_COUNT];
+	bool begun[BENCH_PROGRAM_COUNT];
+
+	int remaining = 0;
+	double start = bench_now();
+	for (int i = 0; i < BENCH_PROGRAM_COUNT; i++) {
+		bench_defines(defines, run, 1, bench_programs[i].key);
+		char* vertex_path = create_shader_path(bench_programs[i].vert);
+		char* fragment_path = create_shader_path(bench_programs[i].frag);
+		program_init(&programs[i]);
+		begun[i] = program_build_begin(&builds[i], &programs[i], vertex_path, fragment_path, defines);
+		remaining += begun[i];
+		*failures += !begun[i];
+		free(vertex_path);
+		free(fragment_path);
+	}
+	*issue_seconds = bench_now() - start;
+
+	// Poll the way a loading screen would, ending builds in whatever order they complete
+	while (remaining > 0) {
+		for (int i = 0; i < BENCH_PROGRAM_COUNT; i++) {
+			if (!begun[i] || !program_build_is_done(&builds[i])) {
+				continue;
+			}
+			*failures += !program_build_end(&builds[i]);
+			begun[i] = false;
+			remaining--;
+		}
+		if (remaining > 0) {
+			SDL_Delay(0);
+		}
+	}
+	glFinish();
+	double seconds = bench_now() - start;
+
+	for (int i = 0; i < BENCH_PROGRAM_COUNT; i++) {
+		program_delete(&programs[i]);
+	}
+	return seconds;
+}
+
+static void bench_write_json(const char* path, const bench_result_t* results, int runs) {
+	FILE* file = fopen(path, "w");
+	if (file == NULL) {
+		fprintf(stderr, "failed to write results: %s.\n", path);
+		return;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"benchmark\": \"de_bench_shader\",\n");
+#ifdef _DEBUG
+	fprintf(file, "  \"configuration\": \"debug\",\n");
+#else
+	fprintf(file, "  \"configuration\": \"release\",\n");
+#endif
+	fprintf(file, "  \"timestamp\": %lld,\n", (long long)time(NULL));
+	fprintf(file, "  \"renderer\": \"%s\",\n", (const char*)glGetString(GL_RENDERER));
+	fprintf(file, "  \"version\": \"%s\",\n", (const char*)glGetString(GL_VERSION));
+	fprintf(file, "  \"parallel_compile\": %s,\n", program_parallel_compile_supported() ? "true" : "false");
+	fprintf(file, "  \"programs\": %d,\n", BENCH_PROGRAM_COUNT);
+	fprintf(file, "  \"runs\": [\n");
+	for (int i = 0; i < runs; i++) {
+		const bench_result_t* r = &results[i];
+		fprintf(file, "    {\n");
+		fprintf(file, "      \"serial_seconds\": %.6f,\n", r->serial_seconds);
+		fprintf(file, "      \"batch_seconds\": %.6f,\n", r->batch_seconds);
+		fprintf(file, "      \"batch_issue_seconds\": %.6f,\n", r->batch_issue_seconds);
+		fprintf(file, "      \"speedup\": %.3f,\n", r->batch_seconds > 0.0 ? r->serial_seconds / r->batch_seconds : 0.0);
+		fprintf(file, "      \"failures\": %d\n", r->failures);
+		fprintf(file, "    }%s\n", i + 1 < runs ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+	fclose(file);
+}
+
+int main(int argc, char* argv[]) {
+	const char* out = BENCH_DEFAULT_OUT;
+	int runs = 3;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+			out = argv[++i];
+		}
+		else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+			runs = atoi(argv[++i]);
+			runs = runs < 1 ? 1 : runs;
+		}
+	}
+
+	// Same context the engine asks for, on a window that is never shown
+	SDL_SetMainReady();
+	if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+		fprintf(stderr, "failed to initialize SDL2: %s.\n", SDL_GetError());
+		return EXIT_FAILURE;
+	}
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	SDL_Window* window = SDL_CreateWindow("de_bench_shader", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	SDL_GLContext context = window != NULL ? SDL_GL_CreateContext(window) : NULL;
+	if (context == NULL || !gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress)) {
+		fprintf(stderr, "failed to create open_gl context: %s.\n", SDL_GetError());
+		SDL_Quit();
+		return EXIT_FAILURE;
+	}
+	program_set_max_compiler_threads(0xFFFFFFFF);
+
+	bench_result_t* results = (bench_result_t*)calloc((size_t)runs, sizeof(bench_result_t));
+	if (results == NULL) {
+		fprintf(stderr, "failed to allocate memory for results.\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("%s, parallel compile %s\n", (const char*)glGetString(GL_RENDERER), program_parallel_compile_supported() ? "on" : "off");
+	for (int i = 0; i < runs; i++) {
+		bench_result_t* result = &results[i];
+		result->serial_seconds = bench_serial(i, &result->failures);
+		result->batch_seconds = bench_batch(i, &result->failures, &result->batch_issue_seconds);
+		printf("run %d: serial %.2f ms, batch %.2f ms (blocked %.2f ms), %d failures\n", i,
+			result->serial_seconds * 1000.0, result->batch_seconds * 1000.0, result->batch_issue_seconds * 1000.0, result->failures);
+	}
+	bench_write_json(out, results, runs);
+	free(results);
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,290 @@
+/**
+* @file de_check_gl_state.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../include/pch.h"
+#include "../include/de_gl_state.h"
+
+// Headless check of the GL state cache. The glad function pointers are pointed at a recorder
+// instead of a driver, so no context or window is needed: each step drives the cache and
+// compares what reached the recorder with what should have.
+//
+// usage: de_check_gl_state
+// Prints one line per step and exits with a failure status if any step does not match.
+
+#define CHECK_MAX_CALLS 8
+
+typedef struct {
+	const char* name;
+	GLuint args[3];
+} check_call_t;
+
+static check_call_t calls[CHECK_MAX_CALLS];
+static int call_count = 0;
+static int failures = 0;
+
+static void check_record(const char* name, GLuint a, GLuint b, GLuint c) {
+	if (call_count < CHECK_MAX_CALLS) {
+		calls[call_count] = (check_call_t){ name, { a, b, c } };
+	}
+	call_count++;
+}
+
+static void APIENTRY check_use_program(GLuint program) {
+	check_record("glUseProgram", program, 0, 0);
+}
+
+static void APIENTRY check_bind_vertex_array(GLuint vertex_array) {
+	check_record("glBindVertexArray", vertex_array, 0, 0);
+}
+
+static void APIENTRY check_bind_buffer(GLenum target, GLuint buffer) {
+	check_record("glBindBuffer", target, buffer, 0);
+}
+
+static void APIENTRY check_bind_buffer_base(GLenum target, GLuint index, GLuint buffer) {
+	check_record("glBindBufferBase", target, index, buffer);
+}
+
+static void APIENTRY check_bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+	(void)offset;
+	(void)size;
+	check_record("glBindBufferRange", target, index, buffer);
+}
+
+static void APIENTRY check_active_texture(GLenum unit) {
+	check_record("glActiveTexture", unit, 0, 0);
+}
+
+static void APIENTRY check_bind_texture(GLenum target, GLuint texture) {
+	check_record("glBindTexture", target, texture, 0);
+}
+
+static void APIENTRY check_bind_sampler(GLuint unit, GLuint sampler) {
+	check_record("glBindSampler", unit, sampler, 0);
+}
+
+static void APIENTRY check_enable(GLenum capability) {
+	check_record("glEnable", capability, 0, 0);
+}
+
+static void APIENTRY check_disable(GLenum capability) {
+	check_record("glDisable", capability, 0, 0);
+}
+
+static void APIENTRY check_blend_func(GLenum source, GLenum destination) {
+	check_record("glBlendFunc", source, destination, 0);
+}
+
+static void APIENTRY check_depth_func(GLenum func) {
+	check_record("glDepthFunc", func, 0, 0);
+}
+
+static void APIENTRY check_depth_mask(GLboolean mask) {
+	check_record("glDepthMask", mask, 0, 0);
+}
+
+static void check_install(void) {
+	glad_glUseProgram = check_use_program;
+	glad_glBindVertexArray = check_bind_vertex_array;
+	glad_glBindBuffer = check_bind_buffer;
+	glad_glBindBufferBase = check_bind_buffer_base;
+	glad_glBindBufferRange = check_bind_buffer_range;
+	glad_glActiveTexture = check_active_texture;
+	glad_glBindTexture = check_bind_texture;
+	glad_glBindSampler = check_bind_sampler;
+	glad_glEnable = check_enable;
+	glad_glDisable = check_disable;
+	glad_glBlendFunc = check_blend_func;
+	glad_glDepthFunc = check_depth_func;
+	glad_glDepthMask = check_depth_mask;
+}
+
+static void check_begin(void) {
+	call_count = 0;
+	gl_state_reset_stats();
+}
+
+// Compares the calls recorded since check_begin with the expected ones. An expected call
+// of NULL means the step must not have reached the driver at all.
+static void check_expect(const char* step, const char* name, GLuint a, GLuint b, GLuint c) {
+	int expected = name != NULL ? 1 : 0;
+	bool passed = call_count == expected;
+	if (passed && expected == 1) {
+		check_call_t* call = &calls[0];
+		passed = strcmp(call->name, name) == 0 && call->args[0] == a && call->args[1] == b && call->args[2] == c;
+	}
+	gl_state_stats_t stats = gl_state_stats();
+	if (passed && expected == 0) {
+		passed = stats.issued == 0 && stats.skipped > 0;
+	}
+	printf("%s %s (%d calls, %d issued, %d skipped)\n", passed ? "pass" : "FAIL", step, call_count, stats.issued, stats.skipped);
+	if (!passed) {
+		failures++;
+	}
+}
+
+static void check_redundant(void) {
+	gl_state_reset();
+
+	gl_state_use_program(3);
+	check_begin();
+	gl_state_use_program(3);
+	check_expect("same program is skipped", NULL, 0, 0, 0);
+
+	gl_state_bind_vertex_array(2);
+	check_begin();
+	gl_state_bind_vertex_array(2);
+	check_expect("same vertex array is skipped", NULL, 0, 0, 0);
+
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, 5);
+	check_begin();
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, 5);
+	check_expect("same array buffer is skipped", NULL, 0, 0, 0);
+
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+	check_begin();
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+	check_expect("same element buffer is skipped", NULL, 0, 0, 0);
+
+	gl_state_bind_buffer_base(GL_UNIFORM_BUFFER, 1, 8);
+	check_begin();
+	gl_state_bind_buffer_base(GL_UNIFORM_BUFFER, 1, 8);
+	check_expect("same uniform binding is skipped", NULL, 0, 0, 0);
+	check_begin();
+	gl_state_bind_buffer(GL_UNIFORM_BUFFER, 8);
+	check_expect("bind_base also binds the generic target", NULL, 0, 0, 0);
+
+	gl_state_active_texture(2);
+	check_begin();
+	gl_state_active_texture(2);
+	check_expect("same active unit is skipped", NULL, 0, 0, 0);
+
+	gl_state_bind_texture(GL_TEXTURE_2D, 11);
+	check_begin();
+	gl_state_bind_texture(GL_TEXTURE_2D, 11);
+	check_expect("same texture on the unit is skipped", NULL, 0, 0, 0);
+	gl_state_active_texture(3);
+	check_begin();
+	gl_state_bind_texture(GL_TEXTURE_2D, 11);
+	check_expect("same texture on another unit is issued", "glBindTexture", GL_TEXTURE_2D, 11, 0);
+
+	gl_state_bind_sampler(3, 4);
+	check_begin();
+	gl_state_bind_sampler(3, 4);
+	check_expect("same sampler is skipped", NULL, 0, 0, 0);
+
+	gl_state_set_capability(GL_DEPTH_TEST, true);
+	check_begin();
+	gl_state_set_capability(GL_DEPTH_TEST, true);
+	check_expect("same capability is skipped", NULL, 0, 0, 0);
+	check_begin();
+	gl_state_set_capability(GL_DEPTH_TEST, false);
+	check_expect("changed capability is issued", "glDisable", GL_DEPTH_TEST, 0, 0);
+
+	gl_state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	check_begin();
+	gl_state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	check_expect("same blend func is skipped", NULL, 0, 0, 0);
+
+	gl_state_depth_func(GL_LEQUAL);
+	check_begin();
+	gl_state_depth_func(GL_LEQUAL);
+	check_expect("same depth func is skipped", NULL, 0, 0, 0);
+
+	gl_state_depth_mask(GL_FALSE);
+	check_begin();
+	gl_state_depth_mask(GL_FALSE);
+	check_expect("same depth mask is skipped", NULL, 0, 0, 0);
+}
+
+static void check_invalidation(void) {
+	gl_state_reset();
+
+	gl_state_bind_vertex_array(2);
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+	gl_state_bind_vertex_array(4);
+	check_begin();
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+	check_expect("element buffer is rebound after a vertex array change", "glBindBuffer", GL_ELEMENT_ARRAY_BUFFER, 6, 0);
+
+	gl_state_bind_buffer_range(GL_UNIFORM_BUFFER, 0, 9, 0, 256);
+	check_begin();
+	gl_state_bind_buffer_base(GL_UNIFORM_BUFFER, 0, 9);
+	check_expect("bind_base after a range is issued", "glBindBufferBase", GL_UNIFORM_BUFFER, 0, 9);
+	check_begin();
+	gl_state_bind_buffer_range(GL_UNIFORM_BUFFER, 0, 9, 256, 256);
+	check_expect("ranges are always issued", "glBindBufferRange", GL_UNIFORM_BUFFER, 0, 9);
+}
+
+static void check_forget(void) {
+	gl_state_reset();
+
+	gl_state_use_program(3);
+	gl_state_forget_program(3);
+	check_begin();
+	gl_state_use_program(3);
+	check_expect("forgotten program is rebound", "glUseProgram", 3, 0, 0);
+	gl_state_forget_program(7);
+	check_begin();
+	gl_state_use_program(3);
+	check_expect("forgetting another program keeps the binding", NULL, 0, 0, 0);
+
+	gl_state_bind_vertex_array(2);
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+	gl_state_forget_vertex_array(2);
+	check_begin();
+	gl_state_bind_vertex_array(0);
+	check_expect("forgotten vertex array leaves 0 bound", NULL, 0, 0, 0);
+	check_begin();
+	gl_state_bind_vertex_array(2);
+	check_expect("forgotten vertex array name is rebound", "glBindVertexArray", 2, 0, 0);
+	check_begin();
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+	check_expect("element buffer of a forgotten vertex array is rebound", "glBindBuffer", GL_ELEMENT_ARRAY_BUFFER, 6, 0);
+
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, 5);
+	gl_state_bind_buffer_base(GL_UNIFORM_BUFFER, 2, 5);
+	gl_state_forget_buffer(5);
+	check_begin();
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, 0);
+	check_expect("forgotten buffer leaves 0 bound", NULL, 0, 0, 0);
+	check_begin();
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, 5);
+	check_expect("forgotten buffer name is rebound", "glBindBuffer", GL_ARRAY_BUFFER, 5, 0);
+	check_begin();
+	gl_state_bind_buffer_base(GL_UNIFORM_BUFFER, 2, 5);
+	check_expect("forgotten uniform binding is rebound", "glBindBufferBase", GL_UNIFORM_BUFFER, 2, 5);
+
+	gl_state_active_texture(0);
+	gl_state_bind_texture(GL_TEXTURE_2D, 11);
+	gl_state_active_texture(1);
+	gl_state_bind_texture(GL_TEXTURE_2D, 11);
+	gl_state_forget_texture(11);
+	check_begin();
+	gl_state_bind_texture(GL_TEXTURE_2D, 0);
+	check_expect("forgotten texture leaves 0 bound", NULL, 0, 0, 0);
+	gl_state_active_texture(0);
+	check_begin();
+	gl_state_bind_texture(GL_TEXTURE_2D, 11);
+	check_expect("forgotten texture is rebound on every unit", "glBindTexture", GL_TEXTURE_2D, 11, 0);
+}
+
+int main(int argc, char* argv[]) {
+	(void)argc;
+	(void)argv;
+	check_install();
+	check_redundant();
+	check_invalidation();
+	check_forget();
+	if (failures > 0) {
+		printf("%d checks failed\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("all checks passed\n");
+	return EXIT_SUCCESS;
+}
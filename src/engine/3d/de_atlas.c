@@ -0,0 +1,383 @@
+/**
+* @file de_atlas.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_util.h"
+#include "../../include/de_dtex.h"
+#include "../../include/de_atlas.h"
+
+#define ATLAS_CHANNELS 4
+#define ATLAS_GROW_STEP 256 // GL 4 takes any size, no need to double
+
+typedef struct {
+	const char* name;
+	unsigned char* pixels; // as decoded: tightly packed, bottom row first
+	int width;
+	int height;
+	int channels;
+	int x; // bottom-left corner of the padded rect once packed
+	int y;
+} atlas_image_t;
+
+// Skyline bottom-left packing: the top edge of everything placed so far is kept as a
+// list of horizontal segments, each rect goes where its top ends up lowest.
+typedef struct {
+	int x;
+	int y;
+	int width;
+} skyline_node_t;
+
+typedef struct {
+	skyline_node_t* nodes;
+	int count;
+	int width;
+	int height;
+} skyline_t;
+
+static bool skyline_fit(const skyline_t* skyline, int index, int width, int height, int* y) {
+	int x = skyline->nodes[index].x;
+	if (x + width > skyline->width) {
+		return false;
+	}
+
+	int top = 0;
+	int remaining = width;
+	for (int i = index; remaining > 0; i++) {
+		top = skyline->nodes[i].y > top ? skyline->nodes[i].y : top;
+		if (top + height > skyline->height) {
+			return false;
+		}
+		remaining -= skyline->nodes[i].width;
+	}
+	*y = top;
+	return true;
+}
+
+static void skyline_remove(skyline_t* skyline, int index) {
+	memmove(&skyline->nodes[index], &skyline->nodes[index + 1], sizeof(skyline_node_t) * (skyline->count - index - 1));
+	skyline->count--;
+}
+
+static void skyline_insert(skyline_t* skyline, int index, int x, int y, int width, int height) {
+	memmove(&skyline->nodes[index + 1], &skyline->nodes[index], sizeof(skyline_node_t) * (skyline->count - index));
+	skyline->nodes[index] = (skyline_node_t){ x, y + height, width };
+	skyline->count++;
+
+	// Trim the segments now hidden under the new one
+	for (int i = index + 1; i < skyline->count; ) {
+		const skyline_node_t* previous = &skyline->nodes[i - 1];
+		int overlap = previous->x + previous->width - skyline->nodes[i].x;
+		if (overlap <= 0) {
+			break;
+		}
+		skyline->nodes[i].x += overlap;
+		skyline->nodes[i].width -= overlap;
+		if (skyline->nodes[i].width > 0) {
+			break;
+		}
+		skyline_remove(skyline, i);
+	}
+
+	for (int i = 0; i < skyline->count - 1; ) {
+		if (skyline->nodes[i].y == skyline->nodes[i + 1].y) {
+			skyline->nodes[i].width += skyline->nodes[i + 1].width;
+			skyline_remove(skyline, i + 1);
+		}
+		else {
+			i++;
+		}
+	}
+}
+
+static bool atlas_pack(atlas_image_t* images, int count, int width, int height) {
+	skyline_node_t* nodes = (skyline_node_t*)malloc(sizeof(skyline_node_t) * (count + 1));
+	if (nodes == NULL) {
+		fprintf(stderr, "failed to allocate memory for atlas packing.\n");
+		exit(EXIT_FAILURE);
+	}
+	skyline_t skyline = { nodes, 1, width, height };
+	nodes[0] = (skyline_node_t){ 0, 0, width };
+
+	bool packed = true;
+	for (int i = 0; i < count && packed; i++) {
+		int rect_width = images[i].width + 2 * ATLAS_PADDING;
+		int rect_height = images[i].height + 2 * ATLAS_PADDING;
+
+		int best_index = -1;
+		int best_top = height + 1;
+		int best_y = 0;
+		for (int n = 0; n < skyline.count; n++) {
+			int y;
+			if (skyline_fit(&skyline, n, rect_width, rect_height, &y) && y + rect_height < best_top) {
+				best_index = n;
+				best_top = y + rect_height;
+				best_y = y;
+			}
+		}
+
+		if (best_index < 0) {
+			packed = false;
+			break;
+		}
+		images[i].x = nodes[best_index].x;
+		images[i].y = best_y;
+		skyline_insert(&skyline, best_index, images[i].x, best_y, rect_width, rect_height);
+	}
+
+	free(nodes);
+	return packed;
+}
+
+static int atlas_compare_height(const void* a, const void* b) {
+	const atlas_image_t* first = (const atlas_image_t*)a;
+	const atlas_image_t* second = (const atlas_image_t*)b;
+	if (first->height != second->height) {
+		return second->height - first->height;
+	}
+	return second->width - first->width;
+}
+
+static void atlas_grow(int* width, int* height) {
+	if (*width <= *height) {
+		*width += ATLAS_GROW_STEP;
+	}
+	else {
+		*height += ATLAS_GROW_STEP;
+	}
+}
+
+static void atlas_blit(unsigned char* atlas, int atlas_width, const atlas_image_t* image) {
+	int rect_width = image->width + 2 * ATLAS_PADDING;
+	int rect_height = image->height + 2 * ATLAS_PADDING;
+
+	// The padding repeats the sprite's edge texels so filtering never reaches a neighbour
+	for (int y = 0; y < rect_height; y++) {
+		int source_y = y - ATLAS_PADDING;
+		source_y = source_y < 0 ? 0 : source_y >= image->height ? image->height - 1 : source_y;
+
+		for (int x = 0; x < rect_width; x++) {
+			int source_x = x - ATLAS_PADDING;
+			source_x = source_x < 0 ? 0 : source_x >= image->width ? image->width - 1 : source_x;
+
+			const unsigned char* texel = image->pixels + ((size_t)source_y * image->width + source_x) * image->channels;
+			unsigned char* out = atlas + ((size_t)(image->y + y) * atlas_width + image->x + x) * ATLAS_CHANNELS;
+			out[0] = texel[0];
+			out[1] = texel[1];
+			out[2] = texel[2];
+			out[3] = image->channels == 4 ? texel[3] : 255;
+		}
+	}
+}
+
+// Every name in list order and the stamp of its image: adding, removing or editing
+// a sprite changes it
+static uint64_t atlas_source_hash(list_t* images) {
+	uint64_t hash = HASH_SEED;
+	for (size_t i = 0; i < list_size(images); i++) {
+		const char* name = *(const char**)list_get(images, i);
+		char* path = create_texture_path(name);
+		uint64_t stamp = file_stamp(path);
+		free(path);
+
+		hash = hash_bytes(name, strlen(name) + 1, hash);
+		hash = hash_bytes(&stamp, sizeof(stamp), hash);
+	}
+	return hash;
+}
+
+static bool atlas_write_sprites(const char* path, const atlas_image_t* images, int count, int width, int height, uint64_t source_hash) {
+	FILE* file = fopen(path, "w");
+	if (file == NULL) {
+		fprintf(stderr, "failed to write atlas: %s.\n", path);
+		return false;
+	}
+
+	fprintf(file, "atlas %d %d %d %016llx\n", width, height, count, (unsigned long long)source_hash);
+	for (int i = 0; i < count; i++) {
+		fprintf(file, "%s %d %d %d %d\n", images[i].name,
+			images[i].x + ATLAS_PADDING, images[i].y + ATLAS_PADDING, images[i].width, images[i].height);
+	}
+	fclose(file);
+	return true;
+}
+
+static char* atlas_binary_path(const char* atlas_name, const char* extension) {
+	char* name = concat(atlas_name, extension);
+	char* path = create_binary_path(name);
+	free(name);
+	return path;
+}
+
+bool atlas_cook(list_t* images, const char* atlas_name) {
+	int count = (int)list_size(images);
+	atlas_image_t* entries = (atlas_image_t*)calloc(count, sizeof(atlas_image_t));
+	if (entries == NULL) {
+		fprintf(stderr, "failed to allocate memory for atlas images.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	bool cooked = true;
+	long long area = 0;
+	for (int i = 0; i < count && cooked; i++) {
+		entries[i].name = *(const char**)list_get(images, i);
+		if (strlen(entries[i].name) >= ATLAS_NAME_LENGTH || strchr(entries[i].name, ' ') != NULL) {
+			fprintf(stderr, "invalid atlas sprite name: %s.\n", entries[i].name);
+			cooked = false;
+			break;
+		}
+
+		char* path = create_texture_path(entries[i].name);
+		entries[i].pixels = tbo_decode(path, &entries[i].width, &entries[i].height, &entries[i].channels);
+		free(path);
+
+		cooked = entries[i].pixels != NULL;
+		if (cooked) {
+			area += (long long)(entries[i].width + 2 * ATLAS_PADDING) * (entries[i].height + 2 * ATLAS_PADDING);
+		}
+	}
+
+	// Tallest first packs tightest on a skyline, grow the smaller side until everything fits
+	int width = ATLAS_GROW_STEP;
+	int height = ATLAS_GROW_STEP;
+	if (cooked) {
+		qsort(entries, count, sizeof(atlas_image_t), atlas_compare_height);
+		while ((long long)width * height < area) {
+			atlas_grow(&width, &height);
+		}
+		while (!atlas_pack(entries, count, width, height)) {
+			atlas_grow(&width, &height);
+			if (width > ATLAS_MAX_SIZE || height > ATLAS_MAX_SIZE) {
+				fprintf(stderr, "atlas %s does not fit in %dx%d.\n", atlas_name, ATLAS_MAX_SIZE, ATLAS_MAX_SIZE);
+				cooked = false;
+				break;
+			}
+		}
+	}
+
+	if (cooked) {
+		unsigned char* pixels = (unsigned char*)calloc((size_t)width * height, ATLAS_CHANNELS);
+		if (pixels == NULL) {
+			fprintf(stderr, "failed to allocate memory for atlas pixels.\n");
+			exit(EXIT_FAILURE);
+		}
+		for (int i = 0; i < count; i++) {
+			atlas_blit(pixels, width, &entries[i]);
+		}
+
+		char* texture_path = atlas_binary_path(atlas_name, ATLAS_EXTENSION DTEX_EXTENSION);
+		char* sprites_path = atlas_binary_path(atlas_name, ATLAS_EXTENSION);
+		cooked = dtex_write(texture_path, pixels, width, height, ATLAS_CHANNELS, DTEX_FLAG_SRGB, ATLAS_COMPRESSION, ATLAS_MIP_LEVELS, 0)
+			&& atlas_write_sprites(sprites_path, entries, count, width, height, atlas_source_hash(images));
+		printf("Atlas %s: %d sprites in %dx%d\n", atlas_name, count, width, height);
+
+		free(texture_path);
+		free(sprites_path);
+		free(pixels);
+	}
+
+	for (int i = 0; i < count; i++) {
+		free(entries[i].pixels);
+	}
+	free(entries);
+	return cooked;
+}
+
+bool atlas_is_cooked(list_t* images, const char* atlas_name) {
+	char* sprites_path = atlas_binary_path(atlas_name, ATLAS_EXTENSION);
+	char* texture_path = atlas_binary_path(atlas_name, ATLAS_EXTENSION DTEX_EXTENSION);
+
+	// The sprite table header carries the hash of what it was cooked from
+	bool cooked = false;
+	FILE* file = fopen(sprites_path, "r");
+	if (file != NULL) {
+		char line[256];
+		int width, height, count;
+		unsigned long long source_hash;
+		cooked = fgets(line, sizeof(line), file) != NULL
+			&& sscanf_s(line, "atlas %d %d %d %llx", &width, &height, &count, &source_hash) == 4
+			&& source_hash == atlas_source_hash(images)
+			&& dtex_is_valid(texture_path);
+		fclose(file);
+	}
+
+	free(sprites_path);
+	free(texture_path);
+	return cooked;
+}
+
+bool atlas_load(atlas_t* atlas, const char* atlas_name) {
+	snprintf(atlas->name, sizeof(atlas->name), "%s%s", atlas_name, ATLAS_EXTENSION);
+	atlas->texture = TEXTURE_HANDLE_INVALID;
+	atlas->width = 0;
+	atlas->height = 0;
+	list_init(&atlas->sprites, sizeof(atlas_sprite_t));
+
+	char* sprites_path = atlas_binary_path(atlas_name, ATLAS_EXTENSION);
+	FILE* file = fopen(sprites_path, "r");
+	free(sprites_path);
+	if (file == NULL) {
+		fprintf(stderr, "failed to open atlas: %s.\n", atlas_name);
+		return false;
+	}
+
+	char line[256];
+	int count = 0;
+	if (fgets(line, sizeof(line), file) == NULL || sscanf_s(line, "atlas %d %d %d", &atlas->width, &atlas->height, &count) != 3) {
+		fprintf(stderr, "invalid atlas: %s.\n", atlas_name);
+		fclose(file);
+		return false;
+	}
+
+	while (fgets(line, sizeof(line), file)) {
+		char* separator = strchr(line, ' ');
+		if (separator == NULL || separator - line >= ATLAS_NAME_LENGTH) {
+			continue;
+		}
+
+		atlas_sprite_t sprite;
+		memcpy(sprite.name, line, separator - line);
+		sprite.name[separator - line] = '\0';
+		if (sscanf_s(separator, "%d %d %d %d", &sprite.x, &sprite.y, &sprite.width, &sprite.height) != 4) {
+			continue;
+		}
+
+		sprite.uv.u0 = (float)sprite.x / atlas->width;
+		sprite.uv.v0 = (float)sprite.y / atlas->height;
+		sprite.uv.u1 = (float)(sprite.x + sprite.width) / atlas->width;
+		sprite.uv.v1 = (float)(sprite.y + sprite.height) / atlas->height;
+		list_add(&atlas->sprites, &sprite);
+	}
+	fclose(file);
+
+	// Keyed like any other texture, so every sprite user ends up on this one handle.
+	// Trilinear to use the cooked mips, clamped so the border sprites never wrap around.
+	char* texture_path = create_texture_path(atlas->name);
+	sampler_t sampler = { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR };
+	atlas->texture = texture_mgr_acquire_async(texture_path, &sampler);
+	free(texture_path);
+
+	return (int)list_size(&atlas->sprites) == count;
+}
+
+const atlas_sprite_t* atlas_find(const atlas_t* atlas, const char* sprite_name) {
+	list_t* sprites = (list_t*)&atlas->sprites;
+	for (size_t i = 0; i < list_size(sprites); i++) {
+		const atlas_sprite_t* sprite = (const atlas_sprite_t*)list_get(sprites, i);
+		if (strcmp(sprite->name, sprite_name) == 0) {
+			return sprite;
+		}
+	}
+	return NULL;
+}
+
+void atlas_delete(atlas_t* atlas) {
+	if (atlas->texture != TEXTURE_HANDLE_INVALID) {
+		texture_mgr_release(atlas->texture);
+		atlas->texture = TEXTURE_HANDLE_INVALID;
+	}
+	list_free(&atlas->sprites);
+}
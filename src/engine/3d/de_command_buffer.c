@@ -0,0 +1,178 @@
+/**
+* @file de_command_buffer.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_material.h"
+#include "../../include/de_command_buffer.h"
+
+#define COMMAND_BUFFER_RESERVE 256
+#define COMMAND_PAYLOAD_RESERVE 4096
+#define COMMAND_PAYLOAD_ALIGNMENT 16
+
+void command_buffer_init(command_buffer_t* buffer) {
+	list_init_size(&buffer->commands, sizeof(command_t), COMMAND_BUFFER_RESERVE);
+	buffer->payload = NULL;
+	buffer->payload_size = 0;
+	buffer->payload_capacity = 0;
+}
+
+// Keeps the memory, a buffer recorded every frame settles at the size of the frame
+void command_buffer_reset(command_buffer_t* buffer) {
+	list_clear(&buffer->commands);
+	buffer->payload_size = 0;
+}
+
+void command_buffer_free(command_buffer_t* buffer) {
+	list_free(&buffer->commands);
+	free(buffer->payload);
+	buffer->payload = NULL;
+	buffer->payload_size = 0;
+	buffer->payload_capacity = 0;
+}
+
+// Offset of size bytes of payload. The memory may move on the next reservation,
+// only offsets are kept in commands.
+static size_t command_buffer_reserve(command_buffer_t* buffer, size_t size) {
+	size_t offset = (buffer->payload_size + COMMAND_PAYLOAD_ALIGNMENT - 1) & ~(size_t)(COMMAND_PAYLOAD_ALIGNMENT - 1);
+	if (offset + size > buffer->payload_capacity) {
+		size_t capacity = buffer->payload_capacity > 0 ? buffer->payload_capacity : COMMAND_PAYLOAD_RESERVE;
+		while (capacity < offset + size) {
+			capacity *= 2;
+		}
+		unsigned char* payload = (unsigned char*)realloc(buffer->payload, capacity);
+		if (payload == NULL) {
+			fprintf(stderr, "failed to allocate memory for command buffer.\n");
+			exit(EXIT_FAILURE);
+		}
+		buffer->payload = payload;
+		buffer->payload_capacity = capacity;
+	}
+	buffer->payload_size = offset + size;
+	return offset;
+}
+
+static void command_buffer_push(command_buffer_t* buffer, const command_t* command) {
+	list_add(&buffer->commands, (void*)command);
+}
+
+void command_buffer_bind_program(command_buffer_t* buffer, program_handle_t program, GLint uniform_texture) {
+	command_t command = { .type = COMMAND_BIND_PROGRAM, .program = { program, uniform_texture } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_bind_material(command_buffer_t* buffer, int material) {
+	command_t command = { .type = COMMAND_BIND_MATERIAL, .material = { material } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_bind_texture(command_buffer_t* buffer, texture_handle_t texture, GLuint unit) {
+	command_t command = { .type = COMMAND_BIND_TEXTURE, .texture = { texture, unit } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_bind_mesh(command_buffer_t* buffer, mesh_handle_t mesh) {
+	command_t command = { .type = COMMAND_BIND_MESH, .mesh = mesh };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_bind_instances(command_buffer_t* buffer, mesh_handle_t mesh, stream_buffer_t* stream, GLintptr offset) {
+	command_t command = { .type = COMMAND_BIND_INSTANCES, .instances = { mesh, stream, offset } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_uniform_vec3(command_buffer_t* buffer, GLint location, vec3_t value) {
+	command_t command = { .type = COMMAND_UNIFORM_VEC3, .vec3 = { location, value } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_uniform_mat4(command_buffer_t* buffer, GLint location, const mat4_t* matrix) {
+	size_t payload = command_buffer_reserve(buffer, sizeof(mat4_t));
+	memcpy(buffer->payload + payload, matrix, sizeof(mat4_t));
+	command_t command = { .type = COMMAND_UNIFORM_MAT4, .mat4 = { location, payload } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_draw(command_buffer_t* buffer, mesh_handle_t mesh, int lod) {
+	command_t command = { .type = COMMAND_DRAW, .draw = { mesh, lod, 1 } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_draw_instanced(command_buffer_t* buffer, mesh_handle_t mesh, int lod, int instance_count) {
+	command_t command = { .type = COMMAND_DRAW_INSTANCED, .draw = { mesh, lod, instance_count } };
+	command_buffer_push(buffer, &command);
+}
+
+void command_buffer_draw_meshlets(command_buffer_t* buffer, mesh_handle_t mesh, const mat4_t* model, const mat4_t* view_projection, const vec3_t* eye) {
+	const mesh_t* source = mesh_mgr_get(mesh)->mesh;
+	size_t capacity = (size_t)source->meshlet_count;
+
+	// Room for every meshlet in its own range, most merge and the rest goes unused
+	size_t payload = command_buffer_reserve(buffer, capacity * (sizeof(GLvoid*) + sizeof(GLsizei)));
+	meshlet_draw_list_t draws = {
+		.counts = (GLsizei*)(buffer->payload + payload + capacity * sizeof(GLvoid*)),
+		.offsets = (const GLvoid**)(buffer->payload + payload)
+	};
+	mesh_cull_meshlets_into(source, model, view_projection, eye, &draws);
+	if (draws.range_count == 0) {
+		buffer->payload_size = payload; // nothing to draw, the room goes back
+		return;
+	}
+
+	command_t command = { .type = COMMAND_DRAW_MESHLETS, .meshlets = { mesh, draws.range_count, payload } };
+	command_buffer_push(buffer, &command);
+}
+
+static void command_buffer_draw_payload_meshlets(const command_buffer_t* buffer, const command_t* command) {
+	const mesh_t* mesh = mesh_mgr_get(command->meshlets.mesh)->mesh;
+	size_t capacity = (size_t)mesh->meshlet_count;
+	meshlet_draw_list_t draws = {
+		.counts = (GLsizei*)(buffer->payload + command->meshlets.payload + capacity * sizeof(GLvoid*)),
+		.offsets = (const GLvoid**)(buffer->payload + command->meshlets.payload),
+		.range_count = command->meshlets.range_count
+	};
+	mesh_draw_meshlet_list(mesh, &draws);
+}
+
+void command_buffer_execute(const command_buffer_t* buffer) {
+	const command_t* commands = (const command_t*)buffer->commands.array;
+	for (size_t i = 0; i < buffer->commands.size; i++) {
+		const command_t* command = &commands[i];
+		switch (command->type) {
+		case COMMAND_BIND_PROGRAM:
+			program_set(shader_mgr_program(command->program.program));
+			program_set_uniform1i(command->program.uniform_texture, 0);
+			break;
+		case COMMAND_BIND_MATERIAL:
+			material_bind_buffer(command->material.index);
+			break;
+		case COMMAND_BIND_TEXTURE:
+			texture_mgr_bind(command->texture.texture, command->texture.unit);
+			break;
+		case COMMAND_BIND_MESH:
+			mesh_mgr_bind(command->mesh);
+			break;
+		case COMMAND_BIND_INSTANCES:
+			mesh_mgr_bind_instances(command->instances.mesh, command->instances.stream, command->instances.offset);
+			break;
+		case COMMAND_UNIFORM_VEC3:
+			program_set_uniform_vec3f(command->vec3.location, command->vec3.value);
+			break;
+		case COMMAND_UNIFORM_MAT4:
+			program_set_uniform_mat4f(command->mat4.location, (const mat4_t*)(buffer->payload + command->mat4.payload));
+			break;
+		case COMMAND_DRAW:
+			mesh_draw_lod(mesh_mgr_get(command->draw.mesh)->mesh, command->draw.lod);
+			break;
+		case COMMAND_DRAW_INSTANCED:
+			mesh_draw_lod_instanced(mesh_mgr_get(command->draw.mesh)->mesh, command->draw.lod, command->draw.instance_count);
+			break;
+		case COMMAND_DRAW_MESHLETS:
+			command_buffer_draw_payload_meshlets(buffer, command);
+			break;
+		}
+	}
+}
@@ -6,64 +6,94 @@
 * Dodoi-Engine is a game engine developed by Dodoi-Lab.
 * @copyright Copyright (c) 2024, Dodoi-Lab
 */
+#include "../../include/de_util.h"
 #include "../../include/de_cube.h"
 
 void cube_load_uniform_locations(cube_t* cube) {
-	// Materials
-	cube->uniform_material_ambient = program_get_uniform_location(&cube->go.program, MATERIAL_AMBIENT);
-	cube->uniform_material_specular = program_get_uniform_location(&cube->go.program, MATERIAL_SPECULAR);
-	cube->uniform_material_shininess = program_get_uniform_location(&cube->go.program, MATERIAL_SHININESS);
-	cube->uniform_material_diffuse_map = program_get_uniform_location(&cube->go.program, MATERIAL_DIFFUSE_MAP);
-
-	// Lights
-	cube->uniform_light_ambient = program_get_uniform_location(&cube->go.program, LIGHT_AMBIENT);
-	cube->uniform_light_diffuse = program_get_uniform_location(&cube->go.program, LIGHT_DIFFUSE);
-	cube->uniform_light_specular = program_get_uniform_location(&cube->go.program, LIGHT_SPECULAR);
-	cube->uniform_light_direction = program_get_uniform_location(&cube->go.program, LIGHT_DIRECTION);
+	program_t* program = shader_mgr_program(cube->go.program);
+
+	// Packed vertex formats
+	cube->uniform_dequant_scale = program_find_uniform(program, NAME_HASH(DEQUANT_SCALE));
+	cube->uniform_dequant_offset = program_find_uniform(program, NAME_HASH(DEQUANT_OFFSET));
 }
 
 void cube_init(cube_t* cube, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model) {
-	game_object_3d_init(&cube->go, vertex_shader, fragment_shader, texture, model);
+	cube_init_with_format(cube, vertex_shader, fragment_shader, texture, model, VERTEX_FORMAT_FLOAT);
+}
 
-    vao_bind(&cube->go.vao);
-	vbo_set_data(&cube->go.vbo, mesh_vertex_to_gl_buffer(&cube->go.mesh), cube->go.mesh.vertex_count * 8 * sizeof(float));
-	ebo_set_data(&cube->go.ebo, mesh_index_to_gl_buffer(&cube->go.mesh), cube->go.mesh.face_count * 3 * sizeof(unsigned int));
-	
-    vao_link_vbo_3f3f2f();
-    buffer_unbind();
+static void cube_init_variant(cube_t* cube, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model, vertex_format_t format, shader_key_t features) {
+	game_object_3d_init(&cube->go, vertex_shader, fragment_shader, texture, model, format, features);
 
 	cube->material = material_brass();
-	cube->light = directional_light_init();
 
 	cube_load_uniform_locations(cube);
 }
 
+void cube_init_with_format(cube_t* cube, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model, vertex_format_t format) {
+	cube_init_variant(cube, vertex_shader, fragment_shader, texture, model, format, SHADER_KEY_NONE);
+}
+
+// Cubes sharing shaders, mesh, texture and material are drawn together by cube_submit,
+// the shaders need a DE_INSTANCED path. Such a cube cannot be drawn by cube_render.
+void cube_init_instanced(cube_t* cube, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model, vertex_format_t format) {
+	cube_init_variant(cube, vertex_shader, fragment_shader, texture, model, format, SHADER_INSTANCED);
+}
+
+static bool cube_cull_meshlets(cube_t* cube, mat4_t* view, mat4_t* projection) {
+	mat4_t view_projection = mat4_mul_mat4(projection, view);
+
+	// The eye is the translation of the inverse view matrix
+	mat4_t inverse_view;
+	if (!mat4_inverse(view, &inverse_view)) {
+		return false;
+	}
+	vec3_t eye = vec3_new(inverse_view.m[0][3], inverse_view.m[1][3], inverse_view.m[2][3]);
+	mesh_cull_meshlets(game_object_get_mesh(&cube->go), &cube->go.model, &view_projection, &eye);
+	return true;
+}
+
 void cube_render(cube_t* cube, mat4_t* view, mat4_t* projection) {
-	program_set(&cube->go.program);
-	buffer_bind(&cube->go.vao, &cube->go.vbo, &cube->go.ebo);
-	tbo_bind(&cube->go.tbo);
-
-	// Set material properties
-	program_set_uniform1f(cube->uniform_material_shininess, cube->material.shininess);
-	program_set_uniform_vec3f(cube->uniform_material_ambient, cube->material.ambient);
-	program_set_uniform_vec3f(cube->uniform_material_specular, cube->material.specular);
-
-	// Set light properties
-	program_set_uniform_vec3f(cube->uniform_light_ambient, cube->light.ambient);
-	program_set_uniform_vec3f(cube->uniform_light_diffuse, cube->light.diffuse);
-	program_set_uniform_vec3f(cube->uniform_light_specular, cube->light.specular);
-	program_set_uniform_vec3f(cube->uniform_light_direction, cube->light.direction);
-
-	// Set texture and MVP matrices
-	program_set_uniform1i(cube->go.uniform_texture, 0);
-	program_set_uniform_mat4f(cube->go.uniform_model, &cube->go.model); // model matrix
-	program_set_uniform_mat4f(cube->go.uniform_view, view);             // view matrix
-	program_set_uniform_mat4f(cube->go.uniform_projection, projection); // projection matrix
+	mesh_t* mesh = game_object_get_mesh(&cube->go);
+
+	program_set(shader_mgr_program(cube->go.program));
+	mesh_mgr_bind(cube->go.mesh);
+	texture_mgr_bind(cube->go.texture, 0);
+
+	// Camera and lights are already in the frame block, only the material buffer changes per object
+	material_bind(&cube->material);
 
-	glDrawArrays(GL_TRIANGLES, 0, cube->go.mesh.vertex_count);
+	// Dequantization for packed vertex formats
+	program_set_uniform_vec3f(cube->uniform_dequant_scale, mesh->dequant_scale);
+	program_set_uniform_vec3f(cube->uniform_dequant_offset, mesh->dequant_offset);
+
+	// Set texture and model matrix
+	program_set_uniform1i(cube->go.uniform_texture, 0);
+	program_set_uniform_mat4f(cube->go.uniform_model, &cube->go.model);
+
+	if (mesh->meshlet_count > 0 && cube->go.lod == 0 && cube_cull_meshlets(cube, view, projection)) {
+		mesh_draw_meshlets(mesh);
+	}
+	else {
+		mesh_draw_lod(mesh, cube->go.lod);
+	}
+}
 
-	buffer_unbind();
-	program_unset();
+// Same state as cube_render, applied by the queue only where it differs from the previous draw
+void cube_submit(cube_t* cube, render_queue_t* queue) {
+	render_item_t item = {
+		.program = cube->go.program,
+		.material = material_buffer(&cube->material),
+		.texture = cube->go.texture,
+		.mesh = cube->go.mesh,
+		.lod = cube->go.lod,
+		.model = &cube->go.model,
+		.instanced = cube->go.instanced,
+		.uniform_model = cube->go.uniform_model,
+		.uniform_texture = cube->go.uniform_texture,
+		.uniform_dequant_scale = cube->uniform_dequant_scale,
+		.uniform_dequant_offset = cube->uniform_dequant_offset
+	};
+	render_queue_submit(queue, RENDER_PASS_OPAQUE, &item, &cube->go.world_sphere.center);
 }
 
 void cube_update(cube_t* cube) {
@@ -71,19 +101,22 @@ void cube_update(cube_t* cube) {
 }
 
 void cube_delete(cube_t* cube) {
-	tbo_delete(&cube->go.tbo);
-	program_delete(&cube->go.program);
-	buffer_delete(&cube->go.vao, &cube->go.vbo, &cube->go.ebo);
+	texture_mgr_release(cube->go.texture);
+	shader_mgr_release(cube->go.program);
+	mesh_mgr_release(cube->go.mesh);
 }
 
 void cube_set_scale(cube_t* cube, const vec3_t* scale) {
     cube->go.scale = *scale;
+	cube->go.dirty = true;
 }
 
 void cube_set_rotation(cube_t* cube, const vec3_t* rotation) {
 	cube->go.rotation = *rotation;
+	cube->go.dirty = true;
 }
 
 void cube_set_position(cube_t* cube, const vec3_t* position) {
 	cube->go.position = *position;
+	cube->go.dirty = true;
 }
@@ -21,20 +21,21 @@ void ebo_init(ebo_t* ebo) {
 	glGenBuffers(1, &ebo->id);
 }
 
-void ebo_set_data(ebo_t* ebo, GLuint* indices, GLsizeiptr size) {
+void ebo_set_data(ebo_t* ebo, const GLvoid* indices, GLsizeiptr size) {
 	ebo_bind(ebo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
 }
 
 void ebo_bind(ebo_t* ebo) {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo->id);
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, ebo->id);
 }
 
 void ebo_unbind(void) {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	gl_state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void ebo_delete(ebo_t* ebo) {
+	gl_state_forget_buffer(ebo->id);
 	glDeleteBuffers(1, &ebo->id);
 }
 
@@ -0,0 +1,522 @@
+/**
+* @file de_font.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_util.h"
+#include "../../include/de_dtex.h"
+#include "../../include/de_font.h"
+
+#define FONT_COVERAGE_EDGE 128 // rasterized texels at least this covered are inside the outline
+#define FONT_EDT_FAR 1e20f     // squared distance of texels with no feature anywhere yet
+
+typedef struct {
+	unsigned char* field; // distance texels, top row first, NULL for empty glyphs
+	int width;
+	int height;
+	int x;                // top-left in its page once packed, top row first
+	int y;
+	font_glyph_t glyph;
+} font_bake_t;
+
+static void* font_alloc(size_t size) {
+	void* memory = malloc(size);
+	if (memory == NULL) {
+		fprintf(stderr, "failed to allocate memory for font.\n");
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+static char* font_binary_path(const char* font_name, const char* extension) {
+	char* name = concat(font_name, extension);
+	char* path = create_binary_path(name);
+	free(name);
+	return path;
+}
+
+// "consola" page 1 is the texture "consola.font1", cooked to data/binary/consola.font1.dtex
+static void font_page_name(char* name, size_t size, const char* font_name, int page) {
+	snprintf(name, size, "%s%s%d", font_name, FONT_EXTENSION, page);
+}
+
+// data/fonts first, then the fonts installed with Windows
+static char* font_source_path(const char* font_file) {
+	char* path = concat(FONT_FOLDER, font_file);
+	if (file_exists(path)) {
+		return path;
+	}
+	free(path);
+
+	char windows[MAX_PATH];
+	UINT length = GetWindowsDirectoryA(windows, MAX_PATH);
+	if (length == 0 || length >= MAX_PATH) {
+		return NULL;
+	}
+	char* folder = concat(windows, "\\Fonts\\");
+	path = concat(folder, font_file);
+	free(folder);
+	if (file_exists(path)) {
+		return path;
+	}
+	free(path);
+	return NULL;
+}
+
+// Squared distance to the closest feature along one row or column, where f holds zero at
+// the features and FONT_EDT_FAR elsewhere. Lower envelope of parabolas, linear in n.
+static void font_edt_line(const float* f, float* d, int n, int* v, float* z) {
+	int k = 0;
+	v[0] = 0;
+	z[0] = -FONT_EDT_FAR;
+	z[1] = FONT_EDT_FAR;
+	for (int q = 1; q < n; q++) {
+		float s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+		while (s <= z[k]) {
+			k--;
+			s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = FONT_EDT_FAR;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++) {
+		while (z[k + 1] < q) {
+			k++;
+		}
+		d[q] = (float)(q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+}
+
+// Columns then rows, the exact euclidean distance comes out of the two passes
+static void font_edt(float* grid, int width, int height) {
+	int n = width > height ? width : height;
+	float* f = (float*)font_alloc(sizeof(float) * n);
+	float* d = (float*)font_alloc(sizeof(float) * n);
+	int* v = (int*)font_alloc(sizeof(int) * n);
+	float* z = (float*)font_alloc(sizeof(float) * (n + 1));
+
+	for (int x = 0; x < width; x++) {
+		for (int y = 0; y < height; y++) {
+			f[y] = grid[(size_t)y * width + x];
+		}
+		font_edt_line(f, d, height, v, z);
+		for (int y = 0; y < height; y++) {
+			grid[(size_t)y * width + x] = d[y];
+		}
+	}
+	for (int y = 0; y < height; y++) {
+		memcpy(f, &grid[(size_t)y * width], sizeof(float) * width);
+		font_edt_line(f, &grid[(size_t)y * width], width, v, z);
+	}
+
+	free(f);
+	free(d);
+	free(v);
+	free(z);
+}
+
+// Coverage at FONT_SDF_UPSCALE times the baked size, distances measured there and sampled
+// at the center of each field texel. The field spreads FONT_SDF_SPREAD texels past the outline.
+static void font_bake_field(font_bake_t* bake, const unsigned char* coverage, int pitch, int left, int top, int right, int bottom, int ascent) {
+	int spread = FONT_SDF_SPREAD * FONT_SDF_UPSCALE;
+	int origin_x = left - spread;
+	int origin_y = top - spread;
+	bake->width = (right - left + 1 + 2 * spread + FONT_SDF_UPSCALE - 1) / FONT_SDF_UPSCALE;
+	bake->height = (bottom - top + 1 + 2 * spread + FONT_SDF_UPSCALE - 1) / FONT_SDF_UPSCALE;
+
+	int grid_width = bake->width * FONT_SDF_UPSCALE;
+	int grid_height = bake->height * FONT_SDF_UPSCALE;
+	size_t grid_size = (size_t)grid_width * grid_height;
+	float* to_inside = (float*)font_alloc(sizeof(float) * grid_size);
+	float* to_outside = (float*)font_alloc(sizeof(float) * grid_size);
+	for (int gy = 0; gy < grid_height; gy++) {
+		for (int gx = 0; gx < grid_width; gx++) {
+			int sx = origin_x + gx;
+			int sy = origin_y + gy;
+			bool inside = sx >= left && sx <= right && sy >= top && sy <= bottom
+				&& coverage[(size_t)sy * pitch + (size_t)sx * 4 + 3] >= FONT_COVERAGE_EDGE;
+			to_inside[(size_t)gy * grid_width + gx] = inside ? 0.0f : FONT_EDT_FAR;
+			to_outside[(size_t)gy * grid_width + gx] = inside ? FONT_EDT_FAR : 0.0f;
+		}
+	}
+	font_edt(to_inside, grid_width, grid_height);
+	font_edt(to_outside, grid_width, grid_height);
+
+	bake->field = (unsigned char*)font_alloc((size_t)bake->width * bake->height);
+	for (int fy = 0; fy < bake->height; fy++) {
+		for (int fx = 0; fx < bake->width; fx++) {
+			size_t i = (size_t)(fy * FONT_SDF_UPSCALE + FONT_SDF_UPSCALE / 2) * grid_width + fx * FONT_SDF_UPSCALE + FONT_SDF_UPSCALE / 2;
+			// Distances run between texel centers, the edge lies half a texel further in
+			float distance = to_outside[i] > 0.0f ? sqrtf(to_outside[i]) - 0.5f : 0.5f - sqrtf(to_inside[i]);
+			float value = 0.5f + distance / FONT_SDF_UPSCALE / (2.0f * FONT_SDF_SPREAD);
+			value = value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
+			bake->field[(size_t)fy * bake->width + fx] = (unsigned char)(value * 255.0f + 0.5f);
+		}
+	}
+	free(to_inside);
+	free(to_outside);
+
+	bake->glyph.x = (float)origin_x / FONT_SDF_UPSCALE;
+	bake->glyph.y = (float)(origin_y - ascent) / FONT_SDF_UPSCALE;
+	bake->glyph.width = (float)bake->width;
+	bake->glyph.height = (float)bake->height;
+}
+
+// The glyph is rendered like a one letter string: pen at the left edge, baseline at the ascent
+static bool font_bake_glyph(TTF_Font* ttf, int ascent, Uint16 codepoint, font_bake_t* bake) {
+	memset(bake, 0, sizeof(font_bake_t));
+	bake->glyph.page = -1;
+
+	int min_x, max_x, min_y, max_y, advance;
+	if (!TTF_GlyphIsProvided(ttf, codepoint) || TTF_GlyphMetrics(ttf, codepoint, &min_x, &max_x, &min_y, &max_y, &advance) != 0) {
+		return false;
+	}
+	bake->glyph.advance = (float)advance / FONT_SDF_UPSCALE;
+
+	SDL_Color white = { 255, 255, 255, 255 };
+	SDL_Surface* surface = TTF_RenderGlyph_Blended(ttf, codepoint, white);
+	if (surface == NULL) {
+		return true; // nothing to draw, only the advance
+	}
+	SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(surface);
+	if (converted == NULL) {
+		return false;
+	}
+
+	const unsigned char* coverage = (const unsigned char*)converted->pixels;
+	int left = converted->w;
+	int top = converted->h;
+	int right = -1;
+	int bottom = -1;
+	for (int y = 0; y < converted->h; y++) {
+		for (int x = 0; x < converted->w; x++) {
+			if (coverage[(size_t)y * converted->pitch + (size_t)x * 4 + 3] >= FONT_COVERAGE_EDGE) {
+				left = x < left ? x : left;
+				right = x > right ? x : right;
+				top = y < top ? y : top;
+				bottom = y > bottom ? y : bottom;
+			}
+		}
+	}
+	if (right >= 0) {
+		font_bake_field(bake, coverage, converted->pitch, left, top, right, bottom, ascent);
+	}
+	SDL_FreeSurface(converted);
+	return true;
+}
+
+static int font_compare_height(const void* a, const void* b) {
+	const font_bake_t* first = *(const font_bake_t* const*)a;
+	const font_bake_t* second = *(const font_bake_t* const*)b;
+	return second->height - first->height;
+}
+
+// Shelves of similar heights, tallest first, a new page when one is full
+static int font_pack(font_bake_t* bakes, int count) {
+	font_bake_t* order[FONT_GLYPH_COUNT];
+	int placed = 0;
+	for (int i = 0; i < count; i++) {
+		if (bakes[i].field != NULL) {
+			order[placed++] = &bakes[i];
+		}
+	}
+	qsort(order, placed, sizeof(font_bake_t*), font_compare_height);
+
+	int page = 0;
+	int x = FONT_PADDING;
+	int y = FONT_PADDING;
+	int shelf = 0;
+	for (int i = 0; i < placed; i++) {
+		font_bake_t* bake = order[i];
+		if (x + bake->width + FONT_PADDING > FONT_PAGE_SIZE) {
+			x = FONT_PADDING;
+			y += shelf + FONT_PADDING;
+			shelf = 0;
+		}
+		if (y + bake->height + FONT_PADDING > FONT_PAGE_SIZE) {
+			if (++page == FONT_MAX_PAGES) {
+				return 0;
+			}
+			x = FONT_PADDING;
+			y = FONT_PADDING;
+			shelf = 0;
+		}
+		bake->x = x;
+		bake->y = y;
+		bake->glyph.page = page;
+		x += bake->width + FONT_PADDING;
+		shelf = bake->height > shelf ? bake->height : shelf;
+	}
+	return page + 1;
+}
+
+static bool font_write_pages(const char* font_name, const font_bake_t* bakes, int count, int page_count) {
+	size_t page_size = (size_t)FONT_PAGE_SIZE * FONT_PAGE_SIZE;
+	unsigned char* pixels = (unsigned char*)font_alloc(page_size);
+	bool written = true;
+	for (int page = 0; page < page_count && written; page++) {
+		// Zero is as far outside as the field goes, the empty space around the glyphs
+		memset(pixels, 0, page_size);
+		for (int i = 0; i < count; i++) {
+			const font_bake_t* bake = &bakes[i];
+			if (bake->field == NULL || bake->glyph.page != page) {
+				continue;
+			}
+			for (int row = 0; row < bake->height; row++) {
+				unsigned char* target = pixels + (size_t)(FONT_PAGE_SIZE - 1 - (bake->y + row)) * FONT_PAGE_SIZE + bake->x;
+				memcpy(target, bake->field + (size_t)row * bake->width, bake->width);
+			}
+		}
+
+		char page_name[FONT_NAME_LENGTH + 16];
+		font_page_name(page_name, sizeof(page_name), font_name, page);
+		char* path = font_binary_path(page_name, DTEX_EXTENSION);
+		written = dtex_write(path, pixels, FONT_PAGE_SIZE, FONT_PAGE_SIZE, 1, 0, DTEX_COMPRESSION_NONE, FONT_MIP_LEVELS, 0);
+		free(path);
+	}
+	free(pixels);
+	return written;
+}
+
+// Texel rects are stored bottom-left origin like the atlas sprites
+// The header ends with the stamp of the TrueType file, a changed font is cooked again
+static bool font_write_metrics(const char* font_name, TTF_Font* ttf, const font_bake_t* bakes, int count, int page_count, uint64_t source_stamp) {
+	char* path = font_binary_path(font_name, FONT_EXTENSION);
+	FILE* file = fopen(path, "w");
+	free(path);
+	if (file == NULL) {
+		fprintf(stderr, "failed to write font: %s.\n", font_name);
+		return false;
+	}
+
+	fprintf(file, "font %d %g %g %d %016llx\n", FONT_SDF_SIZE,
+		(float)TTF_FontAscent(ttf) / FONT_SDF_UPSCALE, (float)TTF_FontLineSkip(ttf) / FONT_SDF_UPSCALE, page_count, (unsigned long long)source_stamp);
+	for (int i = 0; i < count; i++) {
+		const font_bake_t* bake = &bakes[i];
+		const font_glyph_t* glyph = &bake->glyph;
+		fprintf(file, "glyph %d %d %d %d %d %d %g %g %g\n", FONT_FIRST_GLYPH + i, glyph->page,
+			bake->x, FONT_PAGE_SIZE - bake->y - bake->height, bake->width, bake->height, glyph->x, glyph->y, glyph->advance);
+	}
+	for (int first = 0; first < count; first++) {
+		for (int second = 0; second < count; second++) {
+			int amount = TTF_GetFontKerningSizeGlyphs(ttf, (Uint16)(FONT_FIRST_GLYPH + first), (Uint16)(FONT_FIRST_GLYPH + second));
+			if (amount != 0) {
+				fprintf(file, "kern %d %d %g\n", FONT_FIRST_GLYPH + first, FONT_FIRST_GLYPH + second, (float)amount / FONT_SDF_UPSCALE);
+			}
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+bool font_cook(const char* font_file, const char* font_name) {
+	char* path = font_source_path(font_file);
+	if (path == NULL) {
+		fprintf(stderr, "failed to find font: %s.\n", font_file);
+		return false;
+	}
+
+	bool initialized = TTF_WasInit() == 0;
+	if (initialized && TTF_Init() != 0) {
+		fprintf(stderr, "failed to initialize fonts: %s.\n", TTF_GetError());
+		free(path);
+		return false;
+	}
+	TTF_Font* ttf = TTF_OpenFont(path, FONT_SDF_SIZE * FONT_SDF_UPSCALE);
+	uint64_t source_stamp = file_stamp(path);
+	free(path);
+	if (ttf == NULL) {
+		fprintf(stderr, "failed to open font: %s.\n", TTF_GetError());
+		if (initialized) {
+			TTF_Quit();
+		}
+		return false;
+	}
+
+	font_bake_t* bakes = (font_bake_t*)font_alloc(sizeof(font_bake_t) * FONT_GLYPH_COUNT);
+	int ascent = TTF_FontAscent(ttf);
+	bool cooked = true;
+	for (int i = 0; i < FONT_GLYPH_COUNT && cooked; i++) {
+		cooked = font_bake_glyph(ttf, ascent, (Uint16)(FONT_FIRST_GLYPH + i), &bakes[i]);
+		if (!cooked) {
+			fprintf(stderr, "font %s has no glyph for '%c'.\n", font_file, FONT_FIRST_GLYPH + i);
+		}
+	}
+
+	int page_count = cooked ? font_pack(bakes, FONT_GLYPH_COUNT) : 0;
+	if (cooked && page_count == 0) {
+		fprintf(stderr, "font %s does not fit in %d pages.\n", font_name, FONT_MAX_PAGES);
+		cooked = false;
+	}
+	cooked = cooked
+		&& font_write_pages(font_name, bakes, FONT_GLYPH_COUNT, page_count)
+		&& font_write_metrics(font_name, ttf, bakes, FONT_GLYPH_COUNT, page_count, source_stamp);
+	if (cooked) {
+		printf("Font %s: %d glyphs in %d pages of %dx%d\n", font_name, FONT_GLYPH_COUNT, page_count, FONT_PAGE_SIZE, FONT_PAGE_SIZE);
+	}
+
+	for (int i = 0; i < FONT_GLYPH_COUNT; i++) {
+		free(bakes[i].field);
+	}
+	free(bakes);
+	TTF_CloseFont(ttf);
+	if (initialized) {
+		TTF_Quit();
+	}
+	return cooked;
+}
+
+// Stale once the TrueType file changed. Without the source the cooked font is kept.
+bool font_is_cooked(const char* font_file, const char* font_name) {
+	char* source_path = font_source_path(font_file);
+	uint64_t source_stamp = source_path != NULL ? file_stamp(source_path) : 0;
+	free(source_path);
+
+	char* path = font_binary_path(font_name, FONT_EXTENSION);
+	FILE* file = fopen(path, "r");
+	free(path);
+	if (file == NULL) {
+		return false;
+	}
+
+	char line[256];
+	int size = 0;
+	int page_count = 0;
+	float ascent, line_height;
+	unsigned long long cooked_stamp = 0;
+	bool cooked = fgets(line, sizeof(line), file) != NULL
+		&& sscanf_s(line, "font %d %f %f %d %llx", &size, &ascent, &line_height, &page_count, &cooked_stamp) == 5
+		&& size == FONT_SDF_SIZE && page_count > 0 && page_count <= FONT_MAX_PAGES
+		&& (source_stamp == 0 || source_stamp == cooked_stamp);
+	fclose(file);
+
+	for (int page = 0; page < page_count && cooked; page++) {
+		char page_name[FONT_NAME_LENGTH + 16];
+		font_page_name(page_name, sizeof(page_name), font_name, page);
+		char* page_path = font_binary_path(page_name, DTEX_EXTENSION);
+		cooked = dtex_is_valid(page_path);
+		free(page_path);
+	}
+	return cooked;
+}
+
+static void font_load_kerning(font_t* font, int first, int second, float amount) {
+	if (first < FONT_FIRST_GLYPH || first > FONT_LAST_GLYPH || second < FONT_FIRST_GLYPH || second > FONT_LAST_GLYPH) {
+		return;
+	}
+	if (font->kerning == NULL) {
+		font->kerning = (float*)calloc((size_t)FONT_GLYPH_COUNT * FONT_GLYPH_COUNT, sizeof(float));
+		if (font->kerning == NULL) {
+			fprintf(stderr, "failed to allocate memory for font kerning.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	font->kerning[(first - FONT_FIRST_GLYPH) * FONT_GLYPH_COUNT + second - FONT_FIRST_GLYPH] = amount;
+}
+
+bool font_load(font_t* font, const char* font_name) {
+	snprintf(font->name, sizeof(font->name), "%s%s", font_name, FONT_EXTENSION);
+	font->size = 0.0f;
+	font->kerning = NULL;
+	font->page_count = 0;
+	for (int i = 0; i < FONT_GLYPH_COUNT; i++) {
+		font->glyphs[i] = (font_glyph_t){ .page = -1 };
+	}
+
+	char* path = font_binary_path(font_name, FONT_EXTENSION);
+	FILE* file = fopen(path, "r");
+	free(path);
+	if (file == NULL) {
+		fprintf(stderr, "failed to open font: %s.\n", font_name);
+		return false;
+	}
+
+	char line[256];
+	int size = 0;
+	int page_count = 0;
+	if (fgets(line, sizeof(line), file) == NULL
+		|| sscanf_s(line, "font %d %f %f %d", &size, &font->ascent, &font->line_height, &page_count) != 4
+		|| page_count <= 0 || page_count > FONT_MAX_PAGES) {
+		fprintf(stderr, "invalid font: %s.\n", font_name);
+		fclose(file);
+		return false;
+	}
+	font->size = (float)size;
+
+	int glyphs = 0;
+	while (fgets(line, sizeof(line), file)) {
+		int codepoint, page, x, y, width, height;
+		float offset_x, offset_y, advance;
+		int first, second;
+		float amount;
+		if (sscanf_s(line, "glyph %d %d %d %d %d %d %f %f %f", &codepoint, &page, &x, &y, &width, &height, &offset_x, &offset_y, &advance) == 9) {
+			if (codepoint < FONT_FIRST_GLYPH || codepoint > FONT_LAST_GLYPH || page >= page_count) {
+				continue;
+			}
+			font->glyphs[codepoint - FONT_FIRST_GLYPH] = (font_glyph_t){
+				.page = page,
+				.uv = {
+					(float)x / FONT_PAGE_SIZE, (float)y / FONT_PAGE_SIZE,
+					(float)(x + width) / FONT_PAGE_SIZE, (float)(y + height) / FONT_PAGE_SIZE
+				},
+				.x = offset_x,
+				.y = offset_y,
+				.width = (float)width,
+				.height = (float)height,
+				.advance = advance
+			};
+			glyphs++;
+		}
+		else if (sscanf_s(line, "kern %d %d %f", &first, &second, &amount) == 3) {
+			font_load_kerning(font, first, second, amount);
+		}
+	}
+	fclose(file);
+
+	// The field is data: clamped so no glyph reads across the page border, never sRGB
+	sampler_t sampler = { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR };
+	for (int page = 0; page < page_count; page++) {
+		char page_name[FONT_NAME_LENGTH + 16];
+		font_page_name(page_name, sizeof(page_name), font_name, page);
+		char* texture_path = create_texture_path(page_name);
+		font->pages[page] = texture_mgr_acquire_async(texture_path, &sampler);
+		free(texture_path);
+		font->page_count++;
+	}
+	return glyphs == FONT_GLYPH_COUNT;
+}
+
+// Bytes outside the baked range fall back to '?'
+const font_glyph_t* font_glyph(const font_t* font, char c) {
+	unsigned char code = (unsigned char)c;
+	if (code < FONT_FIRST_GLYPH || code > FONT_LAST_GLYPH) {
+		code = '?';
+	}
+	return &font->glyphs[code - FONT_FIRST_GLYPH];
+}
+
+float font_kerning(const font_t* font, char first, char second) {
+	unsigned char a = (unsigned char)first;
+	unsigned char b = (unsigned char)second;
+	if (font->kerning == NULL || a < FONT_FIRST_GLYPH || a > FONT_LAST_GLYPH || b < FONT_FIRST_GLYPH || b > FONT_LAST_GLYPH) {
+		return 0.0f;
+	}
+	return font->kerning[(a - FONT_FIRST_GLYPH) * FONT_GLYPH_COUNT + b - FONT_FIRST_GLYPH];
+}
+
+void font_delete(font_t* font) {
+	for (int page = 0; page < font->page_count; page++) {
+		texture_mgr_release(font->pages[page]);
+	}
+	font->page_count = 0;
+	free(font->kerning);
+	font->kerning = NULL;
+}
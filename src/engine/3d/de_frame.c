@@ -0,0 +1,117 @@
+/**
+* @file de_frame.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_frame.h"
+#include "../../include/de_buffer.h"
+
+// std140 layout of FrameBlock in the shaders, every vec3 takes a full vec4
+typedef struct {
+	float direction[VEC4];
+	float ambient[VEC4];
+	float diffuse[VEC4];
+	float specular[VEC4];
+} directional_light_block_t;
+
+typedef struct {
+	float position[VEC4];
+	float ambient[VEC4];
+	float diffuse[VEC4];
+	float specular[VEC4];
+	float attenuation[VEC4]; // constant, linear, quadratic
+} point_light_block_t;
+
+typedef struct {
+	float position[VEC4];
+	float direction[VEC4];
+	float ambient[VEC4];
+	float diffuse[VEC4];
+	float specular[VEC4];
+	float cone[VEC4];        // cos inner, cos outer, 1 when on
+	float attenuation[VEC4]; // constant, linear, quadratic
+} spot_light_block_t;
+
+typedef struct {
+	float view[MAT4];
+	float projection[MAT4];
+	float eye[VEC4];
+	directional_light_block_t light;
+	point_light_block_t point_light;
+	spot_light_block_t spot_light;
+} frame_block_t;
+
+static stream_buffer_t stream; // a block per frame, the GPU may still read the last ones
+static bool initialized = false;
+
+static void frame_pack(float* out, float x, float y, float z) {
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+	out[3] = 0.0f;
+}
+
+static void frame_pack_vec3(float* out, const vec3_t* value) {
+	frame_pack(out, value->x, value->y, value->z);
+}
+
+frame_t frame_init(void) {
+	frame_t frame;
+	frame.view = mat4_identity();
+	frame.projection = mat4_identity();
+	frame.eye = vec3_new(0.0f, 0.0f, 0.0f);
+	frame.directional_light = directional_light_init();
+	frame.point_light = point_light_init();
+	frame.spot_light = spot_light_init();
+	frame.spot_light_on = false;
+	return frame;
+}
+
+void frame_upload(const frame_t* frame) {
+	frame_block_t block;
+	mat4_to_array(&frame->view, block.view);
+	mat4_to_array(&frame->projection, block.projection);
+	frame_pack_vec3(block.eye, &frame->eye);
+
+	const directional_light_t* light = &frame->directional_light;
+	frame_pack_vec3(block.light.direction, &light->direction);
+	frame_pack_vec3(block.light.ambient, &light->ambient);
+	frame_pack_vec3(block.light.diffuse, &light->diffuse);
+	frame_pack_vec3(block.light.specular, &light->specular);
+
+	const point_light_t* point = &frame->point_light;
+	frame_pack_vec3(block.point_light.position, &point->position);
+	frame_pack_vec3(block.point_light.ambient, &point->ambient);
+	frame_pack_vec3(block.point_light.diffuse, &point->diffuse);
+	frame_pack_vec3(block.point_light.specular, &point->specular);
+	frame_pack(block.point_light.attenuation, point->constant, point->linear, point->quadratic);
+
+	const spot_light_t* spot = &frame->spot_light;
+	frame_pack_vec3(block.spot_light.position, &spot->position);
+	frame_pack_vec3(block.spot_light.direction, &spot->direction);
+	frame_pack_vec3(block.spot_light.ambient, &spot->ambient);
+	frame_pack_vec3(block.spot_light.diffuse, &spot->diffuse);
+	frame_pack_vec3(block.spot_light.specular, &spot->specular);
+	frame_pack(block.spot_light.cone, spot->cosInnerCone, spot->cosOuterCone, frame->spot_light_on ? 1.0f : 0.0f);
+	frame_pack(block.spot_light.attenuation, spot->constant, spot->linear, spot->quadratic);
+
+	// One upload for the whole frame, the binding point stays put across program changes
+	if (!initialized) {
+		stream_buffer_init(&stream, GL_UNIFORM_BUFFER, sizeof(frame_block_t));
+		initialized = true;
+	}
+	stream_buffer_begin_frame(&stream);
+	GLintptr offset = stream_buffer_write(&stream, &block, sizeof(frame_block_t));
+	stream_buffer_bind_range(&stream, FRAME_BINDING, offset, sizeof(frame_block_t));
+}
+
+void frame_shutdown(void) {
+	if (!initialized) {
+		return;
+	}
+	stream_buffer_delete(&stream);
+	initialized = false;
+}
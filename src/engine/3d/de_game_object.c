@@ -9,54 +9,102 @@
 #include "../../include/de_util.h"
 #include "../../include/de_math.h"
 #include "../../include/simd_math.h"
+#include "../../include/de_camera.h"
 #include "../../include/de_game_object.h"
 
-void game_object_init(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture) {
+static void game_object_init_common(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture, shader_key_t key, bool streamed) {
 	go->model = mat4_identity();
 	go->position = vec3_new(0.0f, 0.0f, 0.0f);
 	go->rotation = vec3_new(0.0f, 0.0f, 0.0f);
 	go->scale    = vec3_new(1.0f, 1.0f, 1.0f);
-
-	buffer_init(&go->vao, &go->vbo, &go->ebo);
+	go->dirty    = true;
+	go->mesh     = MESH_HANDLE_INVALID;
+	go->lod      = 0;
 
 	char* texture_path = create_texture_path(texture);
-	tbo_init(&go->tbo, texture_path);
-
-	if (!tbo_load(&go->tbo)) {
-		fprintf(stderr, "failed to load texture.\n");
-		exit(EXIT_FAILURE);
-	}
-
-	program_init(&go->program);
+	sampler_t sampler = SAMPLER_DEFAULT;
+	go->texture = streamed ? texture_mgr_acquire_streamed(texture_path, &sampler) : texture_mgr_acquire_async(texture_path, &sampler);
 
-	char* vertex_shader_path   = create_shader_path(vertex_shader);
-	char* fragment_shader_path = create_shader_path(fragment_shader);
-
-	if (!program_compile(&go->program, vertex_shader_path, fragment_shader_path)) {
+	// Objects with the same shaders and features share one program
+	go->program = shader_mgr_acquire_variant(vertex_shader, fragment_shader, key);
+	if (go->program == PROGRAM_HANDLE_INVALID) {
 		fprintf(stderr, "failed to compile shaders.\n");
 		exit(EXIT_FAILURE);
 	}
 
-	go->uniform_model = program_get_uniform_location(&go->program, MODEL);
-	go->uniform_view = program_get_uniform_location(&go->program,VIEW);
-	go->uniform_projection = program_get_uniform_location(&go->program, PROJECTION);
-	go->uniform_texture = program_get_uniform_location(&go->program, TEXTURE);
+	program_t* program = shader_mgr_program(go->program);
+	go->uniform_model = program_find_uniform(program, NAME_HASH(MODEL));
+	go->uniform_texture = program_find_uniform(program, NAME_HASH(TEXTURE));
+	go->instanced = program_find_attribute(program, NAME_HASH(INSTANCE_MODEL)) >= 0;
 
 	free(texture_path);
-	free(vertex_shader_path);
-	free(fragment_shader_path);
 }
 
-void game_object_3d_init(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model) {
-	game_object_init(go, vertex_shader, fragment_shader, texture);
-	mesh_load_obj(&go->mesh, model);
+void game_object_init(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture) {
+	game_object_init_common(go, vertex_shader, fragment_shader, texture, SHADER_KEY_NONE, false);
+	buffer_init(&go->vao, &go->vbo, &go->ebo);
+}
+
+void game_object_3d_init(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model, vertex_format_t format, shader_key_t features) {
+	// 3d objects come and go with the camera, their textures only keep the mips they show
+	// Packed vertices are decoded by the DE_PACKED_VERTEX variant of the same shaders
+	shader_key_t key = format != VERTEX_FORMAT_FLOAT ? features | SHADER_PACKED_VERTEX : features;
+	game_object_init_common(go, vertex_shader, fragment_shader, texture, key, true);
+	go->mesh = mesh_mgr_acquire(model, format);
+}
+
+mesh_t* game_object_get_mesh(const game_object_t* go) {
+	return mesh_mgr_get(go->mesh)->mesh;
 }
 
 void game_object_update_model_matrix(game_object_t* go) {
+	if (!go->dirty) {
+		return;
+	}
 	go->model = mat4_identity();
 	game_object_scale(go, &go->scale);
 	game_object_rotate(go, &go->rotation);
 	game_object_translate(go, &go->position);
+	game_object_update_bounds(go);
+	go->dirty = false;
+}
+
+void game_object_update_bounds(game_object_t* go) {
+	if (go->mesh == MESH_HANDLE_INVALID) {
+		return;
+	}
+	const mesh_t* mesh = game_object_get_mesh(go);
+	const mat4_t* m = &go->model;
+
+	// Transformed box center plus the extents projected on each world axis (Arvo)
+	vec3_t sum = vec3_add(&mesh->bounds.min, &mesh->bounds.max);
+	vec3_t diff = vec3_sub(&mesh->bounds.max, &mesh->bounds.min);
+	vec3_t center = vec3_mul(&sum, 0.5f);
+	vec3_t extent = vec3_mul(&diff, 0.5f);
+
+	float column_squared[VEC3] = { 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < VEC3; i++) {
+		float world_center = m->m[i][3];
+		float world_extent = 0.0f;
+		for (int j = 0; j < VEC3; j++) {
+			world_center += m->m[i][j] * center.as_array[j];
+			world_extent += fabsf(m->m[i][j]) * extent.as_array[j];
+			column_squared[j] += m->m[i][j] * m->m[i][j];
+		}
+		go->world_bounds.min.as_array[i] = world_center - world_extent;
+		go->world_bounds.max.as_array[i] = world_center + world_extent;
+	}
+
+	vec4_t sphere_center = vec4_new(mesh->sphere.center.x, mesh->sphere.center.y, mesh->sphere.center.z, 1.0f);
+	vec4_t world_sphere_center = mat4_mul_vec4(m, &sphere_center);
+	float max_scale = sqrtf(maxf(column_squared[0], maxf(column_squared[1], column_squared[2])));
+	go->world_sphere.center = vec3_new(world_sphere_center.x, world_sphere_center.y, world_sphere_center.z);
+	go->world_sphere.radius = mesh->sphere.radius * max_scale;
+}
+
+bool game_object_in_frustum(const game_object_t* go, const frustum_t* frustum) {
+	return frustum_test_sphere(frustum, &go->world_sphere.center, go->world_sphere.radius)
+		&& frustum_test_aabb(frustum, &go->world_bounds);
 }
 
 void game_object_scale(game_object_t* go, const vec3_t* scale) {
@@ -83,38 +131,65 @@ void game_object_translate(game_object_t* go, const vec3_t* position) {
 	go->model = mat4_mul_mat4_sse(&translation_matrix, &go->model);
 }
 
-bool ray_intersects_sphere(const ray_t* ray, const vec3_t* sphere_center, float sphere_radius) {
-    vec3_t oc = {
-        ray->origin.x - sphere_center->x,
-        ray->origin.y - sphere_center->y,
-        ray->origin.z - sphere_center->z
-    };
-
-    float a = ray->direction.x * ray->direction.x +
-        ray->direction.y * ray->direction.y +
-        ray->direction.z * ray->direction.z;
+void game_object_select_lod(game_object_t* go, const vec3_t* eye) {
+	vec3_t offset = vec3_sub(&go->position, eye);
+	float distance = vec3_magnitude(&offset);
+	float scale = maxf(go->scale.x, maxf(go->scale.y, go->scale.z));
+	go->lod = mesh_select_lod(game_object_get_mesh(go), go->lod, distance, scale, camera_projection_scale());
+}
 
-    float b = 2.0f * (oc.x * ray->direction.x +
-        oc.y * ray->direction.y +
-        oc.z * ray->direction.z);
+static bool ray_intersects_sphere(const ray_t* ray, const sphere_t* sphere) {
+	vec3_t oc = vec3_sub(&ray->origin, &sphere->center);
+	float b = vec3_dot(&oc, &ray->direction);
+	float c = vec3_dot(&oc, &oc) - sphere->radius * sphere->radius;
 
-    float c = oc.x * oc.x + oc.y * oc.y + oc.z * oc.z - sphere_radius * sphere_radius;
+	// Origin outside and pointing away, or the line misses the sphere
+	if (c > 0.0f && b > 0.0f) {
+		return false;
+	}
+	return b * b - c >= 0.0f;
+}
 
-    float discriminant = b * b - 4 * a * c;
+static bool ray_intersects_aabb(const ray_t* ray, const aabb_t* aabb, float* distance) {
+	float t_min = 0.0f;
+	float t_max = FLT_MAX;
+
+	for (int axis = 0; axis < VEC3; axis++) {
+		float origin = ray->origin.as_array[axis];
+		float direction = ray->direction.as_array[axis];
+		float min = aabb->min.as_array[axis];
+		float max = aabb->max.as_array[axis];
+
+		if (fabsf(direction) < FLT_EPSILON) {
+			// Parallel to this slab, must already be inside it
+			if (origin < min || origin > max) {
+				return false;
+			}
+			continue;
+		}
+
+		float inverse = 1.0f / direction;
+		float t0 = (min - origin) * inverse;
+		float t1 = (max - origin) * inverse;
+		t_min = maxf(t_min, minf(t0, t1));
+		t_max = minf(t_max, maxf(t0, t1));
+		if (t_min > t_max) {
+			return false;
+		}
+	}
 
-    if (discriminant < 0) {
-        return false; // No intersection
-    }
-    else {
-        // Optionally, calculate the intersection points t1 and t2
-        float t1 = (-b - sqrtf(discriminant)) / (2.0f * a);
-        float t2 = (-b + sqrtf(discriminant)) / (2.0f * a);
+	*distance = t_min;
+	return true;
+}
 
-        // You can use t1 and t2 to determine where the ray intersects the sphere
-        return true;
-    }
+bool game_object_ray_intersect(const game_object_t* go, const ray_t* ray, float* distance) {
+	// Cheap sphere rejection first, the box gives the hit distance
+	return ray_intersects_sphere(ray, &go->world_sphere) && ray_intersects_aabb(ray, &go->world_bounds, distance);
 }
 
-bool game_object_ray_intersect(const game_object_t* go, const ray_t* ray) {
-	return ray_intersects_sphere(ray, &go->position, 1.5f);
+void game_object_request_texture(const game_object_t* go, const vec3_t* eye) {
+	// Projected diameter of the bounding sphere, the texture is assumed to span it once
+	vec3_t offset = vec3_sub(&go->world_sphere.center, eye);
+	float distance = maxf(vec3_magnitude(&offset) - go->world_sphere.radius, 0.0001f);
+	texture_mgr_request(go->texture, 2.0f * go->world_sphere.radius * camera_projection_scale() / distance);
 }
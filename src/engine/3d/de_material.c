@@ -6,7 +6,27 @@
 * Dodoi-Engine is a game engine developed by Dodoi-Lab.
 * @copyright Copyright (c) 2024, Dodoi-Lab
 */
+#include "../../include/de_buffer.h"
 #include "../../include/de_material.h"
+#include "../../include/de_collection.h"
+
+// std140 layout of MaterialBlock in the shaders
+typedef struct {
+	float ambient[VEC4];
+	float diffuse[VEC4];
+	float specular[VEC4];
+	float shininess;
+	float padding[VEC3];
+} material_block_t;
+
+// One uniform buffer per distinct material value, objects with the same material share it
+typedef struct {
+	material_t material;
+	ubo_t ubo;
+} material_buffer_t;
+
+static list_t buffers;
+static bool initialized = false;
 
 material_t material_init(void) {
 	material_t material;
@@ -362,3 +382,56 @@ material_t material_polished_turquoise(void) {
         .shininess = 0.1f * 128.0f
     };
 }
+
+static void material_pack_vec3(const vec3_t* value, float* out) {
+	out[0] = value->x;
+	out[1] = value->y;
+	out[2] = value->z;
+	out[3] = 0.0f;
+}
+
+int material_buffer(const material_t* material) {
+	if (!initialized) {
+		list_init(&buffers, sizeof(material_buffer_t));
+		initialized = true;
+	}
+
+	// A handful of presets per scene, a linear scan is cheaper than anything the driver does
+	for (size_t i = 0; i < list_size(&buffers); i++) {
+		material_buffer_t* candidate = (material_buffer_t*)list_get(&buffers, i);
+		if (memcmp(&candidate->material, material, sizeof(material_t)) == 0) {
+			return (int)i;
+		}
+	}
+
+	material_block_t block = { 0 };
+	material_pack_vec3(&material->ambient, block.ambient);
+	material_pack_vec3(&material->diffuse, block.diffuse);
+	material_pack_vec3(&material->specular, block.specular);
+	block.shininess = material->shininess;
+
+	material_buffer_t created = { *material, { 0, 0 } };
+	ubo_init(&created.ubo, sizeof(material_block_t));
+	ubo_set_data(&created.ubo, &block, sizeof(material_block_t));
+	list_add(&buffers, &created);
+	return (int)list_size(&buffers) - 1;
+}
+
+void material_bind_buffer(int index) {
+	// Skipped by the state cache when the buffer is already bound
+	ubo_bind_base(&((material_buffer_t*)list_get(&buffers, (size_t)index))->ubo, MATERIAL_BINDING);
+}
+
+void material_bind(const material_t* material) {
+	material_bind_buffer(material_buffer(material));
+}
+
+void material_shutdown(void) {
+	if (!initialized) {
+		return;
+	}
+	for (size_t i = 0; i < list_size(&buffers); i++) {
+		ubo_delete(&((material_buffer_t*)list_get(&buffers, i))->ubo);
+	}
+	list_clear(&buffers);
+}
@@ -7,9 +7,13 @@
 * @copyright Copyright (c) 2024, Dodoi-Lab
 */
 #include "../../include/de_mesh.h"
+#include "../../include/de_math.h"
 #include "../../include/de_util.h"
 #include "../../include/de_obj_loader.h"
 
+static uint16_t mesh_pack_half(float value);
+static void mesh_pack_oct(const vec3_t* normal, int16_t* out);
+
 mesh_t* mesh_new(void) {
 	mesh_t* mesh = (mesh_t*)malloc(sizeof(mesh_t));
 	if (mesh == NULL) {
@@ -19,23 +23,49 @@ mesh_t* mesh_new(void) {
 	return mesh;
 }
 
-void mesh_load_obj(mesh_t* mesh, const char* path) {
+bool mesh_load_obj(mesh_t* mesh, const char* path) {
 	char* mesh_path = create_model_path(path);
-	obj_load(mesh, mesh_path);
+	bool loaded = mesh_import(mesh, mesh_path);
+	free(mesh_path);
+	return loaded;
+}
+
+bool mesh_import(mesh_t* mesh, const char* file_path) {
+	if (!obj_load(mesh, file_path)) {
+		return false;
+	}
+	mesh_process(mesh);
+	return true;
+}
+
+void mesh_process(mesh_t* mesh) {
+	mesh_compute_bounds(mesh);
+	mesh_build_lods(mesh, MESH_MAX_LODS, MESH_LOD_RATIO);
+	if (mesh->lods[0].index_count / 3 >= MESHLET_MIN_TRIANGLES) {
+		mesh_build_meshlets(mesh);
+	}
 }
 
 unsigned int* mesh_index_to_gl_buffer(mesh_t* mesh) {
-	int face_count = mesh->face_count;
-	unsigned int* buffer = (int*)malloc(sizeof(int) * face_count * 3);
+	int index_count = mesh->index_count;
+	unsigned int* buffer = (unsigned int*)malloc(sizeof(unsigned int) * index_count);
 	if (buffer == NULL) {
 		fprintf(stderr, "failed to allocate memory for buffer.\n");
 		exit(EXIT_FAILURE);
 	}
-	for (int i = 0; i < face_count; i++) {
-		face_t* face = &mesh->faces[i];
-		buffer[i * 3 + 0] = face->vertex[0];
-		buffer[i * 3 + 1] = face->vertex[1];
-		buffer[i * 3 + 2] = face->vertex[2];
+	memcpy(buffer, mesh->indices, sizeof(unsigned int) * index_count);
+	return buffer;
+}
+
+unsigned short* mesh_index_to_gl_buffer_u16(mesh_t* mesh) {
+	int index_count = mesh->index_count;
+	unsigned short* buffer = (unsigned short*)malloc(sizeof(unsigned short) * index_count);
+	if (buffer == NULL) {
+		fprintf(stderr, "failed to allocate memory for buffer.\n");
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < index_count; i++) {
+		buffer[i] = (unsigned short)mesh->indices[i];
 	}
 	return buffer;
 }
@@ -61,8 +91,225 @@ float* mesh_vertex_to_gl_buffer(mesh_t* mesh) {
 	return buffer;
 }
 
+packed_vertex_t* mesh_vertex_to_packed_buffer(mesh_t* mesh) {
+	int vertex_count = mesh->vertex_count;
+	packed_vertex_t* buffer = (packed_vertex_t*)malloc(sizeof(packed_vertex_t) * vertex_count);
+	if (buffer == NULL) {
+		fprintf(stderr, "failed to allocate memory for buffer.\n");
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < vertex_count; i++) {
+		vertex_t* vertex = &mesh->vertices[i];
+		buffer[i].position = vertex->position;
+		mesh_pack_oct(&vertex->normal, buffer[i].normal);
+		buffer[i].uv[0] = mesh_pack_half(vertex->uv.u);
+		buffer[i].uv[1] = mesh_pack_half(vertex->uv.v);
+	}
+	mesh->dequant_scale = vec3_one();
+	mesh->dequant_offset = vec3_zero();
+	return buffer;
+}
+
+quantized_vertex_t* mesh_vertex_to_quantized_buffer(mesh_t* mesh) {
+	int vertex_count = mesh->vertex_count;
+	quantized_vertex_t* buffer = (quantized_vertex_t*)malloc(sizeof(quantized_vertex_t) * vertex_count);
+	if (buffer == NULL) {
+		fprintf(stderr, "failed to allocate memory for buffer.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// Per-axis range of the mesh, mapped onto [-32767, 32767]
+	const vec3_t* min = &mesh->bounds.min;
+	const vec3_t* max = &mesh->bounds.max;
+	for (int axis = 0; axis < VEC3; axis++) {
+		float extent = (max->as_array[axis] - min->as_array[axis]) * 0.5f;
+		mesh->dequant_offset.as_array[axis] = (max->as_array[axis] + min->as_array[axis]) * 0.5f;
+		mesh->dequant_scale.as_array[axis] = extent > 0.0f ? extent / 32767.0f : 1.0f;
+	}
+
+	for (int i = 0; i < vertex_count; i++) {
+		vertex_t* vertex = &mesh->vertices[i];
+		for (int axis = 0; axis < VEC3; axis++) {
+			float q = (vertex->position.as_array[axis] - mesh->dequant_offset.as_array[axis]) / mesh->dequant_scale.as_array[axis];
+			buffer[i].position[axis] = (int16_t)lroundf(clampf(q, -32767.0f, 32767.0f));
+		}
+		buffer[i].position[3] = 0;
+		mesh_pack_oct(&vertex->normal, buffer[i].normal);
+		buffer[i].uv[0] = mesh_pack_half(vertex->uv.u);
+		buffer[i].uv[1] = mesh_pack_half(vertex->uv.v);
+	}
+	return buffer;
+}
+
+void mesh_compute_bounds(mesh_t* mesh) {
+	int vertex_count = mesh->vertex_count;
+	if (vertex_count == 0) {
+		mesh->bounds.min = vec3_zero();
+		mesh->bounds.max = vec3_zero();
+		mesh->sphere.center = vec3_zero();
+		mesh->sphere.radius = 0.0f;
+		return;
+	}
+
+	// Four lanes per vertex, the fourth one picks up normal.x and is ignored
+	__m128 min = _mm_set1_ps(FLT_MAX);
+	__m128 max = _mm_set1_ps(-FLT_MAX);
+	for (int i = 0; i < vertex_count; i++) {
+		__m128 p = _mm_loadu_ps(mesh->vertices[i].position.as_array);
+		min = _mm_min_ps(min, p);
+		max = _mm_max_ps(max, p);
+	}
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, min);
+	mesh->bounds.min = vec3_new(lanes[0], lanes[1], lanes[2]);
+	_mm_storeu_ps(lanes, max);
+	mesh->bounds.max = vec3_new(lanes[0], lanes[1], lanes[2]);
+
+	// Sphere around the box center, radius from the farthest vertex
+	__m128 center = _mm_mul_ps(_mm_add_ps(min, max), _mm_set1_ps(0.5f));
+	__m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+	__m128 radius_squared = _mm_setzero_ps();
+	for (int i = 0; i < vertex_count; i++) {
+		__m128 d = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(mesh->vertices[i].position.as_array), center), mask);
+		d = _mm_mul_ps(d, d);
+		d = _mm_add_ps(d, _mm_movehl_ps(d, d));
+		d = _mm_add_ss(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 1, 1, 1)));
+		radius_squared = _mm_max_ss(radius_squared, d);
+	}
+
+	_mm_storeu_ps(lanes, center);
+	mesh->sphere.center = vec3_new(lanes[0], lanes[1], lanes[2]);
+	mesh->sphere.radius = sqrtf(_mm_cvtss_f32(radius_squared));
+}
+
+size_t mesh_vertex_stride(vertex_format_t format) {
+	switch (format) {
+	case VERTEX_FORMAT_PACKED:           return sizeof(packed_vertex_t);
+	case VERTEX_FORMAT_PACKED_QUANTIZED: return sizeof(quantized_vertex_t);
+	default:                             return STRIDE_3f_3f_2f;
+	}
+}
+
+void mesh_upload(mesh_t* mesh, vao_t* vao, vbo_t* vbo, ebo_t* ebo, vertex_format_t format) {
+	void* vertices = NULL;
+	void* indices = NULL;
+	size_t vertex_size = mesh_vertex_stride(format);
+	size_t index_size;
+
+	switch (format) {
+	case VERTEX_FORMAT_PACKED:
+		vertices = mesh_vertex_to_packed_buffer(mesh);
+		break;
+	case VERTEX_FORMAT_PACKED_QUANTIZED:
+		vertices = mesh_vertex_to_quantized_buffer(mesh);
+		break;
+	default:
+		vertices = mesh_vertex_to_gl_buffer(mesh);
+		mesh->dequant_scale = vec3_one();
+		mesh->dequant_offset = vec3_zero();
+		break;
+	}
+
+	// 16-bit indices whenever every vertex is addressable with them
+	if (mesh->vertex_count < 65536) {
+		indices = mesh_index_to_gl_buffer_u16(mesh);
+		index_size = sizeof(unsigned short);
+		mesh->index_type = GL_UNSIGNED_SHORT;
+	}
+	else {
+		indices = mesh_index_to_gl_buffer(mesh);
+		index_size = sizeof(unsigned int);
+		mesh->index_type = GL_UNSIGNED_INT;
+	}
+	mesh->format = format;
+
+	vao_bind(vao);
+	vbo_set_data(vbo, vertices, mesh->vertex_count * vertex_size);
+	ebo_set_data(ebo, indices, mesh->index_count * index_size);
+
+	switch (format) {
+	case VERTEX_FORMAT_PACKED:           vao_link_vbo_packed(); break;
+	case VERTEX_FORMAT_PACKED_QUANTIZED: vao_link_vbo_packed_quantized(); break;
+	default:                             vao_link_vbo_3f3f2f(); break;
+	}
+	buffer_unbind();
+
+	free(vertices);
+	free(indices);
+}
+
+void mesh_draw(mesh_t* mesh) {
+	mesh_draw_lod(mesh, 0);
+}
+
+void mesh_draw_lod(mesh_t* mesh, int lod) {
+	mesh_lod_t* level = &mesh->lods[lod];
+	size_t index_size = mesh->index_type == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	glDrawElements(GL_TRIANGLES, level->index_count, mesh->index_type, (void*)(level->index_offset * index_size));
+}
+
+void mesh_draw_lod_instanced(mesh_t* mesh, int lod, int instance_count) {
+	mesh_lod_t* level = &mesh->lods[lod];
+	size_t index_size = mesh->index_type == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	glDrawElementsInstanced(GL_TRIANGLES, level->index_count, mesh->index_type, (void*)(level->index_offset * index_size), instance_count);
+}
+
 void mesh_delete(mesh_t* mesh) {
 	free(mesh->vertices);
 	free(mesh->faces);
+	free(mesh->indices);
+	mesh_delete_meshlets(mesh);
 	free(mesh);
 }
+
+static uint16_t mesh_pack_half(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t mantissa = bits & 0x007FFFFF;
+	int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+
+	if (exponent <= 0) {
+		// Too small for a half, flush to zero or encode as subnormal
+		if (exponent < -10) {
+			return (uint16_t)sign;
+		}
+		mantissa |= 0x00800000;
+		int shift = 14 - exponent;
+		uint32_t half = mantissa >> shift;
+		half += (mantissa >> (shift - 1)) & 1; // round to nearest
+		return (uint16_t)(sign | half);
+	}
+	if (exponent >= 31) {
+		// Overflow becomes infinity, NaN stays NaN
+		bool nan = ((bits >> 23) & 0xFF) == 0xFF && mantissa != 0;
+		return (uint16_t)(sign | 0x7C00 | (nan ? 0x0200 : 0));
+	}
+
+	uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+	half += (mantissa >> 12) & 1; // round to nearest, carry may bump the exponent
+	return (uint16_t)half;
+}
+
+static void mesh_pack_oct(const vec3_t* normal, int16_t* out) {
+	// Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower hemisphere
+	float l1 = fabsf(normal->x) + fabsf(normal->y) + fabsf(normal->z);
+	if (l1 == 0.0f) {
+		out[0] = 0;
+		out[1] = 0;
+		return;
+	}
+
+	float x = normal->x / l1;
+	float y = normal->y / l1;
+	if (normal->z < 0.0f) {
+		float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = fx;
+		y = fy;
+	}
+	out[0] = (int16_t)lroundf(clampf(x, -1.0f, 1.0f) * 32767.0f);
+	out[1] = (int16_t)lroundf(clampf(y, -1.0f, 1.0f) * 32767.0f);
+}
@@ -0,0 +1,367 @@
+/**
+* @file de_mesh_lod.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_mesh.h"
+#include "../../include/de_math.h"
+
+#define QUADRIC_SIZE 10
+#define MESH_LOD_MIN_REDUCTION 0.9f // drop a level that keeps more than 90% of its parent
+#define MESH_LOD_HYSTERESIS 0.25f   // coarser level must fit 25% under the threshold
+
+// Quadric error metric simplifier (Garland & Heckbert), using half-edge collapses
+// so every level keeps indexing the original vertex buffer.
+typedef struct {
+	const vertex_t* vertices;
+	int vertex_count;
+
+	unsigned int* indices;
+	int index_count;
+
+	double* quadrics;      // symmetric 4x4 plane quadric per vertex, 10 unique terms
+	double* weights;       // accumulated triangle area per vertex
+	bool* locked;          // border and attribute seam vertices never move
+	unsigned int* remap;   // collapse target per vertex for the current pass
+	bool* touched;         // vertices whose 1-ring changed in the current pass
+	float error;           // worst collapse error so far
+} lod_state_t;
+
+typedef struct {
+	unsigned int from;
+	unsigned int to;
+	float cost;
+} lod_collapse_t;
+
+static void lod_state_init(lod_state_t* state, const mesh_t* mesh);
+static void lod_state_free(lod_state_t* state);
+static int lod_simplify(lod_state_t* state, int target_index_count);
+
+void mesh_build_lods(mesh_t* mesh, int lod_count, float ratio) {
+	mesh->lods[0].index_offset = 0;
+	mesh->lods[0].index_count = mesh->lods[0].index_count > 0 ? mesh->lods[0].index_count : mesh->index_count;
+	mesh->lods[0].error = 0.0f;
+	mesh->lod_count = 1;
+
+	if (lod_count > MESH_MAX_LODS) {
+		lod_count = MESH_MAX_LODS;
+	}
+	if (lod_count <= 1 || mesh->lods[0].index_count < 3) {
+		return;
+	}
+
+	lod_state_t state;
+	lod_state_init(&state, mesh);
+
+	for (int lod = 1; lod < lod_count; lod++) {
+		int previous_count = state.index_count;
+		int target_count = (int)(previous_count / 3 * ratio) * 3;
+		int index_count = lod_simplify(&state, target_count);
+
+		if (index_count == 0 || index_count > previous_count * MESH_LOD_MIN_REDUCTION) {
+			break;
+		}
+
+		// Append the level after the existing indices, all levels share one buffer
+		int offset = mesh->index_count;
+		unsigned int* indices = (unsigned int*)realloc(mesh->indices, sizeof(unsigned int) * (offset + index_count));
+		if (indices == NULL) {
+			fprintf(stderr, "failed to allocate memory for mesh lod.\n");
+			exit(EXIT_FAILURE);
+		}
+		memcpy(indices + offset, state.indices, sizeof(unsigned int) * index_count);
+		mesh->indices = indices;
+		mesh->index_count += index_count;
+
+		mesh_lod_t* level = &mesh->lods[lod];
+		level->index_offset = offset;
+		level->index_count = index_count;
+		level->error = state.error;
+		mesh->lod_count++;
+
+		int base_triangles = mesh->lods[0].index_count / 3;
+		printf("Mesh LOD %d: %d triangles (%.1f%% reduction), error %f\n",
+			lod, index_count / 3, 100.0f * (1.0f - (float)(index_count / 3) / base_triangles), level->error);
+	}
+
+	lod_state_free(&state);
+}
+
+int mesh_select_lod(const mesh_t* mesh, int current_lod, float distance, float scale, float pixels_per_unit) {
+	if (mesh->lod_count <= 1) {
+		return 0;
+	}
+
+	// Projected error in pixels for an object-space error at this distance
+	float projection = scale * pixels_per_unit / maxf(distance, 0.0001f);
+
+	int lod = 0;
+	for (int i = mesh->lod_count - 1; i > 0; i--) {
+		if (mesh->lods[i].error * projection <= MESH_LOD_THRESHOLD) {
+			lod = i;
+			break;
+		}
+	}
+
+	// Going coarser needs a margin, going finer happens as soon as the error shows
+	while (lod > current_lod && mesh->lods[lod].error * projection > MESH_LOD_THRESHOLD * (1.0f - MESH_LOD_HYSTERESIS)) {
+		lod--;
+	}
+	return lod;
+}
+
+static void lod_quadric_add_plane(double* q, double a, double b, double c, double d, double w) {
+	q[0] += w * a * a; q[1] += w * a * b; q[2] += w * a * c; q[3] += w * a * d;
+	q[4] += w * b * b; q[5] += w * b * c; q[6] += w * b * d;
+	q[7] += w * c * c; q[8] += w * c * d;
+	q[9] += w * d * d;
+}
+
+static double lod_quadric_eval(const double* q, const vec3_t* p) {
+	double x = p->x, y = p->y, z = p->z;
+	return q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+		+ q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+		+ q[7] * z * z + 2.0 * q[8] * z
+		+ q[9];
+}
+
+static vec3_t lod_triangle_normal(const vec3_t* a, const vec3_t* b, const vec3_t* c) {
+	vec3_t ab = vec3_sub(b, a);
+	vec3_t ac = vec3_sub(c, a);
+	return vec3_cross(&ab, &ac);
+}
+
+static int lod_compare_edges(const void* a, const void* b) {
+	uint64_t ea = *(const uint64_t*)a;
+	uint64_t eb = *(const uint64_t*)b;
+	return (ea > eb) - (ea < eb);
+}
+
+static int lod_compare_collapses(const void* a, const void* b) {
+	float ca = ((const lod_collapse_t*)a)->cost;
+	float cb = ((const lod_collapse_t*)b)->cost;
+	return (ca > cb) - (ca < cb);
+}
+
+static void* lod_alloc(size_t size) {
+	void* memory = calloc(1, size);
+	if (memory == NULL) {
+		fprintf(stderr, "failed to allocate memory for mesh lod.\n");
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+static void lod_state_init(lod_state_t* state, const mesh_t* mesh) {
+	int vertex_count = mesh->vertex_count;
+	int index_count = mesh->lods[0].index_count;
+
+	state->vertices = mesh->vertices;
+	state->vertex_count = vertex_count;
+	state->index_count = index_count;
+	state->error = 0.0f;
+
+	state->indices = (unsigned int*)lod_alloc(sizeof(unsigned int) * index_count);
+	state->quadrics = (double*)lod_alloc(sizeof(double) * QUADRIC_SIZE * vertex_count);
+	state->weights = (double*)lod_alloc(sizeof(double) * vertex_count);
+	state->locked = (bool*)lod_alloc(sizeof(bool) * vertex_count);
+	state->remap = (unsigned int*)lod_alloc(sizeof(unsigned int) * vertex_count);
+	state->touched = (bool*)lod_alloc(sizeof(bool) * vertex_count);
+	memcpy(state->indices, mesh->indices, sizeof(unsigned int) * index_count);
+
+	// Area weighted plane quadrics
+	for (int i = 0; i < index_count; i += 3) {
+		const vec3_t* p0 = &state->vertices[state->indices[i + 0]].position;
+		const vec3_t* p1 = &state->vertices[state->indices[i + 1]].position;
+		const vec3_t* p2 = &state->vertices[state->indices[i + 2]].position;
+
+		vec3_t normal = lod_triangle_normal(p0, p1, p2);
+		float length = vec3_magnitude(&normal);
+		if (length <= FLT_EPSILON) {
+			continue;
+		}
+		vec3_t n = vec3_div(&normal, length);
+		double area = 0.5 * length;
+		double d = -vec3_dot(&n, p0);
+
+		for (int k = 0; k < 3; k++) {
+			unsigned int v = state->indices[i + k];
+			lod_quadric_add_plane(&state->quadrics[v * QUADRIC_SIZE], n.x, n.y, n.z, d, area);
+			state->weights[v] += area;
+		}
+	}
+
+	// Edges used by a single triangle are borders; uv/normal seams show up the same way
+	// because welded vertices on each side of a seam have different indices.
+	uint64_t* edges = (uint64_t*)lod_alloc(sizeof(uint64_t) * index_count);
+	for (int i = 0; i < index_count; i += 3) {
+		for (int k = 0; k < 3; k++) {
+			uint64_t a = state->indices[i + k];
+			uint64_t b = state->indices[i + (k + 1) % 3];
+			edges[i + k] = a < b ? (a << 32) | b : (b << 32) | a;
+		}
+	}
+	qsort(edges, index_count, sizeof(uint64_t), lod_compare_edges);
+	for (int i = 0; i < index_count;) {
+		int j = i + 1;
+		while (j < index_count && edges[j] == edges[i]) {
+			j++;
+		}
+		if (j - i == 1) {
+			state->locked[edges[i] >> 32] = true;
+			state->locked[edges[i] & 0xFFFFFFFF] = true;
+		}
+		i = j;
+	}
+	free(edges);
+}
+
+static void lod_state_free(lod_state_t* state) {
+	free(state->indices);
+	free(state->quadrics);
+	free(state->weights);
+	free(state->locked);
+	free(state->remap);
+	free(state->touched);
+}
+
+static float lod_collapse_cost(const lod_state_t* state, unsigned int from, unsigned int to) {
+	double q[QUADRIC_SIZE];
+	for (int k = 0; k < QUADRIC_SIZE; k++) {
+		q[k] = state->quadrics[from * QUADRIC_SIZE + k] + state->quadrics[to * QUADRIC_SIZE + k];
+	}
+	double weight = state->weights[from] + state->weights[to];
+	double cost = lod_quadric_eval(q, &state->vertices[to].position);
+	return weight > 0.0 ? (float)(fabs(cost) / weight) : 0.0f;
+}
+
+static bool lod_collapse_flips(const lod_state_t* state, const int* offsets, const int* triangles, unsigned int from, unsigned int to) {
+	const vec3_t* target = &state->vertices[to].position;
+	for (int t = offsets[from]; t < offsets[from + 1]; t++) {
+		const unsigned int* tri = &state->indices[triangles[t] * 3];
+		if (tri[0] == to || tri[1] == to || tri[2] == to) {
+			continue; // this triangle disappears with the collapse
+		}
+
+		const vec3_t* p[3];
+		const vec3_t* q[3];
+		for (int k = 0; k < 3; k++) {
+			p[k] = &state->vertices[tri[k]].position;
+			q[k] = tri[k] == from ? target : p[k];
+		}
+		vec3_t before = lod_triangle_normal(p[0], p[1], p[2]);
+		vec3_t after = lod_triangle_normal(q[0], q[1], q[2]);
+		if (vec3_dot(&before, &after) <= 0.0f) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static int lod_simplify(lod_state_t* state, int target_index_count) {
+	int vertex_count = state->vertex_count;
+	int* offsets = (int*)lod_alloc(sizeof(int) * (vertex_count + 1));
+	int* triangles = (int*)lod_alloc(sizeof(int) * state->index_count);
+	lod_collapse_t* collapses = (lod_collapse_t*)lod_alloc(sizeof(lod_collapse_t) * state->index_count * 2);
+
+	while (state->index_count > target_index_count) {
+		int triangle_count = state->index_count / 3;
+
+		// Vertex to triangle adjacency for the current index list
+		memset(offsets, 0, sizeof(int) * (vertex_count + 1));
+		for (int i = 0; i < state->index_count; i++) {
+			offsets[state->indices[i] + 1]++;
+		}
+		for (int v = 0; v < vertex_count; v++) {
+			offsets[v + 1] += offsets[v];
+		}
+		for (int i = 0; i < state->index_count; i++) {
+			triangles[offsets[state->indices[i]]++] = i / 3;
+		}
+		for (int v = vertex_count; v > 0; v--) {
+			offsets[v] = offsets[v - 1];
+		}
+		offsets[0] = 0;
+
+		// Candidate collapses along every edge, both directions
+		int collapse_count = 0;
+		for (int i = 0; i < state->index_count; i += 3) {
+			for (int k = 0; k < 3; k++) {
+				unsigned int a = state->indices[i + k];
+				unsigned int b = state->indices[i + (k + 1) % 3];
+				if (!state->locked[a]) {
+					collapses[collapse_count++] = (lod_collapse_t){ a, b, lod_collapse_cost(state, a, b) };
+				}
+				if (!state->locked[b]) {
+					collapses[collapse_count++] = (lod_collapse_t){ b, a, lod_collapse_cost(state, b, a) };
+				}
+			}
+		}
+		if (collapse_count == 0) {
+			break;
+		}
+		qsort(collapses, collapse_count, sizeof(lod_collapse_t), lod_compare_collapses);
+
+		for (int v = 0; v < vertex_count; v++) {
+			state->remap[v] = (unsigned int)v;
+			state->touched[v] = false;
+		}
+
+		// Cheapest independent collapses first; each one removes about two triangles
+		int removed = 0;
+		int applied = 0;
+		int needed = triangle_count - target_index_count / 3;
+		for (int c = 0; c < collapse_count && removed < needed; c++) {
+			lod_collapse_t* collapse = &collapses[c];
+			if (state->touched[collapse->from] || state->touched[collapse->to]) {
+				continue;
+			}
+			if (lod_collapse_flips(state, offsets, triangles, collapse->from, collapse->to)) {
+				continue;
+			}
+
+			for (int t = offsets[collapse->from]; t < offsets[collapse->from + 1]; t++) {
+				const unsigned int* tri = &state->indices[triangles[t] * 3];
+				state->touched[tri[0]] = true;
+				state->touched[tri[1]] = true;
+				state->touched[tri[2]] = true;
+				if (tri[0] == collapse->to || tri[1] == collapse->to || tri[2] == collapse->to) {
+					removed++;
+				}
+			}
+
+			for (int k = 0; k < QUADRIC_SIZE; k++) {
+				state->quadrics[collapse->to * QUADRIC_SIZE + k] += state->quadrics[collapse->from * QUADRIC_SIZE + k];
+			}
+			state->weights[collapse->to] += state->weights[collapse->from];
+			state->remap[collapse->from] = collapse->to;
+			state->error = maxf(state->error, sqrtf(collapse->cost));
+			applied++;
+		}
+		if (applied == 0) {
+			break;
+		}
+
+		// Rewrite the index list and drop the triangles that became degenerate
+		int write = 0;
+		for (int i = 0; i < state->index_count; i += 3) {
+			unsigned int a = state->remap[state->indices[i + 0]];
+			unsigned int b = state->remap[state->indices[i + 1]];
+			unsigned int c = state->remap[state->indices[i + 2]];
+			if (a != b && b != c && a != c) {
+				state->indices[write++] = a;
+				state->indices[write++] = b;
+				state->indices[write++] = c;
+			}
+		}
+		state->index_count = write;
+	}
+
+	free(offsets);
+	free(triangles);
+	free(collapses);
+	return state->index_count;
+}
@@ -0,0 +1,147 @@
+/**
+* @file de_mesh_manager.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_collection.h"
+#include "../../include/de_mesh_manager.h"
+
+// Slots hold pointers so a shared_mesh_t never moves while the list grows,
+// released slots are set to NULL and reused by the next acquire.
+static list_t meshes;
+static bool initialized = false;
+
+static shared_mesh_t* mesh_mgr_slot(mesh_handle_t handle) {
+	return *(shared_mesh_t**)list_get(&meshes, (size_t)handle);
+}
+
+static mesh_handle_t mesh_mgr_find(const char* path, vertex_format_t format) {
+	for (size_t i = 0; i < list_size(&meshes); i++) {
+		shared_mesh_t* shared = mesh_mgr_slot((mesh_handle_t)i);
+		if (shared != NULL && shared->format == format && strcmp(shared->path, path) == 0) {
+			return (mesh_handle_t)i;
+		}
+	}
+	return MESH_HANDLE_INVALID;
+}
+
+static mesh_handle_t mesh_mgr_insert(shared_mesh_t* shared) {
+	for (size_t i = 0; i < list_size(&meshes); i++) {
+		shared_mesh_t** slot = (shared_mesh_t**)list_get(&meshes, i);
+		if (*slot == NULL) {
+			*slot = shared;
+			return (mesh_handle_t)i;
+		}
+	}
+	list_add(&meshes, &shared);
+	return (mesh_handle_t)(list_size(&meshes) - 1);
+}
+
+static void mesh_mgr_init(void) {
+	if (!initialized) {
+		list_init(&meshes, sizeof(shared_mesh_t*));
+		initialized = true;
+	}
+}
+
+static mesh_handle_t mesh_mgr_share(const char* path, mesh_t* mesh, vertex_format_t format) {
+	shared_mesh_t* shared = (shared_mesh_t*)malloc(sizeof(shared_mesh_t));
+	char* key = (char*)malloc(strlen(path) + 1);
+	if (shared == NULL || key == NULL) {
+		fprintf(stderr, "failed to allocate memory for shared mesh.\n");
+		exit(EXIT_FAILURE);
+	}
+	strcpy(key, path);
+
+	shared->path = key;
+	shared->format = format;
+	shared->ref_count = 1;
+	shared->mesh = mesh;
+
+	buffer_init(&shared->vao, &shared->vbo, &shared->ebo);
+	mesh_upload(shared->mesh, &shared->vao, &shared->vbo, &shared->ebo, format);
+
+	return mesh_mgr_insert(shared);
+}
+
+mesh_handle_t mesh_mgr_acquire(const char* path, vertex_format_t format) {
+	mesh_mgr_init();
+
+	mesh_handle_t handle = mesh_mgr_find(path, format);
+	if (handle != MESH_HANDLE_INVALID) {
+		mesh_mgr_slot(handle)->ref_count++;
+		return handle;
+	}
+
+	// Nothing was allocated inside a mesh that failed to load, the struct is all there is to free
+	mesh_t* mesh = mesh_new();
+	if (!mesh_load_obj(mesh, path)) {
+		fprintf(stderr, "failed to load mesh: %s.\n", path);
+		free(mesh);
+		return MESH_HANDLE_INVALID;
+	}
+	return mesh_mgr_share(path, mesh, format);
+}
+
+// A mesh built in memory, uploaded and owned by the manager from here on. Adopting never
+// shares, the name only has to differ from every model file acquire may look for.
+mesh_handle_t mesh_mgr_adopt(const char* name, mesh_t* mesh, vertex_format_t format) {
+	mesh_mgr_init();
+	return mesh_mgr_share(name, mesh, format);
+}
+
+void mesh_mgr_retain(mesh_handle_t handle) {
+	mesh_mgr_get(handle)->ref_count++;
+}
+
+void mesh_mgr_release(mesh_handle_t handle) {
+	shared_mesh_t* shared = mesh_mgr_get(handle);
+	if (--shared->ref_count > 0) {
+		return;
+	}
+
+	buffer_delete(&shared->vao, &shared->vbo, &shared->ebo);
+	mesh_delete(shared->mesh);
+	free(shared->path);
+	free(shared);
+	*(shared_mesh_t**)list_get(&meshes, (size_t)handle) = NULL;
+}
+
+shared_mesh_t* mesh_mgr_get(mesh_handle_t handle) {
+	shared_mesh_t* shared = NULL;
+	if (initialized && handle >= 0 && (size_t)handle < list_size(&meshes)) {
+		shared = mesh_mgr_slot(handle);
+	}
+	if (shared == NULL) {
+		fprintf(stderr, "invalid mesh handle %d.\n", handle);
+		exit(EXIT_FAILURE);
+	}
+	return shared;
+}
+
+void mesh_mgr_bind(mesh_handle_t handle) {
+	shared_mesh_t* shared = mesh_mgr_get(handle);
+	buffer_bind(&shared->vao, &shared->vbo, &shared->ebo);
+}
+
+// Instance attributes live on the shared vertex array next to the vertex ones,
+// programs without DE_INSTANCED never read them
+void mesh_mgr_bind_instances(mesh_handle_t handle, stream_buffer_t* instances, GLintptr offset) {
+	shared_mesh_t* shared = mesh_mgr_get(handle);
+	vao_bind(&shared->vao);
+	stream_buffer_bind(instances);
+	vao_link_vbo_instances(offset);
+}
+
+int mesh_mgr_count(void) {
+	int count = 0;
+	if (initialized) {
+		for (size_t i = 0; i < list_size(&meshes); i++) {
+			count += mesh_mgr_slot((mesh_handle_t)i) != NULL;
+		}
+	}
+	return count;
+}
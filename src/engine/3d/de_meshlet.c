@@ -0,0 +1,285 @@
+/**
+* @file de_meshlet.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_mesh.h"
+#include "../../include/de_math.h"
+#include "../../include/de_frustum.h"
+
+#define MESHLET_CONE_MIN_DOT 0.1f // wider cones almost never cull, skip the test
+
+static void* meshlet_alloc(size_t size) {
+	void* memory = malloc(size);
+	if (memory == NULL) {
+		fprintf(stderr, "failed to allocate memory for meshlets.\n");
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+static void meshlet_compute_bounds(const mesh_t* mesh, meshlet_t* meshlet) {
+	const unsigned int* indices = &mesh->indices[meshlet->index_offset];
+
+	vec3_t min = vec3_new(FLT_MAX, FLT_MAX, FLT_MAX);
+	vec3_t max = vec3_new(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (int i = 0; i < meshlet->index_count; i++) {
+		const vec3_t* p = &mesh->vertices[indices[i]].position;
+		for (int axis = 0; axis < VEC3; axis++) {
+			min.as_array[axis] = minf(min.as_array[axis], p->as_array[axis]);
+			max.as_array[axis] = maxf(max.as_array[axis], p->as_array[axis]);
+		}
+	}
+
+	vec3_t sum = vec3_add(&min, &max);
+	meshlet->center = vec3_mul(&sum, 0.5f);
+	meshlet->radius = 0.0f;
+	for (int i = 0; i < meshlet->index_count; i++) {
+		vec3_t offset = vec3_sub(&mesh->vertices[indices[i]].position, &meshlet->center);
+		meshlet->radius = maxf(meshlet->radius, vec3_magnitude(&offset));
+	}
+
+	// Normal cone from the face normals, as authored (counter-clockwise is outward)
+	vec3_t axis = vec3_zero();
+	for (int i = 0; i < meshlet->index_count; i += 3) {
+		vec3_t ab = vec3_sub(&mesh->vertices[indices[i + 1]].position, &mesh->vertices[indices[i]].position);
+		vec3_t ac = vec3_sub(&mesh->vertices[indices[i + 2]].position, &mesh->vertices[indices[i]].position);
+		vec3_t normal = vec3_cross(&ab, &ac);
+		float length = vec3_magnitude(&normal);
+		if (length > FLT_EPSILON) {
+			normal = vec3_div(&normal, length);
+			axis = vec3_add(&axis, &normal);
+		}
+	}
+
+	meshlet->cone_axis = vec3_zero();
+	meshlet->cone_cutoff = 1.0f;
+	float axis_length = vec3_magnitude(&axis);
+	if (axis_length <= FLT_EPSILON) {
+		return;
+	}
+	axis = vec3_div(&axis, axis_length);
+
+	float min_dot = 1.0f;
+	for (int i = 0; i < meshlet->index_count; i += 3) {
+		vec3_t ab = vec3_sub(&mesh->vertices[indices[i + 1]].position, &mesh->vertices[indices[i]].position);
+		vec3_t ac = vec3_sub(&mesh->vertices[indices[i + 2]].position, &mesh->vertices[indices[i]].position);
+		vec3_t normal = vec3_cross(&ab, &ac);
+		float length = vec3_magnitude(&normal);
+		if (length > FLT_EPSILON) {
+			min_dot = minf(min_dot, vec3_dot(&normal, &axis) / length);
+		}
+	}
+
+	meshlet->cone_axis = axis;
+	if (min_dot > MESHLET_CONE_MIN_DOT) {
+		meshlet->cone_cutoff = sqrtf(1.0f - min_dot * min_dot);
+	}
+}
+
+void mesh_build_meshlets(mesh_t* mesh) {
+	mesh_delete_meshlets(mesh);
+
+	int index_count = mesh->lods[0].index_count;
+	int triangle_count = index_count / 3;
+	int vertex_count = mesh->vertex_count;
+	unsigned int* indices = &mesh->indices[mesh->lods[0].index_offset];
+	if (triangle_count == 0) {
+		return;
+	}
+
+	// Vertex to triangle adjacency
+	int* offsets = (int*)calloc(vertex_count + 1, sizeof(int));
+	int* adjacency = (int*)meshlet_alloc(sizeof(int) * index_count);
+	int* tags = (int*)meshlet_alloc(sizeof(int) * vertex_count);
+	bool* emitted = (bool*)calloc(triangle_count, sizeof(bool));
+	unsigned int* reordered = (unsigned int*)meshlet_alloc(sizeof(unsigned int) * index_count);
+	meshlet_t* meshlets = (meshlet_t*)meshlet_alloc(sizeof(meshlet_t) * triangle_count);
+	if (offsets == NULL || emitted == NULL) {
+		fprintf(stderr, "failed to allocate memory for meshlets.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int i = 0; i < index_count; i++) {
+		offsets[indices[i] + 1]++;
+	}
+	for (int v = 0; v < vertex_count; v++) {
+		offsets[v + 1] += offsets[v];
+		tags[v] = -1;
+	}
+	for (int i = 0; i < index_count; i++) {
+		adjacency[offsets[indices[i]]++] = i / 3;
+	}
+	for (int v = vertex_count; v > 0; v--) {
+		offsets[v] = offsets[v - 1];
+	}
+	offsets[0] = 0;
+
+	// Grow each cluster from a seed, always taking the neighbouring triangle that adds
+	// the fewest new vertices, until the vertex or triangle budget is spent.
+	unsigned int local_vertices[MESHLET_MAX_VERTICES];
+	int meshlet_count = 0;
+	int written = 0;
+	int seed = 0;
+
+	while (true) {
+		while (seed < triangle_count && emitted[seed]) {
+			seed++;
+		}
+		if (seed == triangle_count) {
+			break;
+		}
+
+		meshlet_t* meshlet = &meshlets[meshlet_count];
+		meshlet->index_offset = mesh->lods[0].index_offset + written;
+		meshlet->vertex_count = 0;
+		int meshlet_triangles = 0;
+		int triangle = seed;
+
+		while (triangle >= 0) {
+			const unsigned int* tri = &indices[triangle * 3];
+			for (int k = 0; k < 3; k++) {
+				if (tags[tri[k]] != meshlet_count) {
+					tags[tri[k]] = meshlet_count;
+					local_vertices[meshlet->vertex_count++] = tri[k];
+				}
+				reordered[written++] = tri[k];
+			}
+			emitted[triangle] = true;
+			meshlet_triangles++;
+
+			if (meshlet_triangles == MESHLET_MAX_TRIANGLES) {
+				break;
+			}
+
+			int best = -1;
+			int best_cost = 4;
+			for (int v = 0; v < meshlet->vertex_count && best_cost > 0; v++) {
+				unsigned int vertex = local_vertices[v];
+				for (int a = offsets[vertex]; a < offsets[vertex + 1]; a++) {
+					int candidate = adjacency[a];
+					if (emitted[candidate]) {
+						continue;
+					}
+					const unsigned int* c = &indices[candidate * 3];
+					int cost = (tags[c[0]] != meshlet_count) + (tags[c[1]] != meshlet_count) + (tags[c[2]] != meshlet_count);
+					if (cost < best_cost && meshlet->vertex_count + cost <= MESHLET_MAX_VERTICES) {
+						best = candidate;
+						best_cost = cost;
+						if (cost == 0) {
+							break;
+						}
+					}
+				}
+			}
+			triangle = best;
+		}
+
+		meshlet->index_count = meshlet_triangles * 3;
+		meshlet_count++;
+	}
+
+	memcpy(indices, reordered, sizeof(unsigned int) * index_count);
+
+	mesh->meshlets = (meshlet_t*)realloc(meshlets, sizeof(meshlet_t) * meshlet_count);
+	mesh->meshlet_count = meshlet_count;
+	for (int i = 0; i < meshlet_count; i++) {
+		meshlet_compute_bounds(mesh, &mesh->meshlets[i]);
+	}
+
+	mesh->meshlet_draws.counts = (GLsizei*)meshlet_alloc(sizeof(GLsizei) * meshlet_count);
+	mesh->meshlet_draws.offsets = (const GLvoid**)meshlet_alloc(sizeof(GLvoid*) * meshlet_count);
+	mesh->meshlet_draws.range_count = 0;
+	mesh->meshlet_draws.visible_count = 0;
+
+	printf("Mesh meshlets: %d clusters for %d triangles\n", meshlet_count, triangle_count);
+
+	free(offsets);
+	free(adjacency);
+	free(tags);
+	free(emitted);
+	free(reordered);
+}
+
+void mesh_cull_meshlets(mesh_t* mesh, const mat4_t* model, const mat4_t* view_projection, const vec3_t* eye) {
+	mesh_cull_meshlets_into(mesh, model, view_projection, eye, &mesh->meshlet_draws);
+}
+
+// Reads the mesh only, threads culling the same mesh each bring their own list.
+// The arrays of the list hold at least meshlet_count ranges.
+void mesh_cull_meshlets_into(const mesh_t* mesh, const mat4_t* model, const mat4_t* view_projection, const vec3_t* eye, meshlet_draw_list_t* draws) {
+	draws->range_count = 0;
+	draws->visible_count = 0;
+	if (mesh->meshlet_count == 0) {
+		return;
+	}
+
+	// Cull in object space: the frustum comes straight from the model-view-projection
+	// and the eye is moved by the inverse model matrix, so no per-cluster transforms.
+	mat4_t mvp = mat4_mul_mat4(view_projection, model);
+	frustum_t frustum = frustum_from_matrix(&mvp);
+
+	mat4_t inverse_model;
+	vec3_t local_eye = *eye;
+	// A mirroring transform flips the winding, the cones would point the wrong way
+	bool cone_culling = mat4_determinant(model) > 0.0f && mat4_inverse(model, &inverse_model);
+	if (cone_culling) {
+		vec4_t world_eye = vec4_new(eye->x, eye->y, eye->z, 1.0f);
+		vec4_t object_eye = mat4_mul_vec4(&inverse_model, &world_eye);
+		local_eye = vec3_new(object_eye.x, object_eye.y, object_eye.z);
+	}
+
+	size_t index_size = mesh->index_type == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	int range_end = -1;
+
+	for (int i = 0; i < mesh->meshlet_count; i++) {
+		const meshlet_t* meshlet = &mesh->meshlets[i];
+
+		if (!frustum_test_sphere(&frustum, &meshlet->center, meshlet->radius)) {
+			continue;
+		}
+
+		// Every triangle faces away when the view direction stays inside the cone
+		if (cone_culling && meshlet->cone_cutoff < 1.0f) {
+			vec3_t view = vec3_sub(&meshlet->center, &local_eye);
+			float distance = vec3_magnitude(&view);
+			if (vec3_dot(&view, &meshlet->cone_axis) >= meshlet->cone_cutoff * distance + meshlet->radius * (1.0f + meshlet->cone_cutoff)) {
+				continue;
+			}
+		}
+
+		// Neighbouring clusters are contiguous in the index buffer, merge their ranges
+		if (meshlet->index_offset == range_end) {
+			draws->counts[draws->range_count - 1] += meshlet->index_count;
+		}
+		else {
+			draws->counts[draws->range_count] = meshlet->index_count;
+			draws->offsets[draws->range_count] = (const GLvoid*)(meshlet->index_offset * index_size);
+			draws->range_count++;
+		}
+		range_end = meshlet->index_offset + meshlet->index_count;
+		draws->visible_count++;
+	}
+}
+
+void mesh_draw_meshlets(mesh_t* mesh) {
+	mesh_draw_meshlet_list(mesh, &mesh->meshlet_draws);
+}
+
+void mesh_draw_meshlet_list(const mesh_t* mesh, const meshlet_draw_list_t* draws) {
+	if (draws->range_count > 0) {
+		glMultiDrawElements(GL_TRIANGLES, draws->counts, mesh->index_type, draws->offsets, draws->range_count);
+	}
+}
+
+void mesh_delete_meshlets(mesh_t* mesh) {
+	free(mesh->meshlets);
+	free(mesh->meshlet_draws.counts);
+	free(mesh->meshlet_draws.offsets);
+	mesh->meshlets = NULL;
+	mesh->meshlet_count = 0;
+	mesh->meshlet_draws = (meshlet_draw_list_t){ 0 };
+}
@@ -6,9 +6,88 @@
 * Dodoi-Engine is a game engine developed by Dodoi-Lab.
 * @copyright Copyright (c) 2024, Dodoi-Lab
 */
+#include "../../include/de_util.h"
 #include "../../include/de_program.h"
+#include "../../include/de_gl_state.h"
 #include "../../include/de_collection.h"
 
+#define PROGRAM_BINARY_MAGIC 0x47525044u // "DPRG"
+#define PROGRAM_BINARY_VERSION 1
+
+// A binary is only good for the exact sources and driver that produced it
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t source_hash;
+	uint64_t driver_hash;
+	GLenum format;
+	GLint length;
+} program_binary_header_t;
+
+static uint64_t program_driver_hash(void) {
+	const GLubyte* strings[] = { glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION) };
+	uint64_t hash = HASH_SEED;
+	for (int i = 0; i < 3; i++) {
+		if (strings[i] != NULL) {
+			hash = hash_bytes(strings[i], strlen((const char*)strings[i]) + 1, hash);
+		}
+	}
+	return hash;
+}
+
+static void program_table_init(program_table_t* table, GLint count) {
+	// At most half full, probes stay short
+	uint32_t capacity = 8;
+	while (capacity < (uint32_t)count * 2) {
+		capacity *= 2;
+	}
+	table->symbols = (program_symbol_t*)calloc(capacity, sizeof(program_symbol_t));
+	if (table->symbols == NULL) {
+		fprintf(stderr, "failed to allocate memory for program reflection.\n");
+		exit(EXIT_FAILURE);
+	}
+	table->mask = capacity - 1;
+}
+
+static void program_table_free(program_table_t* table) {
+	free(table->symbols);
+	table->symbols = NULL;
+	table->mask = 0;
+}
+
+static void program_table_insert(program_table_t* table, const GLchar* name, GLint location, GLenum type, GLint size) {
+	uint32_t hash = hash_name(name);
+	uint32_t slot = hash & table->mask;
+	while (table->symbols[slot].type != 0) {
+		if (table->symbols[slot].hash == hash) {
+			fprintf(stderr, "shader symbol %s collides with another name, rename one of them.\n", name);
+			return;
+		}
+		slot = (slot + 1) & table->mask;
+	}
+	table->symbols[slot] = (program_symbol_t){ hash, location, type, size };
+}
+
+// Arrays are reported as "name[0]", they are also found under "name"
+static void program_table_insert_array(program_table_t* table, GLchar* name, GLint location, GLenum type, GLint size) {
+	program_table_insert(table, name, location, type, size);
+	GLchar* subscript = strstr(name, "[0]");
+	if (subscript != NULL && subscript[3] == '\0') {
+		*subscript = '\0';
+		program_table_insert(table, name, location, type, size);
+	}
+}
+
+// Shared blocks sit at fixed binding points, their buffers are bound once for every program
+static void program_bind_block(program_t* program, GLuint index, uint32_t name_hash) {
+	if (name_hash == NAME_HASH(FRAME_BLOCK)) {
+		glUniformBlockBinding(program->id, index, FRAME_BINDING);
+	}
+	else if (name_hash == NAME_HASH(MATERIAL_BLOCK)) {
+		glUniformBlockBinding(program->id, index, MATERIAL_BINDING);
+	}
+}
+
 program_t* program_new(void) {
 	program_t* program = (program_t*)malloc(sizeof(program_t));
 	if (program == NULL) {
@@ -20,6 +99,9 @@ program_t* program_new(void) {
 }
 
 void program_init(program_t* program) {
+	program->uniforms = (program_table_t){ NULL, 0 };
+	program->attributes = (program_table_t){ NULL, 0 };
+	program->blocks = (program_table_t){ NULL, 0 };
 	program->id = glCreateProgram();
 	if (program->id == 0) {
 		fprintf(stderr, "failed to create program.\n");
@@ -27,141 +109,174 @@ void program_init(program_t* program) {
 }
 
 bool program_compile(program_t* program, const GLchar* vertex_path, const GLchar* fragment_path) {
-	shader_t* vertex_shader = shader_new();
-	shader_t* fragment_shader = shader_new();
-	shader_init_vert_shader(vertex_shader);
-	shader_init_frag_shader(fragment_shader);
+	return program_compile_defines(program, vertex_path, fragment_path, NULL);
+}
 
-	if (!shader_compile(vertex_shader, vertex_path)) {
-		fprintf(stderr, "failed to compile vertex shader: %s\n", vertex_path);
+bool program_compile_defines(program_t* program, const GLchar* vertex_path, const GLchar* fragment_path, const GLchar* defines) {
+	program_build_t build;
+	if (!program_build_begin(&build, program, vertex_path, fragment_path, defines) || !program_build_end(&build)) {
+		fprintf(stderr, "failed to build program: %s, %s\n", vertex_path, fragment_path);
 		return false;
 	}
-	if (!shader_compile(fragment_shader, fragment_path)) {
-		fprintf(stderr, "failed to compile fragment shader: %s\n", fragment_path);
-		return false;
+	return true;
+}
+
+bool program_parallel_compile_supported(void) {
+	return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
+void program_set_max_compiler_threads(GLuint count) {
+	if (GLAD_GL_KHR_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsKHR(count);
 	}
-	if (!program_link(program, vertex_shader, fragment_shader)) {
-		fprintf(stderr, "failed to link program: %d\n", program->id);
-		return false;
+	else if (GLAD_GL_ARB_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsARB(count);
 	}
+}
+
+bool program_build_begin(program_build_t* build, program_t* program, const GLchar* vertex_path, const GLchar* fragment_path, const GLchar* defines) {
+	build->program = program;
+	shader_init_vert_shader(&build->vertex_shader);
+	shader_init_frag_shader(&build->fragment_shader);
 
-	program_detach_shader(program, vertex_shader);
-	program_detach_shader(program, fragment_shader);
-	shader_delete(vertex_shader);
-	shader_delete(fragment_shader);
+	if (!shader_compile_begin(&build->vertex_shader, vertex_path, defines)
+		|| !shader_compile_begin(&build->fragment_shader, fragment_path, defines)) {
+		shader_delete(&build->vertex_shader);
+		shader_delete(&build->fragment_shader);
+		return false;
+	}
 
+	// No status query in between: the link queues behind the compiles instead of waiting on them
+	program_link_begin(program, &build->vertex_shader, &build->fragment_shader);
 	return true;
 }
 
-bool program_save_binary(program_t* program, const char* binary_path) {
-	GLenum binary_format = program_get_supported_bin_formats();
-	if (binary_format == 0) {
-		fprintf(stderr, "no binary files supported by the driver\n");
+bool program_build_is_done(const program_build_t* build) {
+	// Without the extension there is no way to ask, finishing the build blocks as it always did
+	if (!program_parallel_compile_supported()) {
+		return true;
+	}
+	GLint done = GL_FALSE;
+	glGetProgramiv(build->program->id, GL_COMPLETION_STATUS_KHR, &done);
+	return done == GL_TRUE;
+}
+
+bool program_build_end(program_build_t* build) {
+	// Both logs are worth reading when both stages are broken
+	bool compiled = shader_compile_end(&build->vertex_shader);
+	compiled = shader_compile_end(&build->fragment_shader) && compiled;
+	bool linked = compiled && program_link_end(build->program);
+
+	program_detach_shader(build->program, &build->vertex_shader);
+	program_detach_shader(build->program, &build->fragment_shader);
+	shader_delete(&build->vertex_shader);
+	shader_delete(&build->fragment_shader);
+	return linked;
+}
+
+bool program_save_binary(program_t* program, const char* binary_path, uint64_t source_hash) {
+	if (program_get_supported_bin_formats() == 0) {
 		return false;
 	}
 
-	// Get the length of the binary
-	GLint binary_length = 0;
-	glGetProgramiv(program->id, GL_PROGRAM_BINARY_LENGTH, &binary_length);
-	if (binary_length == 0) {
+	program_binary_header_t header = { PROGRAM_BINARY_MAGIC, PROGRAM_BINARY_VERSION, source_hash, program_driver_hash(), 0, 0 };
+	glGetProgramiv(program->id, GL_PROGRAM_BINARY_LENGTH, &header.length);
+	if (header.length == 0) {
 		fprintf(stderr, "failed to get program binary length.\n");
 		return false;
 	}
 
-	// Allocate memory for the binary
-	GLvoid* binary = malloc(binary_length);
+	GLvoid* binary = malloc(header.length);
 	if (binary == NULL) {
 		fprintf(stderr, "failed to allocate memory for program binary.\n");
 		return false;
 	}
+	glGetProgramBinary(program->id, header.length, NULL, &header.format, binary);
 
-	// Get the binary data
-	glGetProgramBinary(program->id, binary_length, NULL, &binary_format, binary);
-
-	// Open the file for writing
 	FILE* file = fopen(binary_path, "wb");
 	if (file == NULL) {
 		fprintf(stderr, "failed to open file for writing: %s.\n", binary_path);
 		free(binary);
 		return false;
 	}
-
-	// Write the binary format and length to the file
-	fwrite(&binary_format, sizeof(GLenum), 1, file);
-	fwrite(&binary_length, sizeof(GLint), 1, file);
-
-	// Write the binary data to the file
-	fwrite(binary, 1, binary_length, file);
-
-	// Clean up
+	bool written = fwrite(&header, sizeof(program_binary_header_t), 1, file) == 1
+		&& fwrite(binary, 1, header.length, file) == (size_t)header.length;
 	fclose(file);
 	free(binary);
 
-	return true;
+	if (!written) {
+		fprintf(stderr, "failed to write program binary: %s.\n", binary_path);
+		remove(binary_path);
+	}
+	return written;
 }
 
-program_t* program_load_binary(const char* binary_path) {
-	GLenum binary_format = program_get_supported_bin_formats();
-	if (binary_format == 0) {
-		fprintf(stderr, "no binary files supported by the driver\n");
+bool program_load_binary(program_t* program, const char* binary_path, uint64_t source_hash) {
+	FILE* file = fopen(binary_path, "rb");
+	if (file == NULL) {
 		return false;
 	}
 
-	// Open the file for reading
-	FILE* file = fopen(binary_path, "rb");
-	if (file == NULL) {
-		fprintf(stderr, "failed to open file for reading: %s.\n", binary_path);
-		return NULL;
+	// Sources edited, driver updated or a file from another machine: the caller recompiles
+	program_binary_header_t header;
+	if (fread(&header, sizeof(program_binary_header_t), 1, file) != 1
+		|| header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION
+		|| header.source_hash != source_hash || header.driver_hash != program_driver_hash()
+		|| header.length <= 0) {
+		fclose(file);
+		return false;
 	}
 
-	// Read the binary format and length from the file
-	GLint binary_length;
-	fread(&binary_format, sizeof(GLenum), 1, file);
-	fread(&binary_length, sizeof(GLint), 1, file);
-	
-	// Allocate memory for the binary
-	GLvoid* binary = malloc(binary_length);
+	GLvoid* binary = malloc(header.length);
 	if (binary == NULL) {
 		fprintf(stderr, "failed to allocate memory for program binary.\n");
 		fclose(file);
-		return NULL;
+		return false;
 	}
-
-	// Read the binary data from the file
-	fread(binary, 1, binary_length, file);
-
-	// Create a new program
-	program_t* program = program_new();
-	program_init(program);
-	
-	// Load the binary data into the program
-	glProgramBinary(program->id, binary_format, binary, binary_length);
-	
-	// Clean up
+	bool read = fread(binary, 1, header.length, file) == (size_t)header.length;
 	fclose(file);
+
+	// The driver may still refuse it, that shows up as a failed link
+	GLint linked = GL_FALSE;
+	if (read) {
+		glProgramBinary(program->id, header.format, binary, header.length);
+		glGetProgramiv(program->id, GL_LINK_STATUS, &linked);
+	}
 	free(binary);
-	return program;
+	if (linked == GL_TRUE) {
+		program_reflect(program);
+	}
+	return linked == GL_TRUE;
 }
 
 bool program_link(program_t* program, shader_t* vertex_shader, shader_t* fragment_shader) {
+	program_link_begin(program, vertex_shader, fragment_shader);
+	return program_link_end(program);
+}
+
+void program_link_begin(program_t* program, shader_t* vertex_shader, shader_t* fragment_shader) {
 	glAttachShader(program->id, vertex_shader->id);
 	glAttachShader(program->id, fragment_shader->id);
+	glProgramParameteri(program->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(program->id);
-	
+}
+
+bool program_link_end(program_t* program) {
 	// Check for linking errors
 	GLint result;
 	glGetProgramiv(program->id, GL_LINK_STATUS, &result);
 	if (result != GL_TRUE) {
 		GLint info_log_length;
-		glGetShaderiv(program->id, GL_INFO_LOG_LENGTH, &info_log_length);
+		glGetProgramiv(program->id, GL_INFO_LOG_LENGTH, &info_log_length);
 
 		GLchar* info_log = malloc(info_log_length);
-		glGetShaderInfoLog(program->id, info_log_length, NULL, info_log);
+		glGetProgramInfoLog(program->id, info_log_length, NULL, info_log);
 
-		fprintf(stderr, "failed to compile shader: %s.\n", info_log);
+		fprintf(stderr, "failed to link program: %s.\n", info_log);
 		free(info_log);
 		return false;
 	}
+	program_reflect(program);
 	return true;
 }
 
@@ -179,20 +294,26 @@ GLenum program_get_supported_bin_formats(void) {
 		return 0;
 	}
 
-	glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, (GLenum*)formats);
-	return formats[0]; // Return the first supported format
+	glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, (GLint*)formats);
+	GLenum format = formats[0]; // Return the first supported format
+	free(formats);
+	return format;
 }
 
 void program_set(program_t* program) {
-	glUseProgram(program->id);
+	gl_state_use_program(program->id);
 }
 
 void program_unset(void) {
-	glUseProgram(0);
+	gl_state_use_program(0);
 }
 
 void program_delete(program_t* program) {
+	gl_state_forget_program(program->id);
 	glDeleteProgram(program->id);
+	program_table_free(&program->uniforms);
+	program_table_free(&program->attributes);
+	program_table_free(&program->blocks);
 }
 
 void program_destroy(program_t* program) {
@@ -204,46 +325,158 @@ void program_detach_shader(program_t* program, shader_t* shader) {
 	glDetachShader(program->id, shader->id);
 }
 
+void program_reflect(program_t* program) {
+	program_table_free(&program->uniforms);
+	program_table_free(&program->attributes);
+	program_table_free(&program->blocks);
+
+	GLint uniform_count = 0, attribute_count = 0, block_count = 0, max_length = 1, length;
+	glGetProgramiv(program->id, GL_ACTIVE_UNIFORMS, &uniform_count);
+	glGetProgramiv(program->id, GL_ACTIVE_ATTRIBUTES, &attribute_count);
+	glGetProgramiv(program->id, GL_ACTIVE_UNIFORM_BLOCKS, &block_count);
+	glGetProgramiv(program->id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length);
+	max_length = length > max_length ? length : max_length;
+	glGetProgramiv(program->id, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length);
+	max_length = length > max_length ? length : max_length;
+	glGetProgramiv(program->id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &length);
+	max_length = length > max_length ? length : max_length;
+
+	GLchar* name = (GLchar*)malloc(max_length);
+	if (name == NULL) {
+		fprintf(stderr, "failed to allocate memory for program reflection.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// The only string lookups the program ever sees, one per symbol at link time
+	program_table_init(&program->uniforms, uniform_count * 2);
+	for (GLint i = 0; i < uniform_count; i++) {
+		GLint size;
+		GLenum type;
+		glGetActiveUniform(program->id, (GLuint)i, max_length, NULL, &size, &type, name);
+		GLint location = glGetUniformLocation(program->id, name);
+		if (location >= 0) { // block members have no location, they are set through the block
+			program_table_insert_array(&program->uniforms, name, location, type, size);
+		}
+	}
+
+	program_table_init(&program->attributes, attribute_count * 2);
+	for (GLint i = 0; i < attribute_count; i++) {
+		GLint size;
+		GLenum type;
+		glGetActiveAttrib(program->id, (GLuint)i, max_length, NULL, &size, &type, name);
+		GLint location = glGetAttribLocation(program->id, name);
+		if (location >= 0) { // built-ins such as gl_VertexID
+			program_table_insert_array(&program->attributes, name, location, type, size);
+		}
+	}
+
+	program_table_init(&program->blocks, block_count);
+	for (GLint i = 0; i < block_count; i++) {
+		GLint size;
+		glGetActiveUniformBlockName(program->id, (GLuint)i, max_length, NULL, name);
+		glGetActiveUniformBlockiv(program->id, (GLuint)i, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+		program_table_insert(&program->blocks, name, i, GL_UNIFORM_BLOCK, size);
+		program_bind_block(program, (GLuint)i, hash_name(name));
+	}
+
+	free(name);
+}
+
+const program_symbol_t* program_find_symbol(const program_table_t* table, uint32_t name_hash) {
+	if (table->symbols == NULL) {
+		return NULL;
+	}
+	uint32_t slot = name_hash & table->mask;
+	while (table->symbols[slot].type != 0) {
+		if (table->symbols[slot].hash == name_hash) {
+			return &table->symbols[slot];
+		}
+		slot = (slot + 1) & table->mask;
+	}
+	return NULL;
+}
+
+GLint program_find_uniform(const program_t* program, uint32_t name_hash) {
+	const program_symbol_t* symbol = program_find_symbol(&program->uniforms, name_hash);
+	return symbol != NULL ? symbol->location : -1;
+}
+
+GLint program_find_attribute(const program_t* program, uint32_t name_hash) {
+	const program_symbol_t* symbol = program_find_symbol(&program->attributes, name_hash);
+	return symbol != NULL ? symbol->location : -1;
+}
+
+GLint program_find_uniform_block(const program_t* program, uint32_t name_hash) {
+	const program_symbol_t* symbol = program_find_symbol(&program->blocks, name_hash);
+	return symbol != NULL ? symbol->location : -1;
+}
+
 GLint program_get_uniform_location(program_t* program, const GLchar* name) {
-	return glGetUniformLocation(program->id, name);
+	return program_find_uniform(program, hash_name(name));
 }
 
 void program_set_uniform1i(GLint location, GLint value) {
+	if (location < 0) {
+		return;
+	}
 	glUniform1i(location, value);
 }
 
 void program_set_uniform1f(GLint location, GLfloat value) {
+	if (location < 0) {
+		return;
+	}
 	glUniform1f(location, value);
 }
 
 void program_set_uniform2f(GLint location, GLfloat x, GLfloat y) {
+	if (location < 0) {
+		return;
+	}
 	glUniform2f(location, x, y);
 }
 
 void program_set_uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z) {
+	if (location < 0) {
+		return;
+	}
 	glUniform3f(location, x, y, z);
 }
 
 void program_set_uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+	if (location < 0) {
+		return;
+	}
 	glUniform4f(location, x, y, z, w);
 }
 
 void program_set_uniform_sampler(GLint location, GLuint slot) {
-	glActiveTexture(GL_TEXTURE0 + slot);
-	glUniform1i(location, slot);
+	gl_state_active_texture(slot);
+	if (location >= 0) {
+		glUniform1i(location, slot);
+	}
 }
 
 void program_set_uniform_vec3f(GLint location, vec3_t value) {
+	if (location < 0) {
+		return;
+	}
 	glUniform3f(location, value.x, value.y, value.z);
 }
 
 void program_set_uniform_mat3f(GLint location, const mat3_t* matrix) {
+	if (location < 0) {
+		return;
+	}
 	float mat3_array[MAT3];
 	mat3_to_array(matrix, mat3_array);
 	glUniformMatrix3fv(location, 1, GL_FALSE, mat3_array);
 }
 
 void program_set_uniform_mat4f(GLint location, const mat4_t* matrix) {
+	if (location < 0) {
+		return;
+	}
 	float mat4_array[MAT4];
 	mat4_to_array(matrix, mat4_array);
 	glUniformMatrix4fv(location, 1, GL_FALSE, mat4_array);
@@ -21,26 +21,47 @@ static unsigned int indices[] = {
 	1, 2, 3   // second Triangle
 };
 
-void quad_init(quad_t* quad, const char* vertex_shader, const char* fragment_shader, const char* texture) {
-	game_object_init(&quad->go, vertex_shader, fragment_shader, texture);
-
+static void quad_upload(quad_t* quad, const float* quad_vertices, GLsizeiptr size) {
 	vao_bind(&quad->go.vao);
-	vbo_set_data(&quad->go.vbo, vertices, sizeof(vertices));
+	vbo_set_data(&quad->go.vbo, quad_vertices, size);
 	ebo_set_data(&quad->go.ebo, indices, sizeof(indices));
 	vao_link_vbo_3f2f();
 
 	buffer_unbind();
 }
 
+void quad_init(quad_t* quad, const char* vertex_shader, const char* fragment_shader, const char* texture) {
+	game_object_init(&quad->go, vertex_shader, fragment_shader, texture);
+	quad_upload(quad, vertices, sizeof(vertices));
+}
+
+void quad_init_sprite(quad_t* quad, const char* vertex_shader, const char* fragment_shader, const atlas_t* atlas, const char* sprite_name) {
+	const atlas_sprite_t* sprite = atlas_find(atlas, sprite_name);
+	if (sprite == NULL) {
+		fprintf(stderr, "sprite %s not found in atlas %s.\n", sprite_name, atlas->name);
+		exit(EXIT_FAILURE);
+	}
+
+	// The texture is the atlas itself, every sprite quad shares its handle
+	game_object_init(&quad->go, vertex_shader, fragment_shader, atlas->name);
+
+	// Same quad, with the texture coordinates squeezed into the sprite's rect
+	float sprite_vertices[sizeof(vertices) / sizeof(float)];
+	memcpy(sprite_vertices, vertices, sizeof(vertices));
+	for (int i = 0; i < 4; i++) {
+		float* uv = &sprite_vertices[i * 5 + 3];
+		uv[0] = sprite->uv.u0 + uv[0] * (sprite->uv.u1 - sprite->uv.u0);
+		uv[1] = sprite->uv.v0 + uv[1] * (sprite->uv.v1 - sprite->uv.v0);
+	}
+	quad_upload(quad, sprite_vertices, sizeof(sprite_vertices));
+}
+
 void quad_render(quad_t* quad) {
-	program_set(&quad->go.program);
+	program_set(shader_mgr_program(quad->go.program));
 	buffer_bind(&quad->go.vao, &quad->go.vbo, &quad->go.ebo);
-	tbo_bind(&quad->go.tbo);
+	texture_mgr_bind(quad->go.texture, 0);
 
 	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-	buffer_unbind();
-	program_unset();
 }
 
 void quad_update(quad_t* quad) {
@@ -48,7 +69,7 @@ void quad_update(quad_t* quad) {
 }
 
 void quad_delete(quad_t* quad) {
-	tbo_delete(&quad->go.tbo);
-	program_delete(&quad->go.program);
+	texture_mgr_release(quad->go.texture);
+	shader_mgr_release(quad->go.program);
 	buffer_delete(&quad->go.vao, &quad->go.vbo, &quad->go.ebo);
 }
@@ -0,0 +1,339 @@
+/**
+* @file de_render_queue.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_buffer.h"
+#include "../../include/de_render_queue.h"
+
+#define RENDER_QUEUE_RESERVE 256
+#define RENDER_QUEUE_INSTANCE_BYTES (RENDER_QUEUE_RESERVE * sizeof(render_instance_t)) // per frame, grows with the scene
+#define RENDER_RADIX_BITS 8
+#define RENDER_RADIX_BUCKETS (1 << RENDER_RADIX_BITS)
+
+#define RENDER_KEY_FIELD(value, bits) ((uint64_t)(value) & ((1ull << (bits)) - 1))
+
+void render_queue_init(render_queue_t* queue) {
+	list_init_size(&queue->items, sizeof(render_item_t), RENDER_QUEUE_RESERVE);
+	list_init_size(&queue->entries, sizeof(render_entry_t), RENDER_QUEUE_RESERVE);
+	list_init_size(&queue->scratch, sizeof(render_entry_t), RENDER_QUEUE_RESERVE);
+	stream_buffer_init(&queue->instances, GL_ARRAY_BUFFER, RENDER_QUEUE_INSTANCE_BYTES);
+	queue->instance_offset = 0;
+	for (int i = 0; i < RENDER_QUEUE_MAX_RANGES; i++) {
+		command_buffer_init(&queue->commands[i]);
+	}
+	queue->range_count = 0;
+	queue->view_projection = mat4_identity();
+	queue->eye = vec3_new(0.0f, 0.0f, 0.0f);
+	queue->stats = (render_stats_t){ 0 };
+}
+
+void render_queue_begin(render_queue_t* queue, const mat4_t* view, const mat4_t* projection, const vec3_t* eye) {
+	list_clear(&queue->items);
+	list_clear(&queue->entries);
+	stream_buffer_begin_frame(&queue->instances);
+	queue->view_projection = mat4_mul_mat4(projection, view);
+	queue->eye = *eye;
+}
+
+// The bits of a positive float grow with its value: exponent and the top of the mantissa
+// give a logarithmic depth, fine close to the camera and coarse far away, with no range to set
+static uint64_t render_queue_depth(float depth) {
+	uint32_t bits;
+	depth = depth > 0.0f ? depth : 0.0f;
+	memcpy(&bits, &depth, sizeof(bits));
+	return (bits >> (31 - RENDER_KEY_DEPTH_BITS)) & ((1u << RENDER_KEY_DEPTH_BITS) - 1);
+}
+
+uint64_t render_queue_key(render_pass_t pass, const render_item_t* item, float depth) {
+	uint64_t state = RENDER_KEY_FIELD(item->program, RENDER_KEY_PROGRAM_BITS);
+	state = (state << RENDER_KEY_MATERIAL_BITS) | RENDER_KEY_FIELD(item->material, RENDER_KEY_MATERIAL_BITS);
+	state = (state << RENDER_KEY_TEXTURE_BITS) | RENDER_KEY_FIELD(item->texture, RENDER_KEY_TEXTURE_BITS);
+	state = (state << RENDER_KEY_MESH_BITS) | RENDER_KEY_FIELD(item->mesh, RENDER_KEY_MESH_BITS);
+
+	uint64_t key = RENDER_KEY_FIELD(pass, RENDER_KEY_PASS_BITS);
+	uint64_t quantized = render_queue_depth(depth);
+	if (pass == RENDER_PASS_TRANSPARENT) {
+		// Blending needs back to front across every program, depth goes before the state
+		quantized = ((1u << RENDER_KEY_DEPTH_BITS) - 1) - quantized;
+		key = (key << RENDER_KEY_DEPTH_BITS) | quantized;
+		return (key << RENDER_KEY_STATE_BITS) | state;
+	}
+	key = (key << RENDER_KEY_STATE_BITS) | state;
+	return (key << RENDER_KEY_DEPTH_BITS) | quantized;
+}
+
+void render_queue_submit(render_queue_t* queue, render_pass_t pass, const render_item_t* item, const vec3_t* center) {
+	vec3_t to_center = vec3_sub(center, &queue->eye);
+	render_entry_t entry = {
+		.key = render_queue_key(pass, item, vec3_magnitude(&to_center)),
+		.index = (uint32_t)list_size(&queue->items)
+	};
+	list_add(&queue->items, (void*)item);
+	list_add(&queue->entries, &entry);
+}
+
+// LSD radix sort, a byte per pass. Passes where every key has the same byte are skipped,
+// with a few programs and meshes most of the upper bytes are. Stable, equal keys keep
+// their order. The scratch list is the other half of the sort and may swap with entries.
+void render_entries_sort(list_t* entries, list_t* scratch) {
+	size_t count = list_size(entries);
+	if (count < 2) {
+		return;
+	}
+	list_resize(scratch, count);
+
+	render_entry_t* source = (render_entry_t*)entries->array;
+	render_entry_t* target = (render_entry_t*)scratch->array;
+	for (int shift = 0; shift < 64; shift += RENDER_RADIX_BITS) {
+		size_t offsets[RENDER_RADIX_BUCKETS] = { 0 };
+		for (size_t i = 0; i < count; i++) {
+			offsets[(source[i].key >> shift) & (RENDER_RADIX_BUCKETS - 1)]++;
+		}
+		if (offsets[(source[0].key >> shift) & (RENDER_RADIX_BUCKETS - 1)] == count) {
+			continue;
+		}
+
+		size_t total = 0;
+		for (int bucket = 0; bucket < RENDER_RADIX_BUCKETS; bucket++) {
+			size_t bucket_count = offsets[bucket];
+			offsets[bucket] = total;
+			total += bucket_count;
+		}
+		for (size_t i = 0; i < count; i++) {
+			target[offsets[(source[i].key >> shift) & (RENDER_RADIX_BUCKETS - 1)]++] = source[i];
+		}
+
+		render_entry_t* swap = source;
+		source = target;
+		target = swap;
+	}
+
+	// An odd number of passes leaves the result in the scratch list
+	if (source != (render_entry_t*)entries->array) {
+		list_t swap = *entries;
+		*entries = *scratch;
+		*scratch = swap;
+		entries->size = count;
+		scratch->size = 0;
+	}
+}
+
+void render_queue_sort(render_queue_t* queue) {
+	render_entries_sort(&queue->entries, &queue->scratch);
+}
+
+// Items that may share one instanced draw
+static bool render_queue_same_batch(const render_item_t* item, const render_item_t* next) {
+	return item->instanced && next->instanced && next->program == item->program && next->material == item->material
+		&& next->texture == item->texture && next->mesh == item->mesh && next->lod == item->lod;
+}
+
+// Consecutive instanced items that share every piece of state become one draw
+static size_t render_queue_run(render_queue_t* queue, size_t first) {
+	const render_entry_t* entries = (const render_entry_t*)queue->entries.array;
+	const render_item_t* items = (const render_item_t*)queue->items.array;
+	const render_item_t* item = &items[entries[first].index];
+	if (!item->instanced) {
+		return 1;
+	}
+
+	size_t last = first + 1;
+	while (last < list_size(&queue->entries) && render_queue_same_batch(item, &items[entries[last].index])) {
+		last++;
+	}
+	return last - first;
+}
+
+static void render_queue_write_instance(render_instance_t* instance, const mat4_t* model) {
+	mat4_to_array(model, instance->model);
+
+	// Column major, padded to vec4 per column. Unnormalized, the shader normalizes anyway.
+	mat3_t normal = mat4_normal_matrix(model);
+	for (int column = 0; column < 3; column++) {
+		for (int row = 0; row < 3; row++) {
+			instance->normal[column * 4 + row] = normal.m[row][column];
+		}
+		instance->normal[column * 4 + 3] = 0.0f;
+	}
+}
+
+typedef struct {
+	render_queue_t* queue;
+	render_instance_t* instances;               // this frame's, mapped; NULL without instanced items
+	size_t bounds[RENDER_QUEUE_MAX_RANGES + 1]; // first entry of every range, then the entry count
+	size_t instance_bases[RENDER_QUEUE_MAX_RANGES]; // first instance slot of every range
+	render_stats_t stats[RENDER_QUEUE_MAX_RANGES];
+} render_recording_t;
+
+// Ranges of about the same number of entries. A boundary falling inside an instanced
+// run moves to its end, so every run stays one draw. Returns the instanced items.
+static size_t render_queue_split(render_queue_t* queue, render_recording_t* recording) {
+	size_t count = list_size(&queue->entries);
+	const render_entry_t* entries = (const render_entry_t*)queue->entries.array;
+	const render_item_t* items = (const render_item_t*)queue->items.array;
+
+	int ranges = (int)(count / RENDER_QUEUE_RANGE_MIN);
+	if (ranges > 1) {
+		int threads = jobs_thread_count();
+		ranges = ranges > threads ? threads : ranges;
+	}
+	ranges = ranges < 1 ? 1 : ranges;
+
+	recording->bounds[0] = 0;
+	for (int range = 1; range < ranges; range++) {
+		size_t bound = count * (size_t)range / (size_t)ranges;
+		bound = bound < recording->bounds[range - 1] ? recording->bounds[range - 1] : bound;
+		while (bound > 0 && bound < count && render_queue_same_batch(&items[entries[bound - 1].index], &items[entries[bound].index])) {
+			bound++;
+		}
+		recording->bounds[range] = bound;
+	}
+	recording->bounds[ranges] = count;
+	queue->range_count = ranges;
+
+	// Every instanced item gets its slot in sorted order, so each run reads a contiguous range
+	size_t instanced = 0;
+	for (int range = 0; range < ranges; range++) {
+		recording->instance_bases[range] = instanced;
+		for (size_t i = recording->bounds[range]; i < recording->bounds[range + 1]; i++) {
+			instanced += items[entries[i].index].instanced;
+		}
+	}
+	return instanced;
+}
+
+// Runs on any thread: writes the instances of the range and records its commands, no GL call.
+// Only the state that differs from the previous draw is recorded. A range starts from the
+// state the entry before it leaves bound, so the ranges replayed in order send exactly
+// what a single pass over the queue would.
+static void render_queue_record(void* data, int range) {
+	render_recording_t* recording = (render_recording_t*)data;
+	render_queue_t* queue = recording->queue;
+	command_buffer_t* commands = &queue->commands[range];
+	const render_entry_t* entries = (const render_entry_t*)queue->entries.array;
+	const render_item_t* items = (const render_item_t*)queue->items.array;
+	size_t first = recording->bounds[range];
+	size_t last = recording->bounds[range + 1];
+	command_buffer_reset(commands);
+
+	render_stats_t stats = { 0 };
+	program_handle_t program = PROGRAM_HANDLE_INVALID;
+	int material = -1;
+	texture_handle_t texture = TEXTURE_HANDLE_INVALID;
+	mesh_handle_t mesh = MESH_HANDLE_INVALID;
+	const mesh_t* bound_mesh = NULL;
+	if (first > 0 && first < last) {
+		const render_item_t* previous = &items[entries[first - 1].index];
+		program = previous->program;
+		material = previous->material;
+		texture = previous->texture;
+		mesh = previous->mesh;
+		bound_mesh = mesh_mgr_get(mesh)->mesh;
+	}
+	size_t instance = recording->instance_bases[range];
+
+	for (size_t i = first, run = 1; i < last; i += run) {
+		const render_item_t* item = &items[entries[i].index];
+		run = render_queue_run(queue, i);
+
+		bool program_changed = item->program != program;
+		if (program_changed) {
+			command_buffer_bind_program(commands, item->program, item->uniform_texture);
+			program = item->program;
+			stats.program_switches++;
+		}
+		if (item->material != material) {
+			command_buffer_bind_material(commands, item->material);
+			material = item->material;
+			stats.material_switches++;
+		}
+		if (item->texture != texture) {
+			command_buffer_bind_texture(commands, item->texture, 0);
+			texture = item->texture;
+			stats.texture_switches++;
+		}
+		bool mesh_changed = item->mesh != mesh;
+		if (mesh_changed) {
+			command_buffer_bind_mesh(commands, item->mesh);
+			mesh = item->mesh;
+			bound_mesh = mesh_mgr_get(mesh)->mesh;
+			stats.mesh_switches++;
+		}
+		// Dequantization is per mesh but lives in the program, a switch of either resends it
+		if (program_changed || mesh_changed) {
+			command_buffer_uniform_vec3(commands, item->uniform_dequant_scale, bound_mesh->dequant_scale);
+			command_buffer_uniform_vec3(commands, item->uniform_dequant_offset, bound_mesh->dequant_offset);
+		}
+
+		if (item->instanced) {
+			// Meshlets are culled per object, a batch draws its whole level instead
+			for (size_t j = 0; j < run; j++) {
+				render_queue_write_instance(&recording->instances[instance + j], items[entries[i + j].index].model);
+			}
+			command_buffer_bind_instances(commands, item->mesh, &queue->instances, queue->instance_offset + (GLintptr)(instance * sizeof(render_instance_t)));
+			command_buffer_draw_instanced(commands, item->mesh, item->lod, (int)run);
+			instance += run;
+			stats.instances += (int)run;
+		}
+		else {
+			command_buffer_uniform_mat4(commands, item->uniform_model, item->model);
+			if (bound_mesh->meshlet_count > 0 && item->lod == 0) {
+				command_buffer_draw_meshlets(commands, item->mesh, item->model, &queue->view_projection, &queue->eye);
+			}
+			else {
+				command_buffer_draw(commands, item->mesh, item->lod);
+			}
+		}
+		stats.draws++;
+	}
+
+	recording->stats[range] = stats;
+}
+
+// State tracking, instance packing and meshlet culling happen while recording, spread over
+// the job threads. The GL thread then only replays the command buffers.
+render_stats_t render_queue_execute(render_queue_t* queue) {
+	render_queue_sort(queue);
+
+	render_recording_t recording = { .queue = queue, .instances = NULL };
+	size_t instanced = render_queue_split(queue, &recording);
+	// Mapped once on the GL thread, the ranges write their own slots of this frame's segment
+	if (instanced > 0) {
+		GLsizeiptr size = (GLsizeiptr)(instanced * sizeof(render_instance_t));
+		recording.instances = (render_instance_t*)stream_buffer_map(&queue->instances, size, &queue->instance_offset);
+	}
+	jobs_run(render_queue_record, &recording, queue->range_count);
+	if (instanced > 0) {
+		stream_buffer_unmap(&queue->instances);
+	}
+
+	render_stats_t stats = { 0 };
+	for (int range = 0; range < queue->range_count; range++) {
+		command_buffer_execute(&queue->commands[range]);
+
+		const render_stats_t* recorded = &recording.stats[range];
+		stats.draws += recorded->draws;
+		stats.instances += recorded->instances;
+		stats.program_switches += recorded->program_switches;
+		stats.material_switches += recorded->material_switches;
+		stats.texture_switches += recorded->texture_switches;
+		stats.mesh_switches += recorded->mesh_switches;
+	}
+
+	queue->stats = stats;
+	return stats;
+}
+
+void render_queue_free(render_queue_t* queue) {
+	list_free(&queue->items);
+	list_free(&queue->entries);
+	list_free(&queue->scratch);
+	stream_buffer_delete(&queue->instances);
+	for (int i = 0; i < RENDER_QUEUE_MAX_RANGES; i++) {
+		command_buffer_free(&queue->commands[i]);
+	}
+}
@@ -6,8 +6,17 @@
 * Dodoi-Engine is a game engine developed by Dodoi-Lab.
 * @copyright Copyright (c) 2024, Dodoi-Lab
 */
+#include "../../include/de_util.h"
 #include "../../include/de_shader.h"
 
+static const char* shader_key_names[SHADER_KEY_COUNT] = { "DE_PACKED_VERTEX", "DE_TWO_SIDED", "DE_INSTANCED" };
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} shader_text_t;
+
 shader_t* shader_new(void) {
 	shader_t* shader = (shader_t*)malloc(sizeof(shader_t));
 	if (shader == NULL) {
@@ -26,15 +35,29 @@ void shader_init_vert_shader(shader_t* shader) {
 }
 
 bool shader_compile(shader_t* shader, const GLchar* path) {
-    const GLchar* source = shader_load_file(path);
+    return shader_compile_defines(shader, path, NULL);
+}
+
+bool shader_compile_defines(shader_t* shader, const GLchar* path, const GLchar* defines) {
+    return shader_compile_begin(shader, path, defines) && shader_compile_end(shader);
+}
+
+bool shader_compile_begin(shader_t* shader, const GLchar* path, const GLchar* defines) {
+    GLchar* source = shader_preprocess(path, defines);
     if (source == NULL) {
         fprintf(stderr, "failed to load shader: %s.\n", path);
         return false;
     }
 
-    glShaderSource(shader->id, 1, &source, NULL);
+    const GLchar* parts[1] = { source };
+    glShaderSource(shader->id, 1, parts, NULL);
     glCompileShader(shader->id);
+    free(source);
+    return true;
+}
 
+bool shader_compile_end(shader_t* shader) {
+    // Blocks until the driver is done with this shader
     GLint result;
     glGetShaderiv(shader->id, GL_COMPILE_STATUS, &result);
     if (result != GL_TRUE) {
@@ -85,3 +108,168 @@ char* shader_load_file(const char* path) {
     fclose(file);
     return buffer;
 }
+
+static void shader_text_append(shader_text_t* text, const char* data, size_t length) {
+    if (text->length + length + 1 > text->capacity) {
+        size_t capacity = text->capacity > 0 ? text->capacity : 4096;
+        while (text->length + length + 1 > capacity) {
+            capacity *= 2;
+        }
+        char* data_grown = (char*)realloc(text->data, capacity);
+        if (data_grown == NULL) {
+            fprintf(stderr, "failed to allocate memory for shader source.\n");
+            exit(EXIT_FAILURE);
+        }
+        text->data = data_grown;
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+}
+
+static void shader_text_end_line(shader_text_t* text) {
+    if (text->length > 0 && text->data[text->length - 1] != '\n') {
+        shader_text_append(text, "\n", 1);
+    }
+}
+
+// Keeps compiler messages pointing at the right file: "1(12)" is line 12 of the first include
+static void shader_text_line(shader_text_t* text, int line, int file) {
+    shader_text_end_line(text);
+    char directive[32];
+    int length = snprintf(directive, sizeof(directive), "#line %d %d\n", line, file);
+    shader_text_append(text, directive, (size_t)length);
+}
+
+// Matches "#<directive>" at the start of a line, whitespace allowed around the '#'
+static const char* shader_directive(const char* line, const char* end, const char* directive) {
+    size_t length = strlen(directive);
+    while (line < end && (*line == ' ' || *line == '\t')) {
+        line++;
+    }
+    if (line == end || *line++ != '#') {
+        return NULL;
+    }
+    while (line < end && (*line == ' ' || *line == '\t')) {
+        line++;
+    }
+    if ((size_t)(end - line) < length || strncmp(line, directive, length) != 0) {
+        return NULL;
+    }
+    return line + length;
+}
+
+// #include "name" with name relative to the shader folder
+static bool shader_include_name(const char* line, const char* end, char* name, size_t size) {
+    const char* rest = shader_directive(line, end, "include");
+    if (rest == NULL) {
+        return false;
+    }
+    const char* open = memchr(rest, '"', (size_t)(end - rest));
+    const char* close = open != NULL ? memchr(open + 1, '"', (size_t)(end - open - 1)) : NULL;
+    if (close == NULL || (size_t)(close - open - 1) >= size) {
+        return false;
+    }
+    memcpy(name, open + 1, (size_t)(close - open - 1));
+    name[close - open - 1] = '\0';
+    return true;
+}
+
+// Every file is expanded once, includes of a file already pulled in are dropped
+static bool shader_expand(shader_text_t* text, const char* path, const char* defines, list_t* files, int depth) {
+    if (depth > SHADER_INCLUDE_DEPTH) {
+        fprintf(stderr, "failed to preprocess shader: %s, includes nested too deep.\n", path);
+        return false;
+    }
+    for (size_t i = 0; i < list_size(files); i++) {
+        if (strcmp(*(char**)list_get(files, i), path) == 0) {
+            return true;
+        }
+    }
+
+    char* source = shader_load_file(path);
+    if (source == NULL) {
+        return false;
+    }
+    int file = (int)list_size(files);
+    char* file_path = concat(path, "");
+    list_add(files, &file_path);
+
+    // Defines go right after the #version line, nothing but comments may come before it
+    bool defines_pending = depth == 0;
+    if (defines_pending && strstr(source, "#version") == NULL) {
+        shader_text_append(text, defines, strlen(defines));
+        shader_text_line(text, 1, file);
+        defines_pending = false;
+    }
+
+    bool expanded = true;
+    int line_number = 1;
+    const char* line = source;
+    while (expanded && *line != '\0') {
+        const char* end = strchr(line, '\n');
+        const char* next = end != NULL ? end + 1 : line + strlen(line);
+        end = end != NULL ? end : next;
+
+        char name[128];
+        if (shader_include_name(line, end, name, sizeof(name))) {
+            char* include_path = create_shader_path(name);
+            shader_text_line(text, 1, (int)list_size(files));
+            expanded = shader_expand(text, include_path, defines, files, depth + 1);
+            if (!expanded) {
+                fprintf(stderr, "failed to include shader: %s from %s.\n", name, path);
+            }
+            shader_text_line(text, line_number + 1, file);
+            free(include_path);
+        }
+        else {
+            shader_text_append(text, line, (size_t)(next - line));
+            if (defines_pending && shader_directive(line, end, "version") != NULL) {
+                shader_text_end_line(text);
+                shader_text_append(text, defines, strlen(defines));
+                shader_text_line(text, line_number + 1, file);
+                defines_pending = false;
+            }
+        }
+        line = next;
+        line_number++;
+    }
+
+    free(source);
+    return expanded;
+}
+
+char* shader_preprocess(const char* path, const char* defines) {
+    shader_text_t text = { NULL, 0, 0 };
+    list_t files;
+    list_init(&files, sizeof(char*));
+
+    bool expanded = shader_expand(&text, path, defines != NULL ? defines : "", &files, 0);
+
+    for (size_t i = 0; i < list_size(&files); i++) {
+        free(*(char**)list_get(&files, i));
+    }
+    list_free(&files);
+    if (!expanded) {
+        free(text.data);
+        return NULL;
+    }
+    return text.data;
+}
+
+void shader_key_defines(shader_key_t key, char* defines, size_t size) {
+    size_t length = 0;
+    defines[0] = '\0';
+    for (int i = 0; i < SHADER_KEY_COUNT; i++) {
+        if ((key & (1u << i)) == 0) {
+            continue;
+        }
+        int written = snprintf(defines + length, size - length, "#define %s 1\n", shader_key_names[i]);
+        if (written < 0 || (size_t)written >= size - length) {
+            fprintf(stderr, "failed to build shader defines, key %08x.\n", key);
+            exit(EXIT_FAILURE);
+        }
+        length += (size_t)written;
+    }
+}
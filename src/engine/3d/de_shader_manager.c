@@ -12,30 +12,370 @@
 #include "../../include/de_collection.h"
 #include "../../include/de_shader_manager.h"
 
-static bool shader_mgr_is_compiled(const char* name) {
-	char* file_path = create_binary_path(name);
-	return file_exists(file_path);
+// Same layout as the mesh and texture registries: stable pointers, NULL marks a free slot.
+static list_t programs;
+static bool initialized = false;
+
+static list_t preloaded; // references held by shader_mgr_pre_load until shutdown
+static int cache_hits = 0;
+static int compiles = 0;
+static double load_seconds = 0.0;
+
+static double shader_mgr_now(void) {
+	return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
 }
 
-void shader_mgr_pre_compile(list_t* recipes) {
-	for (size_t i = 0; i < recipes->size; ++i) {
-		recipe_t* recipe = (recipe_t*)((char*)recipes->array + i * recipes->type_size);
-		if (shader_mgr_is_compiled(recipe->name)) {
-			continue;
+static shared_program_t* shader_mgr_slot(program_handle_t handle) {
+	return *(shared_program_t**)list_get(&programs, (size_t)handle);
+}
+
+static program_handle_t shader_mgr_find(const char* vert, const char* frag, const char* defines) {
+	for (size_t i = 0; i < list_size(&programs); i++) {
+		shared_program_t* shared = shader_mgr_slot((program_handle_t)i);
+		if (shared != NULL && strcmp(shared->vert, vert) == 0 && strcmp(shared->frag, frag) == 0 && strcmp(shared->defines, defines) == 0) {
+			return (program_handle_t)i;
 		}
+	}
+	return PROGRAM_HANDLE_INVALID;
+}
+
+static program_handle_t shader_mgr_insert(shared_program_t* shared) {
+	for (size_t i = 0; i < list_size(&programs); i++) {
+		shared_program_t** slot = (shared_program_t**)list_get(&programs, i);
+		if (*slot == NULL) {
+			*slot = shared;
+			return (program_handle_t)i;
+		}
+	}
+	list_add(&programs, &shared);
+	return (program_handle_t)(list_size(&programs) - 1);
+}
+
+static char* shader_mgr_copy(const char* value) {
+	char* copy = (char*)malloc(strlen(value) + 1);
+	if (copy == NULL) {
+		fprintf(stderr, "failed to allocate memory for shared program.\n");
+		exit(EXIT_FAILURE);
+	}
+	strcpy(copy, value);
+	return copy;
+}
+
+static void shader_mgr_free(shared_program_t* shared) {
+	if (shared->pending) {
+		// Deleting the program also drops the shaders attached to it, no need to wait for them
+		shader_delete(&shared->build.vertex_shader);
+		shader_delete(&shared->build.fragment_shader);
+	}
+	program_delete(&shared->program);
+	free(shared->vert);
+	free(shared->frag);
+	free(shared->defines);
+	free(shared);
+}
+
+// "cube.vert" and "cube.frag" cache to "./data/binary/cube.vert+cube.frag.program",
+// with a hash of the defines in the name when there are any
+static char* shader_mgr_binary_path(const char* vert, const char* frag, const char* defines) {
+	char name[256];
+	if (defines[0] != '\0') {
+		snprintf(name, sizeof(name), "%s+%s.%08x%s", vert, frag, (unsigned int)hash_bytes(defines, strlen(defines), HASH_SEED), PROGRAM_EXTENSION);
+	}
+	else {
+		snprintf(name, sizeof(name), "%s+%s%s", vert, frag, PROGRAM_EXTENSION);
+	}
+	return create_binary_path(name);
+}
+
+// Everything the compiled program depends on besides the driver. Hashing the preprocessed
+// sources covers the defines and every included file, editing an include rebuilds its users.
+static bool shader_mgr_source_hash(const char* vertex_path, const char* fragment_path, const char* defines, uint64_t* hash) {
+	char* vertex_source = shader_preprocess(vertex_path, defines);
+	char* fragment_source = shader_preprocess(fragment_path, defines);
+	bool loaded = vertex_source != NULL && fragment_source != NULL;
+	if (loaded) {
+		*hash = hash_bytes(vertex_source, strlen(vertex_source) + 1, HASH_SEED);
+		*hash = hash_bytes(fragment_source, strlen(fragment_source) + 1, *hash);
+	}
+	free(vertex_source);
+	free(fragment_source);
+	return loaded;
+}
+
+static void shader_mgr_init(void) {
+	if (initialized) {
+		return;
+	}
+	list_init(&programs, sizeof(shared_program_t*));
+	list_init(&preloaded, sizeof(program_handle_t));
+	// Let the driver pick how many threads compile in the background
+	program_set_max_compiler_threads(0xFFFFFFFF);
+	initialized = true;
+}
 
-		program_t* program = program_new();
-		char* binary_path = create_binary_path(recipe->name);
-		char* vertex_shader_path = create_shader_path(recipe->vert);
-		char* fragment_shader_path = create_shader_path(recipe->frag);
+// Reads back the status of a build begun by shader_mgr_acquire_async, blocking if the driver is not done yet
+static bool shader_mgr_finish_build(shared_program_t* shared) {
+	if (!shared->pending) {
+		return !shared->failed;
+	}
+	shared->pending = false;
+	double start = shader_mgr_now();
+	shared->failed = !program_build_end(&shared->build);
+	double seconds = shader_mgr_now() - start;
+	shared->load_seconds += seconds;
+	load_seconds += seconds;
+	if (shared->failed) {
+		fprintf(stderr, "failed to build program: %s+%s.\n", shared->vert, shared->frag);
+		return false;
+	}
 
-		program_compile(program, vertex_shader_path, fragment_shader_path);
-		program_save_binary(program, binary_path);
+	char* binary_path = shader_mgr_binary_path(shared->vert, shared->frag, shared->defines);
+	program_save_binary(&shared->program, binary_path, shared->source_hash);
+	free(binary_path);
+	compiles++;
+	return true;
+}
+
+program_handle_t shader_mgr_acquire(const char* vert, const char* frag, const char* defines) {
+	program_handle_t handle = shader_mgr_acquire_async(vert, frag, defines);
+	if (handle != PROGRAM_HANDLE_INVALID && !shader_mgr_finish_build(shader_mgr_slot(handle))) {
+		shader_mgr_release(handle);
+		return PROGRAM_HANDLE_INVALID;
+	}
+	return handle;
+}
 
-		program_delete(program);
-		free(program);
+program_handle_t shader_mgr_acquire_async(const char* vert, const char* frag, const char* defines) {
+	shader_mgr_init();
+	defines = defines != NULL ? defines : "";
+
+	program_handle_t handle = shader_mgr_find(vert, frag, defines);
+	if (handle != PROGRAM_HANDLE_INVALID) {
+		shader_mgr_slot(handle)->ref_count++;
+		return handle;
+	}
+
+	char* vertex_path = create_shader_path(vert);
+	char* fragment_path = create_shader_path(frag);
+	char* binary_path = shader_mgr_binary_path(vert, frag, defines);
+
+	uint64_t source_hash = 0;
+	if (!shader_mgr_source_hash(vertex_path, fragment_path, defines, &source_hash)) {
+		free(vertex_path);
+		free(fragment_path);
 		free(binary_path);
-		free(vertex_shader_path);
-		free(fragment_shader_path);
+		return PROGRAM_HANDLE_INVALID;
+	}
+
+	shared_program_t* shared = (shared_program_t*)malloc(sizeof(shared_program_t));
+	if (shared == NULL) {
+		fprintf(stderr, "failed to allocate memory for shared program.\n");
+		exit(EXIT_FAILURE);
+	}
+	shared->vert = shader_mgr_copy(vert);
+	shared->frag = shader_mgr_copy(frag);
+	shared->defines = shader_mgr_copy(defines);
+	shared->ref_count = 1;
+	shared->pending = false;
+	shared->failed = false;
+	shared->source_hash = source_hash;
+	program_init(&shared->program);
+
+	// Warm start: the cached binary matches sources and driver, nothing gets compiled
+	double start = shader_mgr_now();
+	bool issued = program_load_binary(&shared->program, binary_path, source_hash);
+	if (issued) {
+		cache_hits++;
+	}
+	else {
+		// A rejected binary leaves the program object unusable, start from a fresh one.
+		// The build runs in the background, its status is read back by the first caller that needs it.
+		program_delete(&shared->program);
+		program_init(&shared->program);
+		issued = program_build_begin(&shared->build, &shared->program, vertex_path, fragment_path, defines);
+		shared->pending = issued;
+	}
+	shared->load_seconds = shader_mgr_now() - start;
+	load_seconds += shared->load_seconds;
+
+	free(vertex_path);
+	free(fragment_path);
+	free(binary_path);
+
+	if (!issued) {
+		shader_mgr_free(shared);
+		return PROGRAM_HANDLE_INVALID;
+	}
+	return shader_mgr_insert(shared);
+}
+
+// Variants of one vert+frag pair only differ in the features their key compiles in
+program_handle_t shader_mgr_acquire_variant(const char* vert, const char* frag, shader_key_t key) {
+	char defines[SHADER_DEFINES_SIZE];
+	shader_key_defines(key, defines, sizeof(defines));
+	return shader_mgr_acquire(vert, frag, defines);
+}
+
+program_handle_t shader_mgr_acquire_variant_async(const char* vert, const char* frag, shader_key_t key) {
+	char defines[SHADER_DEFINES_SIZE];
+	shader_key_defines(key, defines, sizeof(defines));
+	return shader_mgr_acquire_async(vert, frag, defines);
+}
+
+bool shader_mgr_is_ready(program_handle_t handle) {
+	shared_program_t* shared = shader_mgr_get(handle);
+	if (shared->pending && program_build_is_done(&shared->build)) {
+		shader_mgr_finish_build(shared);
+	}
+	return !shared->pending;
+}
+
+void shader_mgr_retain(program_handle_t handle) {
+	shader_mgr_get(handle)->ref_count++;
+}
+
+void shader_mgr_release(program_handle_t handle) {
+	shared_program_t* shared = shader_mgr_get(handle);
+	if (--shared->ref_count > 0) {
+		return;
+	}
+
+	shader_mgr_free(shared);
+	*(shared_program_t**)list_get(&programs, (size_t)handle) = NULL;
+}
+
+shared_program_t* shader_mgr_get(program_handle_t handle) {
+	shared_program_t* shared = NULL;
+	if (initialized && handle >= 0 && (size_t)handle < list_size(&programs)) {
+		shared = shader_mgr_slot(handle);
+	}
+	if (shared == NULL) {
+		fprintf(stderr, "invalid program handle %d.\n", handle);
+		exit(EXIT_FAILURE);
+	}
+	return shared;
+}
+
+program_t* shader_mgr_program(program_handle_t handle) {
+	shared_program_t* shared = shader_mgr_get(handle);
+	shader_mgr_finish_build(shared);
+	return &shared->program;
+}
+
+int shader_mgr_count(void) {
+	int count = 0;
+	if (initialized) {
+		for (size_t i = 0; i < list_size(&programs); i++) {
+			count += shader_mgr_slot((program_handle_t)i) != NULL;
+		}
+	}
+	return count;
+}
+
+int shader_mgr_poll(void) {
+	int pending = 0;
+	if (initialized) {
+		for (size_t i = 0; i < list_size(&programs); i++) {
+			shared_program_t* shared = shader_mgr_slot((program_handle_t)i);
+			if (shared != NULL && shared->pending) {
+				pending += !shader_mgr_is_ready((program_handle_t)i);
+			}
+		}
+	}
+	return pending;
+}
+
+void shader_mgr_finish(void) {
+	if (!initialized) {
+		return;
+	}
+	for (size_t i = 0; i < list_size(&programs); i++) {
+		shared_program_t* shared = shader_mgr_slot((program_handle_t)i);
+		if (shared != NULL) {
+			shader_mgr_finish_build(shared);
+		}
+	}
+	shader_mgr_report();
+}
+
+// "#define DE_A 1\n#define DE_B 1\n" is listed as "DE_A DE_B"
+static void shader_mgr_define_names(const char* defines, char* names, size_t size) {
+	size_t length = 0;
+	names[0] = '\0';
+	for (const char* define = strstr(defines, "#define "); define != NULL; define = strstr(define, "#define ")) {
+		define += strlen("#define ");
+		size_t name_length = strcspn(define, " \t\r\n");
+		if (length + name_length + 2 > size) {
+			break;
+		}
+		if (length > 0) {
+			names[length++] = ' ';
+		}
+		memcpy(names + length, define, name_length);
+		length += name_length;
+		names[length] = '\0';
+	}
+}
+
+void shader_mgr_report(void) {
+	if (!initialized) {
+		return;
+	}
+	int variants = 0;
+	int pairs = 0;
+	for (size_t i = 0; i < list_size(&programs); i++) {
+		shared_program_t* shared = shader_mgr_slot((program_handle_t)i);
+		if (shared == NULL) {
+			continue;
+		}
+		variants++;
+
+		// A pair is counted at its first variant
+		bool first = true;
+		for (size_t j = 0; j < i && first; j++) {
+			shared_program_t* other = shader_mgr_slot((program_handle_t)j);
+			first = other == NULL || strcmp(other->vert, shared->vert) != 0 || strcmp(other->frag, shared->frag) != 0;
+		}
+		pairs += first;
+	}
+
+	printf("Programs: %d from cache, %d compiled, %d variants of %d shader pairs, %.2f ms\n", cache_hits, compiles, variants, pairs, load_seconds * 1000.0);
+	for (size_t i = 0; i < list_size(&programs); i++) {
+		shared_program_t* shared = shader_mgr_slot((program_handle_t)i);
+		if (shared == NULL) {
+			continue;
+		}
+		char names[SHADER_DEFINES_SIZE];
+		shader_mgr_define_names(shared->defines, names, sizeof(names));
+		printf("  %s+%s [%s]%s %.2f ms\n", shared->vert, shared->frag, names, shared->pending ? " pending" : shared->failed ? " failed" : "", shared->load_seconds * 1000.0);
+	}
+}
+
+// Only issues the builds, asset loading can run while the driver compiles.
+// shader_mgr_finish reads them all back once the rest of the startup work is done.
+void shader_mgr_pre_load(list_t* recipes) {
+	for (size_t i = 0; i < list_size(recipes); ++i) {
+		recipe_t* recipe = (recipe_t*)list_get(recipes, i);
+		char defines[SHADER_DEFINES_SIZE];
+		shader_key_defines(recipe->key, defines, sizeof(defines));
+		if (recipe->defines != NULL) {
+			strncat(defines, recipe->defines, sizeof(defines) - strlen(defines) - 1);
+		}
+		program_handle_t handle = shader_mgr_acquire_async(recipe->vert, recipe->frag, defines);
+		if (handle == PROGRAM_HANDLE_INVALID) {
+			fprintf(stderr, "failed to load program: %s.\n", recipe->name);
+			continue;
+		}
+		list_add(&preloaded, &handle);
+	}
+}
+
+void shader_mgr_shutdown(void) {
+	if (!initialized) {
+		return;
+	}
+	for (size_t i = 0; i < list_size(&preloaded); i++) {
+		shader_mgr_release(*(program_handle_t*)list_get(&preloaded, i));
 	}
+	list_clear(&preloaded);
 }
@@ -0,0 +1,223 @@
+/**
+* @file de_sprite_batch.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_gfx.h"
+#include "../../include/de_util.h"
+#include "../../include/de_sprite_batch.h"
+
+#define SPRITE_BATCH_RESERVE 1024 // sprites, every buffer grows with the frame
+#define SPRITE_KEY_TEXTURE_BITS 16
+
+static void sprite_batch_build_indices(sprite_batch_t* batch, int capacity) {
+	unsigned int* indices = (unsigned int*)malloc(sizeof(unsigned int) * 6 * (size_t)capacity);
+	if (indices == NULL) {
+		fprintf(stderr, "failed to allocate memory for sprite batch.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// Corners go top-left, top-right, bottom-right, bottom-left: counter clockwise once y points down
+	for (int i = 0; i < capacity; i++) {
+		unsigned int corner = (unsigned int)i * 4;
+		unsigned int* quad = &indices[i * 6];
+		quad[0] = corner;
+		quad[1] = corner + 3;
+		quad[2] = corner + 2;
+		quad[3] = corner;
+		quad[4] = corner + 2;
+		quad[5] = corner + 1;
+	}
+
+	// The element buffer is state of the vertex array, bound to it before the upload
+	vao_bind(&batch->vao);
+	ebo_set_data(&batch->ebo, indices, sizeof(unsigned int) * 6 * (GLsizeiptr)capacity);
+	batch->index_capacity = capacity;
+	free(indices);
+}
+
+void sprite_batch_init(sprite_batch_t* batch, const char* vertex_shader, const char* fragment_shader) {
+	batch->program = shader_mgr_acquire(vertex_shader, fragment_shader, NULL);
+	if (batch->program == PROGRAM_HANDLE_INVALID) {
+		fprintf(stderr, "failed to compile shaders.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	program_t* program = shader_mgr_program(batch->program);
+	batch->uniform_projection = program_find_uniform(program, NAME_HASH(PROJECTION));
+	batch->uniform_texture = program_find_uniform(program, NAME_HASH(TEXTURE));
+
+	vao_init(&batch->vao);
+	ebo_init(&batch->ebo);
+	sprite_batch_build_indices(batch, SPRITE_BATCH_RESERVE);
+	stream_buffer_init(&batch->vertices, GL_ARRAY_BUFFER, SPRITE_BATCH_RESERVE * 4 * sizeof(sprite_vertex_t));
+
+	list_init_size(&batch->sprites, sizeof(sprite_t), SPRITE_BATCH_RESERVE);
+	list_init_size(&batch->entries, sizeof(render_entry_t), SPRITE_BATCH_RESERVE);
+	list_init_size(&batch->scratch, sizeof(render_entry_t), SPRITE_BATCH_RESERVE);
+	batch->stats = (sprite_stats_t){ 0 };
+}
+
+void sprite_batch_begin(sprite_batch_t* batch) {
+	list_clear(&batch->sprites);
+	list_clear(&batch->entries);
+	stream_buffer_begin_frame(&batch->vertices);
+}
+
+// Layer first, then the page. Handles wider than their field only group less well,
+// runs are split on the real handle.
+static uint64_t sprite_batch_key(const sprite_t* sprite) {
+	int layer = sprite->layer < SPRITE_LAYER_MIN ? SPRITE_LAYER_MIN : sprite->layer > SPRITE_LAYER_MAX ? SPRITE_LAYER_MAX : sprite->layer;
+	uint64_t key = (uint64_t)(layer - SPRITE_LAYER_MIN);
+	return (key << SPRITE_KEY_TEXTURE_BITS) | ((uint64_t)sprite->texture & ((1u << SPRITE_KEY_TEXTURE_BITS) - 1));
+}
+
+void sprite_batch_draw(sprite_batch_t* batch, const sprite_t* sprite) {
+	render_entry_t entry = {
+		.key = sprite_batch_key(sprite),
+		.index = (uint32_t)list_size(&batch->sprites)
+	};
+	list_add(&batch->sprites, (void*)sprite);
+	list_add(&batch->entries, &entry);
+}
+
+static GLubyte sprite_batch_unorm8(float value) {
+	value = value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
+	return (GLubyte)(value * 255.0f + 0.5f);
+}
+
+static void sprite_batch_write(sprite_vertex_t* quad, const sprite_t* sprite) {
+	float half_x = sprite->size.x * 0.5f;
+	float half_y = sprite->size.y * 0.5f;
+	float corners[4][2] = { { -half_x, -half_y }, { half_x, -half_y }, { half_x, half_y }, { -half_x, half_y } };
+	// The texture has its origin at the bottom-left, the top of the sprite reads v1
+	float uvs[4][2] = {
+		{ sprite->uv.u0, sprite->uv.v1 }, { sprite->uv.u1, sprite->uv.v1 },
+		{ sprite->uv.u1, sprite->uv.v0 }, { sprite->uv.u0, sprite->uv.v0 }
+	};
+	GLubyte color[4] = {
+		sprite_batch_unorm8(sprite->color.r), sprite_batch_unorm8(sprite->color.g),
+		sprite_batch_unorm8(sprite->color.b), sprite_batch_unorm8(sprite->color.a)
+	};
+
+	// Most sprites are not rotated, they skip the trigonometry
+	float c = 1.0f;
+	float s = 0.0f;
+	if (sprite->rotation != 0.0f) {
+		c = cosf(sprite->rotation);
+		s = sinf(sprite->rotation);
+	}
+
+	for (int i = 0; i < 4; i++) {
+		quad[i].x = sprite->position.x + corners[i][0] * c - corners[i][1] * s;
+		quad[i].y = sprite->position.y + corners[i][0] * s + corners[i][1] * c;
+		quad[i].u = uvs[i][0];
+		quad[i].v = uvs[i][1];
+		memcpy(quad[i].color, color, sizeof(color));
+	}
+}
+
+// Four vertices per sprite in sorted order, so every page reads a contiguous range
+static GLintptr sprite_batch_upload(sprite_batch_t* batch) {
+	size_t count = list_size(&batch->entries);
+	const render_entry_t* entries = (const render_entry_t*)batch->entries.array;
+	const sprite_t* sprites = (const sprite_t*)batch->sprites.array;
+
+	GLintptr offset;
+	GLsizeiptr size = (GLsizeiptr)(count * 4 * sizeof(sprite_vertex_t));
+	sprite_vertex_t* vertices = (sprite_vertex_t*)stream_buffer_map(&batch->vertices, size, &offset);
+	for (size_t i = 0; i < count; i++) {
+		sprite_batch_write(&vertices[i * 4], &sprites[entries[i].index]);
+	}
+	stream_buffer_unmap(&batch->vertices);
+	return offset;
+}
+
+sprite_stats_t sprite_batch_end(sprite_batch_t* batch) {
+	sprite_stats_t stats = { 0 };
+	size_t count = list_size(&batch->entries);
+	if (count == 0) {
+		batch->stats = stats;
+		return stats;
+	}
+
+	render_entries_sort(&batch->entries, &batch->scratch);
+	if ((int)count > batch->index_capacity) {
+		int capacity = batch->index_capacity;
+		while (capacity < (int)count) {
+			capacity *= 2;
+		}
+		sprite_batch_build_indices(batch, capacity);
+	}
+	GLintptr offset = sprite_batch_upload(batch);
+
+	// Without base vertex on an unaligned offset the attributes point at this frame's vertices
+	vao_bind(&batch->vao);
+	stream_buffer_bind(&batch->vertices);
+	vao_link_vbo_2f2f4ub(offset);
+
+	ipair_t window = gfx_get_window_size();
+	mat4_t projection = mat4_orthographic(0.0f, (float)window.first, (float)window.second, 0.0f, -1.0f, 1.0f);
+	program_set(shader_mgr_program(batch->program));
+	program_set_uniform_mat4f(batch->uniform_projection, &projection);
+	program_set_uniform1i(batch->uniform_texture, 0);
+	gl_state_set_capability(GL_BLEND, true);
+	gl_state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	const render_entry_t* entries = (const render_entry_t*)batch->entries.array;
+	const sprite_t* sprites = (const sprite_t*)batch->sprites.array;
+	for (size_t first = 0, last = 0; first < count; first = last) {
+		texture_handle_t texture = sprites[entries[first].index].texture;
+		last = first + 1;
+		while (last < count && sprites[entries[last].index].texture == texture) {
+			last++;
+		}
+
+		texture_mgr_bind(texture, 0);
+		glDrawElements(GL_TRIANGLES, (GLsizei)((last - first) * 6), GL_UNSIGNED_INT, (const GLvoid*)(first * 6 * sizeof(unsigned int)));
+		stats.draws++;
+	}
+	gl_state_set_capability(GL_BLEND, false);
+
+	stats.sprites = (int)count;
+	batch->stats = stats;
+	return stats;
+}
+
+void sprite_batch_free(sprite_batch_t* batch) {
+	list_free(&batch->sprites);
+	list_free(&batch->entries);
+	list_free(&batch->scratch);
+	stream_buffer_delete(&batch->vertices);
+	ebo_delete(&batch->ebo);
+	vao_delete(&batch->vao);
+	shader_mgr_release(batch->program);
+}
+
+sprite_t sprite_from_texture(texture_handle_t texture, vec2_t position, vec2_t size) {
+	return (sprite_t){
+		.texture = texture,
+		.uv = { 0.0f, 0.0f, 1.0f, 1.0f },
+		.position = position,
+		.size = size,
+		.rotation = 0.0f,
+		.color = color_get_white(),
+		.layer = 0
+	};
+}
+
+// Sized to the sprite's texels, one pixel each
+sprite_t sprite_from_atlas(const atlas_t* atlas, const char* sprite_name, vec2_t position) {
+	const atlas_sprite_t* sprite = atlas_find(atlas, sprite_name);
+	if (sprite == NULL) {
+		fprintf(stderr, "sprite %s not found in atlas %s.\n", sprite_name, atlas->name);
+		exit(EXIT_FAILURE);
+	}
+
+	sprite_t result = sprite_from_texture(atlas->texture, position, vec2_new((float)sprite->width, (float)sprite->height));
+	result.uv = sprite->uv;
+	return result;
+}
@@ -0,0 +1,222 @@
+/**
+* @file de_static_batch.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_util.h"
+#include "../../include/de_math.h"
+#include "../../include/de_camera.h"
+#include "../../include/de_static_batch.h"
+
+#define STATIC_BATCH_NAME_SIZE 32
+
+static int batch_count = 0; // names the merged meshes apart in the mesh manager
+
+static void* static_batch_alloc(size_t size) {
+	void* memory = malloc(size);
+	if (memory == NULL) {
+		fprintf(stderr, "failed to allocate memory for static batch.\n");
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+void static_batch_init(static_batch_t* batch, const char* vertex_shader, const char* fragment_shader) {
+	// World space vertices are stored packed: float positions need no dequantization
+	batch->program = shader_mgr_acquire_variant(vertex_shader, fragment_shader, SHADER_PACKED_VERTEX);
+	if (batch->program == PROGRAM_HANDLE_INVALID) {
+		fprintf(stderr, "failed to compile shaders.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	program_t* program = shader_mgr_program(batch->program);
+	batch->uniform_model = program_find_uniform(program, NAME_HASH(MODEL));
+	batch->uniform_texture = program_find_uniform(program, NAME_HASH(TEXTURE));
+	batch->uniform_dequant_scale = program_find_uniform(program, NAME_HASH(DEQUANT_SCALE));
+	batch->uniform_dequant_offset = program_find_uniform(program, NAME_HASH(DEQUANT_OFFSET));
+
+	batch->model = mat4_identity();
+	list_init(&batch->groups, sizeof(static_group_t));
+}
+
+static static_group_t* static_batch_group(static_batch_t* batch, texture_handle_t texture, const material_t* material) {
+	for (size_t i = 0; i < list_size(&batch->groups); i++) {
+		static_group_t* group = (static_group_t*)list_get(&batch->groups, i);
+		if (group->texture == texture && memcmp(&group->material, material, sizeof(material_t)) == 0) {
+			return group;
+		}
+	}
+
+	static_group_t group = { .texture = texture, .material = *material, .mesh = MESH_HANDLE_INVALID };
+	list_init(&group.sources, sizeof(static_source_t));
+	texture_mgr_retain(texture);
+	list_add(&batch->groups, &group);
+	return (static_group_t*)list_get(&batch->groups, list_size(&batch->groups) - 1);
+}
+
+// Takes what it needs from the object, which can be deleted right after
+void static_batch_add(static_batch_t* batch, const game_object_t* go, const material_t* material) {
+	static_group_t* group = static_batch_group(batch, go->texture, material);
+	static_source_t source = { go->mesh, go->model, go->world_sphere };
+	mesh_mgr_retain(go->mesh);
+	list_add(&group->sources, &source);
+}
+
+static mesh_t* static_batch_merge(static_group_t* group) {
+	size_t source_count = list_size(&group->sources);
+	int vertex_count = 0;
+	int index_count = 0;
+	for (size_t i = 0; i < source_count; i++) {
+		const static_source_t* source = (const static_source_t*)list_get(&group->sources, i);
+		const mesh_t* mesh = mesh_mgr_get(source->mesh)->mesh;
+		vertex_count += mesh->vertex_count;
+		index_count += mesh->lods[0].index_count;
+	}
+
+	mesh_t* merged = mesh_new();
+	memset(merged, 0, sizeof(mesh_t));
+	merged->vertices = (vertex_t*)static_batch_alloc(sizeof(vertex_t) * vertex_count);
+	merged->indices = (unsigned int*)static_batch_alloc(sizeof(unsigned int) * index_count);
+	merged->meshlets = (meshlet_t*)static_batch_alloc(sizeof(meshlet_t) * source_count);
+	merged->meshlet_draws.counts = (GLsizei*)static_batch_alloc(sizeof(GLsizei) * source_count);
+	merged->meshlet_draws.offsets = (const GLvoid**)static_batch_alloc(sizeof(GLvoid*) * source_count);
+	merged->vertex_count = vertex_count;
+	merged->index_count = index_count;
+	merged->meshlet_count = (int)source_count;
+
+	int base_vertex = 0;
+	int base_index = 0;
+	for (size_t i = 0; i < source_count; i++) {
+		const static_source_t* source = (const static_source_t*)list_get(&group->sources, i);
+		const mesh_t* mesh = mesh_mgr_get(source->mesh)->mesh;
+		mat3_t normal_matrix = mat4_normal_matrix(&source->model);
+
+		for (int v = 0; v < mesh->vertex_count; v++) {
+			const vertex_t* vertex = &mesh->vertices[v];
+			vertex_t* world = &merged->vertices[base_vertex + v];
+			vec4_t position = vec4_new(vertex->position.x, vertex->position.y, vertex->position.z, 1.0f);
+			vec4_t world_position = mat4_mul_vec4(&source->model, &position);
+			vec3_t normal = mat3_mul_vec3(&normal_matrix, &vertex->normal);
+			world->position = vec3_new(world_position.x, world_position.y, world_position.z);
+			world->normal = vec3_normalized(normal);
+			world->uv = vertex->uv;
+		}
+
+		// Full detail only, distance does not pick levels for a mesh spread over the scene.
+		// A mirroring model turns the triangles inside out, their winding is flipped back.
+		const mesh_lod_t* level = &mesh->lods[0];
+		bool mirrored = mat4_determinant(&source->model) < 0.0f;
+		for (int n = 0; n < level->index_count; n++) {
+			int corner = mirrored && n % 3 != 0 ? n + (n % 3 == 1 ? 1 : -1) : n;
+			merged->indices[base_index + n] = mesh->indices[level->index_offset + corner] + (unsigned int)base_vertex;
+		}
+
+		// One meshlet per object, culled by its bounding sphere only
+		merged->meshlets[i] = (meshlet_t){
+			.index_offset = base_index,
+			.index_count = level->index_count,
+			.vertex_count = mesh->vertex_count,
+			.center = source->sphere.center,
+			.radius = source->sphere.radius,
+			.cone_axis = vec3_zero(),
+			.cone_cutoff = 1.0f
+		};
+
+		base_vertex += mesh->vertex_count;
+		base_index += level->index_count;
+	}
+
+	merged->lods[0] = (mesh_lod_t){ 0, index_count, 0.0f };
+	merged->lod_count = 1;
+	mesh_compute_bounds(merged);
+	return merged;
+}
+
+void static_batch_build(static_batch_t* batch) {
+	int objects = 0;
+	for (size_t i = 0; i < list_size(&batch->groups); i++) {
+		static_group_t* group = (static_group_t*)list_get(&batch->groups, i);
+		if (group->mesh != MESH_HANDLE_INVALID || list_size(&group->sources) == 0) {
+			continue;
+		}
+
+		char name[STATIC_BATCH_NAME_SIZE];
+		snprintf(name, sizeof(name), "static batch %d", batch_count++);
+		group->mesh = mesh_mgr_adopt(name, static_batch_merge(group), VERTEX_FORMAT_PACKED);
+
+		// The world space copy is all the batch draws, the object meshes can go
+		for (size_t j = 0; j < list_size(&group->sources); j++) {
+			mesh_mgr_release(((static_source_t*)list_get(&group->sources, j))->mesh);
+		}
+		objects += (int)list_size(&group->sources);
+		list_clear(&group->sources);
+	}
+	printf("Static batch: %d objects in %d draws\n", objects, (int)list_size(&batch->groups));
+}
+
+void static_batch_submit(static_batch_t* batch, render_queue_t* queue, const frustum_t* frustum) {
+	for (size_t i = 0; i < list_size(&batch->groups); i++) {
+		static_group_t* group = (static_group_t*)list_get(&batch->groups, i);
+		if (group->mesh == MESH_HANDLE_INVALID) {
+			continue;
+		}
+		mesh_t* mesh = mesh_mgr_get(group->mesh)->mesh;
+		if (!frustum_test_aabb(frustum, &mesh->bounds)) {
+			continue;
+		}
+
+		render_item_t item = {
+			.program = batch->program,
+			.material = material_buffer(&group->material),
+			.texture = group->texture,
+			.mesh = group->mesh,
+			.lod = 0,
+			.model = &batch->model,
+			.instanced = false,
+			.uniform_model = batch->uniform_model,
+			.uniform_texture = batch->uniform_texture,
+			.uniform_dequant_scale = batch->uniform_dequant_scale,
+			.uniform_dequant_offset = batch->uniform_dequant_offset
+		};
+		render_queue_submit(queue, RENDER_PASS_OPAQUE, &item, &mesh->sphere.center);
+	}
+}
+
+// The texture is assumed to span each object once, the closest one decides the mips
+void static_batch_request_textures(const static_batch_t* batch, const vec3_t* eye) {
+	for (size_t i = 0; i < batch->groups.size; i++) {
+		const static_group_t* group = &((const static_group_t*)batch->groups.array)[i];
+		if (group->mesh == MESH_HANDLE_INVALID) {
+			continue;
+		}
+
+		const mesh_t* mesh = mesh_mgr_get(group->mesh)->mesh;
+		float screen_size = 0.0f;
+		for (int j = 0; j < mesh->meshlet_count; j++) {
+			const meshlet_t* part = &mesh->meshlets[j];
+			vec3_t offset = vec3_sub(&part->center, eye);
+			float distance = maxf(vec3_magnitude(&offset) - part->radius, 0.0001f);
+			screen_size = maxf(screen_size, 2.0f * part->radius * camera_projection_scale() / distance);
+		}
+		texture_mgr_request(group->texture, screen_size);
+	}
+}
+
+void static_batch_free(static_batch_t* batch) {
+	for (size_t i = 0; i < list_size(&batch->groups); i++) {
+		static_group_t* group = (static_group_t*)list_get(&batch->groups, i);
+		for (size_t j = 0; j < list_size(&group->sources); j++) {
+			mesh_mgr_release(((static_source_t*)list_get(&group->sources, j))->mesh);
+		}
+		if (group->mesh != MESH_HANDLE_INVALID) {
+			mesh_mgr_release(group->mesh);
+		}
+		texture_mgr_release(group->texture);
+		list_free(&group->sources);
+	}
+	list_free(&batch->groups);
+	shader_mgr_release(batch->program);
+}
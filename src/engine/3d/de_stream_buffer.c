@@ -0,0 +1,157 @@
+/**
+* @file de_stream_buffer.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_buffer.h"
+
+#define STREAM_BUFFER_MIN_ALIGNMENT 16
+
+static void stream_buffer_drop_fences(stream_buffer_t* stream) {
+	for (int i = 0; i < STREAM_BUFFER_FRAMES; i++) {
+		if (stream->fences[i] != NULL) {
+			glDeleteSync(stream->fences[i]);
+			stream->fences[i] = NULL;
+		}
+	}
+}
+
+// Fresh storage for the whole ring. Draws already issued keep reading the old one,
+// so nothing has to be waited on and every fence can go.
+static void stream_buffer_orphan(stream_buffer_t* stream) {
+	stream_buffer_bind(stream);
+	glBufferData(stream->target, stream->segment_size * STREAM_BUFFER_FRAMES, NULL, GL_STREAM_DRAW);
+	stream_buffer_drop_fences(stream);
+}
+
+void stream_buffer_init(stream_buffer_t* stream, GLenum target, GLsizeiptr segment_size) {
+	stream->target = target;
+	stream->alignment = STREAM_BUFFER_MIN_ALIGNMENT;
+	if (target == GL_UNIFORM_BUFFER) {
+		GLint alignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		stream->alignment = alignment > STREAM_BUFFER_MIN_ALIGNMENT ? alignment : STREAM_BUFFER_MIN_ALIGNMENT;
+	}
+	stream->segment_size = (segment_size + stream->alignment - 1) / stream->alignment * stream->alignment;
+	stream->segment = 0;
+	stream->head = 0;
+	for (int i = 0; i < STREAM_BUFFER_FRAMES; i++) {
+		stream->fences[i] = NULL;
+	}
+	stream->map_offset = -1;
+	stream->map_size = 0;
+	stream->staged = false;
+	stream->staging = NULL;
+	stream->staging_size = 0;
+	stream->orphans = 0;
+	stream->grows = 0;
+
+	glGenBuffers(1, &stream->id);
+	stream_buffer_bind(stream);
+	glBufferData(target, stream->segment_size * STREAM_BUFFER_FRAMES, NULL, GL_STREAM_DRAW);
+}
+
+void stream_buffer_begin_frame(stream_buffer_t* stream) {
+	// Every draw reading the last frame's segment has been issued by now
+	if (stream->head > 0) {
+		stream->fences[stream->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	stream->segment = (stream->segment + 1) % STREAM_BUFFER_FRAMES;
+	stream->head = 0;
+
+	GLsync fence = stream->fences[stream->segment];
+	if (fence == NULL) {
+		return;
+	}
+	// Polled, not waited on: a GPU more than two frames behind gets new storage instead of a stall
+	GLenum status = glClientWaitSync(fence, 0, 0);
+	glDeleteSync(fence);
+	stream->fences[stream->segment] = NULL;
+	if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+		stream_buffer_orphan(stream);
+		stream->orphans++;
+	}
+}
+
+// Room for size bytes in this frame's segment. A frame that outgrows it gets segments big
+// enough for all of it, offsets handed out earlier in the frame point into the old storage.
+static GLintptr stream_buffer_reserve(stream_buffer_t* stream, GLsizeiptr size) {
+	GLsizeiptr head = (stream->head + stream->alignment - 1) / stream->alignment * stream->alignment;
+	if (head + size > stream->segment_size) {
+		while (head + size > stream->segment_size) {
+			stream->segment_size *= 2;
+		}
+		stream_buffer_orphan(stream);
+		stream->segment = 0;
+		head = 0;
+		stream->grows++;
+	}
+	stream->head = head + size;
+	return stream->segment * stream->segment_size + head;
+}
+
+void* stream_buffer_map(stream_buffer_t* stream, GLsizeiptr size, GLintptr* offset) {
+	*offset = stream_buffer_reserve(stream, size);
+	stream->map_offset = *offset;
+	stream->map_size = size;
+
+	// The fences keep the GPU out of this range, the driver has nothing to synchronize
+	stream_buffer_bind(stream);
+	void* data = glMapBufferRange(stream->target, *offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+	stream->staged = data == NULL;
+	if (!stream->staged) {
+		return data;
+	}
+
+	// Written to memory of our own and copied by stream_buffer_unmap
+	if (stream->staging_size < size) {
+		void* staging = realloc(stream->staging, (size_t)size);
+		if (staging == NULL) {
+			fprintf(stderr, "failed to allocate memory for stream buffer.\n");
+			exit(EXIT_FAILURE);
+		}
+		stream->staging = staging;
+		stream->staging_size = size;
+	}
+	return stream->staging;
+}
+
+void stream_buffer_unmap(stream_buffer_t* stream) {
+	stream_buffer_bind(stream);
+	if (stream->staged) {
+		glBufferSubData(stream->target, stream->map_offset, stream->map_size, stream->staging);
+	}
+	else {
+		glUnmapBuffer(stream->target);
+	}
+	stream->map_offset = -1;
+	stream->map_size = 0;
+}
+
+GLintptr stream_buffer_write(stream_buffer_t* stream, const GLvoid* data, GLsizeiptr size) {
+	GLintptr offset;
+	void* target = stream_buffer_map(stream, size, &offset);
+	memcpy(target, data, (size_t)size);
+	stream_buffer_unmap(stream);
+	return offset;
+}
+
+void stream_buffer_bind(stream_buffer_t* stream) {
+	gl_state_bind_buffer(stream->target, stream->id);
+}
+
+void stream_buffer_bind_range(stream_buffer_t* stream, GLuint binding, GLintptr offset, GLsizeiptr size) {
+	gl_state_bind_buffer_range(stream->target, binding, stream->id, offset, size);
+}
+
+void stream_buffer_delete(stream_buffer_t* stream) {
+	stream_buffer_drop_fences(stream);
+	gl_state_forget_buffer(stream->id);
+	glDeleteBuffers(1, &stream->id);
+	free(stream->staging);
+	stream->staging = NULL;
+	stream->staging_size = 0;
+}
@@ -7,7 +7,42 @@
 * @copyright Copyright (c) 2024, Dodoi-Lab
 */
 #include "../../include/de_buffer.h"
-void tbo_flip_surface(SDL_Surface* surface);
+#include "../../include/de_bc.h"
+
+bool tbo_sampler_reads_mips(const sampler_t* sampler) {
+    return sampler->min_filter != GL_LINEAR && sampler->min_filter != GL_NEAREST;
+}
+
+static void tbo_apply_sampler(const sampler_t* sampler) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, sampler->wrap_s);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, sampler->wrap_t);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, sampler->min_filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, sampler->mag_filter);
+}
+
+// Zero when the driver can't sample the blocks directly
+static GLenum tbo_compressed_format(dtex_format_t format) {
+    switch (format) {
+    case DTEX_FORMAT_BC1:
+        return GLAD_GL_EXT_texture_compression_s3tc ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : 0;
+    case DTEX_FORMAT_BC3:
+        return GLAD_GL_EXT_texture_compression_s3tc ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : 0;
+    case DTEX_FORMAT_BC7:
+        return GLAD_GL_ARB_texture_compression_bptc ? GL_COMPRESSED_RGBA_BPTC_UNORM_ARB : 0;
+    default:
+        return 0;
+    }
+}
+
+static bc_format_t tbo_bc_format(dtex_format_t format) {
+    return format == DTEX_FORMAT_BC1 ? BC1 : format == DTEX_FORMAT_BC3 ? BC3 : BC7;
+}
+
+// Uncompressed layouts by channel count, one channel is read as red
+static void tbo_pixel_format(int channels, GLenum* format, GLint* internal_format) {
+    *format = channels == 4 ? GL_RGBA : channels == 3 ? GL_RGB : GL_RED;
+    *internal_format = channels == 4 ? GL_RGBA8 : channels == 3 ? GL_RGB8 : GL_R8;
+}
 
 tbo_t* tbo_new(void) {
 	tbo_t* tbo = (tbo_t*)malloc(sizeof(tbo_t));
@@ -27,91 +62,185 @@ void tbo_init(tbo_t* tbo, const char* path) {
 }
 
 void tbo_bind(tbo_t* tbo) {
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, tbo->id);
+	gl_state_active_texture(0);
+	gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
 }
 
 void tbo_bind_slot(tbo_t* tbo, GLuint slot) {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, tbo->id);
+    gl_state_active_texture(slot);
+    gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
 }
 
 bool tbo_load(tbo_t* tbo) {
-    SDL_Surface* surface = IMG_Load(tbo->path);
-    if (surface == NULL) {
-        fprintf(stderr, "failed to load texture: %s.\n", tbo->path);
+    sampler_t sampler = SAMPLER_DEFAULT;
+    return tbo_load_sampler(tbo, &sampler);
+}
+
+bool tbo_load_sampler(tbo_t* tbo, const sampler_t* sampler) {
+    // A cooked copy already holds every mip level, upload it straight from the mapping
+    dtex_t dtex;
+    if (dtex_open_cooked(&dtex, tbo->path)) {
+        tbo_upload_dtex(tbo, sampler, &dtex, dtex_data(&dtex));
+        dtex_close(&dtex);
+        return true;
+    }
+
+    unsigned char* pixels = tbo_decode(tbo->path, &tbo->width, &tbo->height, &tbo->channels);
+    if (pixels == NULL) {
         return false;
     }
 
-    tbo_flip_surface(surface);
-    GLenum format = GL_RGB;
-    if (surface->format->BytesPerPixel == 4) {
-        format = GL_RGBA;
+    tbo_upload(tbo, sampler, pixels);
+    free(pixels);
+    return true;
+}
+
+unsigned char* tbo_decode(const char* path, int* width, int* height, int* channels) {
+    SDL_Surface* surface = IMG_Load(path);
+    if (surface == NULL) {
+        fprintf(stderr, "failed to load texture: %s.\n", path);
+        return NULL;
     }
 
-    tbo->width = surface->w;
-    tbo->height = surface->h;
-    tbo->channels = surface->format->BytesPerPixel;
+    // Normalize paletted and odd layouts to plain RGB or RGBA bytes
+    bool alpha = surface->format->Amask != 0 || SDL_ISPIXELFORMAT_ALPHA(surface->format->format);
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, alpha ? SDL_PIXELFORMAT_RGBA32 : SDL_PIXELFORMAT_RGB24, 0);
+    SDL_FreeSurface(surface);
+    if (converted == NULL) {
+        fprintf(stderr, "failed to convert texture: %s.\n", path);
+        return NULL;
+    }
 
-    glBindTexture(GL_TEXTURE_2D, tbo->id);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    *width = converted->w;
+    *height = converted->h;
+    *channels = alpha ? 4 : 3;
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, tbo->width, tbo->height, 0, format, GL_UNSIGNED_BYTE, surface->pixels);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    size_t row = (size_t)*width * *channels;
+    unsigned char* pixels = (unsigned char*)malloc(row * *height);
+    if (pixels == NULL) {
+        fprintf(stderr, "failed to allocate memory for texture pixels.\n");
+        exit(EXIT_FAILURE);
+    }
 
-    SDL_FreeSurface(surface);
-    return true;
+    // Rows are packed tightly and flipped, GL expects the bottom row first
+    const unsigned char* source = (const unsigned char*)converted->pixels;
+    for (int y = 0; y < *height; y++) {
+        memcpy(pixels + (size_t)(*height - 1 - y) * row, source + (size_t)y * converted->pitch, row);
+    }
+
+    SDL_FreeSurface(converted);
+    return pixels;
 }
 
-void tbo_map_texture(tbo_t* tbo, GLuint texture_unit) {
-    glActiveTexture(GL_TEXTURE0 + texture_unit);
-    glBindTexture(GL_TEXTURE_2D, tbo->id);
+void tbo_upload(tbo_t* tbo, const sampler_t* sampler, const GLvoid* pixels) {
+    GLenum format;
+    GLint internal_format;
+    tbo_pixel_format(tbo->channels, &format, &internal_format);
+
+    gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
+    tbo_apply_sampler(sampler);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, tbo->width, tbo->height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // Mipmaps have to be built from the uploaded level, and only when the sampler reads them
+    if (tbo_sampler_reads_mips(sampler)) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
 }
 
-void tbo_unbind(void) {
-	glBindTexture(GL_TEXTURE_2D, 0);
+// Expects the texture bound and GL_UNPACK_ALIGNMENT at 1
+static void tbo_upload_level(const dtex_t* dtex, int level_index, const GLvoid* pixels) {
+    const dtex_level_t* level = &dtex->levels[level_index];
+    dtex_format_t dtex_format = (dtex_format_t)dtex->header->format;
+    GLenum compressed_format = tbo_compressed_format(dtex_format);
+
+    if (compressed_format != 0) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level_index, compressed_format, (GLsizei)level->width, (GLsizei)level->height, 0, (GLsizei)level->size, pixels);
+    }
+    else if (dtex_is_compressed(dtex)) {
+        // Without the extension the blocks are expanded here, pixels has to be client memory then
+        unsigned char* decoded = (unsigned char*)malloc((size_t)level->width * level->height * 4);
+        if (decoded == NULL) {
+            fprintf(stderr, "failed to allocate memory for texture pixels.\n");
+            exit(EXIT_FAILURE);
+        }
+        bc_decode_image(tbo_bc_format(dtex_format), (const unsigned char*)pixels, (int)level->width, (int)level->height, decoded);
+        glTexImage2D(GL_TEXTURE_2D, level_index, GL_RGBA8, (GLsizei)level->width, (GLsizei)level->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, decoded);
+        free(decoded);
+    }
+    else {
+        GLenum format;
+        GLint internal_format;
+        tbo_pixel_format((int)dtex->header->channels, &format, &internal_format);
+        glTexImage2D(GL_TEXTURE_2D, level_index, internal_format, (GLsizei)level->width, (GLsizei)level->height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    }
 }
 
-void tbo_delete(tbo_t* tbo) {
-	glDeleteTextures(1, &tbo->id);
+bool tbo_supports_dtex(const dtex_t* dtex) {
+    return !dtex_is_compressed(dtex) || tbo_compressed_format((dtex_format_t)dtex->header->format) != 0;
 }
 
-void tbo_destroy(tbo_t* tbo) {
-	tbo_delete(tbo);
-	free(tbo);
+void tbo_upload_dtex(tbo_t* tbo, const sampler_t* sampler, const dtex_t* dtex, const GLvoid* data) {
+    tbo_upload_dtex_from(tbo, sampler, dtex, 0, data);
 }
 
-void tbo_flip_surface(SDL_Surface* surface) {
-    if (SDL_LockSurface(surface) < 0) {
-        fprintf(stderr, "failed to lock surface.\n");
-        return; // Failed to lock surface
-    }
+void tbo_upload_dtex_from(tbo_t* tbo, const sampler_t* sampler, const dtex_t* dtex, int first_level, const GLvoid* data) {
+    const dtex_header_t* header = dtex->header;
+    tbo->width = (int)header->width;
+    tbo->height = (int)header->height;
+    tbo->channels = (int)header->channels;
+
+    int last_level = tbo_sampler_reads_mips(sampler) ? (int)header->level_count - 1 : first_level;
 
-    int pitch = surface->pitch;        // row size
-    char* temp = (char*)malloc(pitch); // intermediate buffer
-    if (temp == NULL) {
-        SDL_UnlockSurface(surface);
-        fprintf(stderr, "failed to allocate memory for flip surface.\n");
-        return; // Memory allocation failed
+    gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
+    tbo_apply_sampler(sampler);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, first_level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, last_level);
+
+    // data is the first level, either in client memory or as an offset into a bound unpack buffer
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = first_level; i <= last_level; i++) {
+        tbo_upload_level(dtex, i, (const GLubyte*)data + (dtex->levels[i].offset - dtex->levels[first_level].offset));
     }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
 
-    char* pixels = (char*)surface->pixels;
+void tbo_upload_dtex_level(tbo_t* tbo, const dtex_t* dtex, int level, const GLvoid* pixels) {
+    gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    tbo_upload_level(dtex, level, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
 
-    for (int i = 0; i < surface->h / 2; ++i) {
-        // get pointers to the two rows to swap
-        char* row1 = pixels + i * pitch;
-        char* row2 = pixels + (surface->h - i - 1) * pitch;
+void tbo_evict_level(tbo_t* tbo, int level) {
+    // An empty image gives the storage back, the level is outside the sampled range by now
+    gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
+    glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+}
 
-        // swap rows
-        memcpy(temp, row1, pitch);
-        memcpy(row1, row2, pitch);
-        memcpy(row2, temp, pitch);
-    }
+void tbo_set_level_range(tbo_t* tbo, int base_level, int max_level) {
+    gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, base_level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, max_level);
+}
+
+void tbo_map_texture(tbo_t* tbo, GLuint texture_unit) {
+    gl_state_active_texture(texture_unit);
+    gl_state_bind_texture(GL_TEXTURE_2D, tbo->id);
+}
+
+void tbo_unbind(void) {
+	gl_state_bind_texture(GL_TEXTURE_2D, 0);
+}
 
-    free(temp);
-    SDL_UnlockSurface(surface);
+void tbo_delete(tbo_t* tbo) {
+	gl_state_forget_texture(tbo->id);
+	glDeleteTextures(1, &tbo->id);
+}
+
+void tbo_destroy(tbo_t* tbo) {
+	tbo_delete(tbo);
+	free(tbo);
 }
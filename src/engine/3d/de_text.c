@@ -0,0 +1,106 @@
+/**
+* @file de_text.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_font.h"
+
+typedef void (*text_emit_t)(void* context, const text_glyph_t* glyph);
+
+typedef struct {
+	sprite_batch_t* batch;
+	vec2_t position;
+	color_t color;
+	int layer;
+} text_target_t;
+
+// The pen starts on the first baseline and drops a line height at every '\n'.
+// Returns the bounds: the widest line by every line.
+static vec2_t text_layout(const font_t* font, const char* text, float size, text_emit_t emit, void* context) {
+	float scale = size / font->size;
+	float pen = 0.0f;
+	float baseline = font->ascent * scale;
+	float width = 0.0f;
+	int lines = 1;
+	char previous = '\0';
+
+	for (const char* c = text; *c != '\0'; c++) {
+		if (*c == '\n') {
+			width = pen > width ? pen : width;
+			pen = 0.0f;
+			baseline += font->line_height * scale;
+			lines++;
+			previous = '\0';
+			continue;
+		}
+
+		const font_glyph_t* glyph = font_glyph(font, *c);
+		if (previous != '\0') {
+			pen += font_kerning(font, previous, *c) * scale;
+		}
+		if (glyph->page >= 0 && emit != NULL) {
+			text_glyph_t quad = {
+				.texture = font->pages[glyph->page],
+				.uv = glyph->uv,
+				.position = vec2_new(pen + glyph->x * scale, baseline + glyph->y * scale),
+				.size = vec2_new(glyph->width * scale, glyph->height * scale)
+			};
+			emit(context, &quad);
+		}
+		pen += glyph->advance * scale;
+		previous = *c;
+	}
+
+	width = pen > width ? pen : width;
+	return vec2_new(width, lines * font->line_height * scale);
+}
+
+static void text_emit_glyph(void* context, const text_glyph_t* glyph) {
+	list_add((list_t*)context, (void*)glyph);
+}
+
+static void text_emit_sprite(void* context, const text_glyph_t* glyph) {
+	const text_target_t* target = (const text_target_t*)context;
+	sprite_t sprite = {
+		.texture = glyph->texture,
+		.uv = glyph->uv,
+		.position = vec2_new(target->position.x + glyph->position.x + glyph->size.x * 0.5f,
+			target->position.y + glyph->position.y + glyph->size.y * 0.5f),
+		.size = glyph->size,
+		.rotation = 0.0f,
+		.color = target->color,
+		.layer = target->layer
+	};
+	sprite_batch_draw(target->batch, &sprite);
+}
+
+void text_run_init(text_run_t* run, const font_t* font, const char* text, float size) {
+	list_init_size(&run->glyphs, sizeof(text_glyph_t), strlen(text) + 1);
+	run->bounds = text_layout(font, text, size, text_emit_glyph, &run->glyphs);
+}
+
+// Laid out already, each glyph only moves to the position
+void text_run_draw(const text_run_t* run, sprite_batch_t* batch, vec2_t position, color_t color, int layer) {
+	text_target_t target = { batch, position, color, layer };
+	const text_glyph_t* glyphs = (const text_glyph_t*)run->glyphs.array;
+	for (size_t i = 0; i < run->glyphs.size; i++) {
+		text_emit_sprite(&target, &glyphs[i]);
+	}
+}
+
+void text_run_free(text_run_t* run) {
+	list_free(&run->glyphs);
+}
+
+// Strings that change every frame, laid out straight into the batch with nothing kept
+void text_draw(sprite_batch_t* batch, const font_t* font, const char* text, float size, vec2_t position, color_t color, int layer) {
+	text_target_t target = { batch, position, color, layer };
+	text_layout(font, text, size, text_emit_sprite, &target);
+}
+
+vec2_t text_measure(const font_t* font, const char* text, float size) {
+	return text_layout(font, text, size, NULL, NULL);
+}
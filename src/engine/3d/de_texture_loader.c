@@ -0,0 +1,175 @@
+/**
+* @file de_texture_loader.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_buffer.h"
+#include "../../include/de_texture_loader.h"
+
+#define TEXTURE_LOADER_MAX_WORKERS 4
+
+// Workers take jobs from the pending list, decode them and append them to the
+// finished list, the GL thread drains that one. Both lists are FIFO.
+typedef struct {
+	texture_job_t* head;
+	texture_job_t* tail;
+} texture_job_list_t;
+
+static SDL_Thread* workers[TEXTURE_LOADER_MAX_WORKERS];
+static int worker_count = 0;
+static SDL_mutex* lock = NULL;
+static SDL_cond* wake = NULL;
+static bool stopping = false;
+
+static texture_job_list_t pending = { NULL, NULL };
+static texture_job_list_t finished = { NULL, NULL };
+
+static void texture_job_list_push(texture_job_list_t* list, texture_job_t* job) {
+	job->next = NULL;
+	if (list->tail != NULL) {
+		list->tail->next = job;
+	}
+	else {
+		list->head = job;
+	}
+	list->tail = job;
+}
+
+static texture_job_t* texture_job_list_pop(texture_job_list_t* list) {
+	texture_job_t* job = list->head;
+	if (job != NULL) {
+		list->head = job->next;
+		if (list->head == NULL) {
+			list->tail = NULL;
+		}
+	}
+	return job;
+}
+
+static int texture_loader_worker(void* data) {
+	(void)data;
+	while (true) {
+		SDL_LockMutex(lock);
+		while (pending.head == NULL && !stopping) {
+			SDL_CondWait(wake, lock);
+		}
+		if (stopping) {
+			SDL_UnlockMutex(lock);
+			return 0;
+		}
+		texture_job_t* job = texture_job_list_pop(&pending);
+		SDL_UnlockMutex(lock);
+
+		if (dtex_open_cooked(&job->dtex, job->path)) {
+			dtex_prefetch(&job->dtex);
+		}
+		else {
+			job->pixels = tbo_decode(job->path, &job->width, &job->height, &job->channels);
+		}
+
+		SDL_LockMutex(lock);
+		texture_job_list_push(&finished, job);
+		SDL_UnlockMutex(lock);
+	}
+}
+
+static void texture_loader_init(void) {
+	lock = SDL_CreateMutex();
+	wake = SDL_CreateCond();
+	if (lock == NULL || wake == NULL) {
+		fprintf(stderr, "failed to create texture loader sync: %s.\n", SDL_GetError());
+		exit(EXIT_FAILURE);
+	}
+
+	// Leave a core to the main thread
+	int count = SDL_GetCPUCount() - 1;
+	count = count < 1 ? 1 : count > TEXTURE_LOADER_MAX_WORKERS ? TEXTURE_LOADER_MAX_WORKERS : count;
+
+	stopping = false;
+	for (worker_count = 0; worker_count < count; worker_count++) {
+		workers[worker_count] = SDL_CreateThread(texture_loader_worker, "texture_loader", NULL);
+		if (workers[worker_count] == NULL) {
+			fprintf(stderr, "failed to create texture loader thread: %s.\n", SDL_GetError());
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+texture_job_t* texture_loader_submit(const char* path, void* owner) {
+	if (worker_count == 0) {
+		texture_loader_init();
+	}
+
+	texture_job_t* job = (texture_job_t*)malloc(sizeof(texture_job_t));
+	char* job_path = (char*)malloc(strlen(path) + 1);
+	if (job == NULL || job_path == NULL) {
+		fprintf(stderr, "failed to allocate memory for texture job.\n");
+		exit(EXIT_FAILURE);
+	}
+	strcpy(job_path, path);
+
+	job->path = job_path;
+	job->owner = owner;
+	job->pixels = NULL;
+	job->width = 0;
+	job->height = 0;
+	job->channels = 0;
+	job->dtex = (dtex_t){ 0 };
+
+	SDL_LockMutex(lock);
+	texture_job_list_push(&pending, job);
+	SDL_CondSignal(wake);
+	SDL_UnlockMutex(lock);
+	return job;
+}
+
+texture_job_t* texture_loader_poll(void) {
+	if (worker_count == 0) {
+		return NULL;
+	}
+	SDL_LockMutex(lock);
+	texture_job_t* job = texture_job_list_pop(&finished);
+	SDL_UnlockMutex(lock);
+	return job;
+}
+
+void texture_loader_free_job(texture_job_t* job) {
+	if (job->dtex.base != NULL) {
+		dtex_close(&job->dtex);
+	}
+	free(job->pixels);
+	free(job->path);
+	free(job);
+}
+
+void texture_loader_shutdown(void) {
+	if (worker_count == 0) {
+		return;
+	}
+
+	SDL_LockMutex(lock);
+	stopping = true;
+	SDL_CondBroadcast(wake);
+	SDL_UnlockMutex(lock);
+
+	for (int i = 0; i < worker_count; i++) {
+		SDL_WaitThread(workers[i], NULL);
+	}
+	worker_count = 0;
+
+	texture_job_t* job;
+	while ((job = texture_job_list_pop(&pending)) != NULL) {
+		texture_loader_free_job(job);
+	}
+	while ((job = texture_job_list_pop(&finished)) != NULL) {
+		texture_loader_free_job(job);
+	}
+
+	SDL_DestroyCond(wake);
+	SDL_DestroyMutex(lock);
+	wake = NULL;
+	lock = NULL;
+}
@@ -0,0 +1,479 @@
+/**
+* @file de_texture_manager.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_util.h"
+#include "../../include/de_collection.h"
+#include "../../include/de_texture_manager.h"
+
+// Same layout as the mesh registry: stable pointers in the slots, NULL marks a free slot.
+static list_t textures;
+static bool initialized = false;
+
+static tbo_t placeholder = { 0 };
+static GLuint staging_pbo = 0;
+
+static size_t stream_budget = (size_t)TEXTURE_STREAM_BUDGET_MB * 1024 * 1024;
+static size_t stream_usage = 0;
+
+static shared_texture_t* texture_mgr_slot(texture_handle_t handle) {
+	return *(shared_texture_t**)list_get(&textures, (size_t)handle);
+}
+
+static bool sampler_equals(const sampler_t* a, const sampler_t* b) {
+	return a->wrap_s == b->wrap_s
+		&& a->wrap_t == b->wrap_t
+		&& a->min_filter == b->min_filter
+		&& a->mag_filter == b->mag_filter;
+}
+
+static tbo_t* texture_mgr_placeholder(void) {
+	if (placeholder.id == 0) {
+		static const unsigned char white[] = { 255, 255, 255, 255 };
+		sampler_t sampler = { GL_REPEAT, GL_REPEAT, GL_NEAREST, GL_NEAREST };
+		tbo_init(&placeholder, "placeholder");
+		placeholder.width = 1;
+		placeholder.height = 1;
+		placeholder.channels = 4;
+		tbo_upload(&placeholder, &sampler, white);
+	}
+	return &placeholder;
+}
+
+static texture_handle_t texture_mgr_find(const char* path, const sampler_t* sampler, bool streamed) {
+	for (size_t i = 0; i < list_size(&textures); i++) {
+		shared_texture_t* shared = texture_mgr_slot((texture_handle_t)i);
+		if (shared != NULL && shared->streamed == streamed && sampler_equals(&shared->sampler, sampler) && strcmp(shared->path, path) == 0) {
+			return (texture_handle_t)i;
+		}
+	}
+	return TEXTURE_HANDLE_INVALID;
+}
+
+static texture_handle_t texture_mgr_insert(shared_texture_t* shared) {
+	for (size_t i = 0; i < list_size(&textures); i++) {
+		shared_texture_t** slot = (shared_texture_t**)list_get(&textures, i);
+		if (*slot == NULL) {
+			*slot = shared;
+			return (texture_handle_t)i;
+		}
+	}
+	list_add(&textures, &shared);
+	return (texture_handle_t)(list_size(&textures) - 1);
+}
+
+static shared_texture_t* texture_mgr_create(const char* path, const sampler_t* sampler) {
+	if (!initialized) {
+		list_init(&textures, sizeof(shared_texture_t*));
+		initialized = true;
+	}
+
+	shared_texture_t* shared = (shared_texture_t*)malloc(sizeof(shared_texture_t));
+	char* key = (char*)malloc(strlen(path) + 1);
+	if (shared == NULL || key == NULL) {
+		fprintf(stderr, "failed to allocate memory for shared texture.\n");
+		exit(EXIT_FAILURE);
+	}
+	strcpy(key, path);
+
+	shared->path = key;
+	shared->sampler = *sampler;
+	shared->ref_count = 1;
+	shared->ready = false;
+	shared->job = NULL;
+	shared->failed = false;
+	shared->streamed = false;
+	shared->dtex = (dtex_t){ 0 };
+	shared->resident_level = 0;
+	shared->tail_level = 0;
+	shared->screen_size = 0.0f;
+	shared->resident_bytes = 0;
+
+	// The tbo keeps pointing at the registry key, which lives as long as the texture
+	tbo_init(&shared->tbo, shared->path);
+	return shared;
+}
+
+static void texture_mgr_free(shared_texture_t* shared) {
+	if (shared->streamed) {
+		stream_usage -= shared->resident_bytes;
+		dtex_close(&shared->dtex);
+	}
+	tbo_delete(&shared->tbo);
+	free(shared->path);
+	free(shared);
+}
+
+texture_handle_t texture_mgr_acquire(const char* path, const sampler_t* sampler) {
+	texture_handle_t handle = initialized ? texture_mgr_find(path, sampler, false) : TEXTURE_HANDLE_INVALID;
+	if (handle != TEXTURE_HANDLE_INVALID) {
+		texture_mgr_slot(handle)->ref_count++;
+		return handle;
+	}
+
+	shared_texture_t* shared = texture_mgr_create(path, sampler);
+	if (!tbo_load_sampler(&shared->tbo, sampler)) {
+		texture_mgr_free(shared);
+		return TEXTURE_HANDLE_INVALID;
+	}
+	shared->ready = true;
+
+	return texture_mgr_insert(shared);
+}
+
+texture_handle_t texture_mgr_acquire_async(const char* path, const sampler_t* sampler) {
+	texture_handle_t handle = initialized ? texture_mgr_find(path, sampler, false) : TEXTURE_HANDLE_INVALID;
+	if (handle != TEXTURE_HANDLE_INVALID) {
+		texture_mgr_slot(handle)->ref_count++;
+		return handle;
+	}
+
+	shared_texture_t* shared = texture_mgr_create(path, sampler);
+	shared->job = texture_loader_submit(path, shared);
+
+	return texture_mgr_insert(shared);
+}
+
+static size_t texture_mgr_level_bytes(const shared_texture_t* shared, int level) {
+	const dtex_level_t* dtex_level = &shared->dtex.levels[level];
+	// Blocks the driver can't sample are kept expanded to RGBA
+	return tbo_supports_dtex(&shared->dtex) ? dtex_level->size : (size_t)dtex_level->width * dtex_level->height * 4;
+}
+
+texture_handle_t texture_mgr_acquire_streamed(const char* path, const sampler_t* sampler) {
+	texture_handle_t handle = initialized ? texture_mgr_find(path, sampler, true) : TEXTURE_HANDLE_INVALID;
+	if (handle != TEXTURE_HANDLE_INVALID) {
+		texture_mgr_slot(handle)->ref_count++;
+		return handle;
+	}
+
+	// Streaming works off the cooked mip chain, anything else loads whole in the background
+	dtex_t dtex;
+	if (!tbo_sampler_reads_mips(sampler) || !dtex_open_cooked(&dtex, path)) {
+		return texture_mgr_acquire_async(path, sampler);
+	}
+
+	shared_texture_t* shared = texture_mgr_create(path, sampler);
+	shared->streamed = true;
+	shared->dtex = dtex;
+
+	int tail_level = (int)dtex.header->level_count - 1;
+	while (tail_level > 0 && dtex.levels[tail_level - 1].width <= TEXTURE_STREAM_TAIL_SIZE && dtex.levels[tail_level - 1].height <= TEXTURE_STREAM_TAIL_SIZE) {
+		tail_level--;
+	}
+	shared->tail_level = tail_level;
+	shared->resident_level = tail_level;
+
+	// The tail is a few kilobytes, it goes up right away so the texture is never blank
+	tbo_upload_dtex_from(&shared->tbo, sampler, &dtex, tail_level, dtex.base + dtex.levels[tail_level].offset);
+	for (int i = tail_level; i < (int)dtex.header->level_count; i++) {
+		shared->resident_bytes += texture_mgr_level_bytes(shared, i);
+	}
+	stream_usage += shared->resident_bytes;
+	shared->ready = true;
+
+	return texture_mgr_insert(shared);
+}
+
+void texture_mgr_retain(texture_handle_t handle) {
+	texture_mgr_get(handle)->ref_count++;
+}
+
+void texture_mgr_release(texture_handle_t handle) {
+	shared_texture_t* shared = texture_mgr_get(handle);
+	if (--shared->ref_count > 0) {
+		return;
+	}
+
+	if (shared->job != NULL) {
+		shared->job->owner = NULL; // the decode finishes and gets dropped in texture_mgr_update
+	}
+	texture_mgr_free(shared);
+	*(shared_texture_t**)list_get(&textures, (size_t)handle) = NULL;
+}
+
+shared_texture_t* texture_mgr_get(texture_handle_t handle) {
+	shared_texture_t* shared = NULL;
+	if (initialized && handle >= 0 && (size_t)handle < list_size(&textures)) {
+		shared = texture_mgr_slot(handle);
+	}
+	if (shared == NULL) {
+		fprintf(stderr, "invalid texture handle %d.\n", handle);
+		exit(EXIT_FAILURE);
+	}
+	return shared;
+}
+
+void texture_mgr_bind(texture_handle_t handle, GLuint slot) {
+	shared_texture_t* shared = texture_mgr_get(handle);
+	tbo_bind_slot(shared->ready ? &shared->tbo : texture_mgr_placeholder(), slot);
+}
+
+bool texture_mgr_is_ready(texture_handle_t handle) {
+	return texture_mgr_get(handle)->ready;
+}
+
+bool texture_mgr_has_failed(texture_handle_t handle) {
+	return texture_mgr_get(handle)->failed;
+}
+
+void texture_mgr_request(texture_handle_t handle, float screen_size) {
+	shared_texture_t* shared = texture_mgr_get(handle);
+	shared->screen_size = screen_size > shared->screen_size ? screen_size : shared->screen_size;
+}
+
+void texture_mgr_set_stream_budget(size_t bytes) {
+	stream_budget = bytes;
+}
+
+size_t texture_mgr_stream_usage(void) {
+	return stream_usage;
+}
+
+int texture_mgr_count(void) {
+	int count = 0;
+	if (initialized) {
+		for (size_t i = 0; i < list_size(&textures); i++) {
+			count += texture_mgr_slot((texture_handle_t)i) != NULL;
+		}
+	}
+	return count;
+}
+
+static void texture_mgr_upload(shared_texture_t* shared, const texture_job_t* job, const GLvoid* data) {
+	if (job->dtex.base != NULL) {
+		tbo_upload_dtex(&shared->tbo, &shared->sampler, &job->dtex, data);
+	}
+	else {
+		tbo_upload(&shared->tbo, &shared->sampler, data);
+	}
+}
+
+// Orphan the previous storage so the copy never waits on an upload still in flight,
+// the upload then sources from the bound buffer at offset 0 and the driver can return
+// straight away. Falls back to the client pointer when the buffer can't be mapped.
+static const GLvoid* texture_mgr_staging_begin(const void* pixels, GLsizeiptr size) {
+	if (staging_pbo == 0) {
+		glGenBuffers(1, &staging_pbo);
+	}
+
+	gl_state_bind_buffer(GL_PIXEL_UNPACK_BUFFER, staging_pbo);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+	void* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (staging == NULL) {
+		gl_state_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return pixels;
+	}
+	memcpy(staging, pixels, (size_t)size);
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	return (const GLvoid*)0;
+}
+
+static void texture_mgr_staging_end(void) {
+	gl_state_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+static void texture_mgr_stage(shared_texture_t* shared, const texture_job_t* job) {
+	bool cooked = job->dtex.base != NULL;
+	const void* pixels = cooked ? (const void*)dtex_data(&job->dtex) : (const void*)job->pixels;
+	GLsizeiptr size = cooked ? (GLsizeiptr)dtex_data_size(&job->dtex) : (GLsizeiptr)job->width * job->height * job->channels;
+	shared->tbo.width = job->width;
+	shared->tbo.height = job->height;
+	shared->tbo.channels = job->channels;
+
+	// Blocks the driver can't sample are expanded on the CPU, straight from the mapping
+	if (cooked && !tbo_supports_dtex(&job->dtex)) {
+		texture_mgr_upload(shared, job, pixels);
+	}
+	else {
+		texture_mgr_upload(shared, job, texture_mgr_staging_begin(pixels, size));
+		texture_mgr_staging_end();
+	}
+	shared->ready = true;
+}
+
+static int texture_mgr_wanted_level(const shared_texture_t* shared) {
+	if (shared->screen_size <= 0.0f) {
+		return shared->tail_level;
+	}
+	const dtex_header_t* header = shared->dtex.header;
+	float texels = (float)(header->width > header->height ? header->width : header->height);
+	int level = (int)floorf(log2f(texels / shared->screen_size));
+	return level < 0 ? 0 : level > shared->tail_level ? shared->tail_level : level;
+}
+
+// Texels per screen pixel at a level, the higher it is the less that level is missed
+static float texture_mgr_density(const shared_texture_t* shared, int level) {
+	const dtex_level_t* dtex_level = &shared->dtex.levels[level];
+	float texels = (float)(dtex_level->width > dtex_level->height ? dtex_level->width : dtex_level->height);
+	return texels / (shared->screen_size > 1.0f ? shared->screen_size : 1.0f);
+}
+
+static void texture_mgr_evict(shared_texture_t* shared) {
+	int level = shared->resident_level++;
+	tbo_set_level_range(&shared->tbo, shared->resident_level, (int)shared->dtex.header->level_count - 1);
+	tbo_evict_level(&shared->tbo, level);
+
+	size_t bytes = texture_mgr_level_bytes(shared, level);
+	shared->resident_bytes -= bytes;
+	stream_usage -= bytes;
+}
+
+static void texture_mgr_raise(shared_texture_t* shared) {
+	int level = shared->resident_level - 1;
+	const dtex_level_t* dtex_level = &shared->dtex.levels[level];
+	const unsigned char* pixels = shared->dtex.base + dtex_level->offset;
+
+	if (tbo_supports_dtex(&shared->dtex)) {
+		tbo_upload_dtex_level(&shared->tbo, &shared->dtex, level, texture_mgr_staging_begin(pixels, (GLsizeiptr)dtex_level->size));
+		texture_mgr_staging_end();
+	}
+	else {
+		tbo_upload_dtex_level(&shared->tbo, &shared->dtex, level, pixels);
+	}
+
+	// Sampled only once the whole level is there
+	shared->resident_level = level;
+	tbo_set_level_range(&shared->tbo, level, (int)shared->dtex.header->level_count - 1);
+
+	size_t bytes = texture_mgr_level_bytes(shared, level);
+	shared->resident_bytes += bytes;
+	stream_usage += bytes;
+}
+
+// The streamed texture whose finest level is least needed, if it is denser than min_density
+static shared_texture_t* texture_mgr_stream_victim(const shared_texture_t* keep, float min_density) {
+	shared_texture_t* victim = NULL;
+	float victim_density = min_density;
+	for (size_t i = 0; i < list_size(&textures); i++) {
+		shared_texture_t* shared = texture_mgr_slot((texture_handle_t)i);
+		if (shared == NULL || !shared->streamed || shared == keep || shared->resident_level >= shared->tail_level) {
+			continue;
+		}
+		float density = texture_mgr_density(shared, shared->resident_level);
+		if (density > victim_density) {
+			victim = shared;
+			victim_density = density;
+		}
+	}
+	return victim;
+}
+
+static void texture_mgr_stream(Uint64 start, Uint64 budget) {
+	if (!initialized) {
+		return;
+	}
+
+	// Over budget, after it was lowered for instance, the least needed levels go first
+	shared_texture_t* victim;
+	while (stream_usage > stream_budget && (victim = texture_mgr_stream_victim(NULL, -1.0f)) != NULL) {
+		texture_mgr_evict(victim);
+	}
+
+	// One level at a time, coarse to fine, always for the texture missing detail the most.
+	// Room is only made by dropping levels that are denser than the new one would be, so
+	// two textures never trade the same memory back and forth.
+	while (SDL_GetPerformanceCounter() - start <= budget) {
+		shared_texture_t* candidate = NULL;
+		float candidate_density = FLT_MAX;
+		for (size_t i = 0; i < list_size(&textures); i++) {
+			shared_texture_t* shared = texture_mgr_slot((texture_handle_t)i);
+			if (shared == NULL || !shared->streamed || shared->resident_level <= texture_mgr_wanted_level(shared)) {
+				continue;
+			}
+			float density = texture_mgr_density(shared, shared->resident_level);
+			if (density < candidate_density) {
+				candidate = shared;
+				candidate_density = density;
+			}
+		}
+		if (candidate == NULL) {
+			break;
+		}
+
+		int level = candidate->resident_level - 1;
+		size_t bytes = texture_mgr_level_bytes(candidate, level);
+		float density = texture_mgr_density(candidate, level);
+		while (stream_usage + bytes > stream_budget && (victim = texture_mgr_stream_victim(candidate, density)) != NULL) {
+			texture_mgr_evict(victim);
+		}
+		if (stream_usage + bytes > stream_budget) {
+			break;
+		}
+		texture_mgr_raise(candidate);
+	}
+
+	// Requests only hold for the frame they were made in
+	for (size_t i = 0; i < list_size(&textures); i++) {
+		shared_texture_t* shared = texture_mgr_slot((texture_handle_t)i);
+		if (shared != NULL) {
+			shared->screen_size = 0.0f;
+		}
+	}
+}
+
+void texture_mgr_update(float budget_ms) {
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = (Uint64)(budget_ms * SDL_GetPerformanceFrequency() / 1000.0);
+
+	// At least one upload per call, then stop as soon as the frame budget is spent
+	texture_job_t* job;
+	while (SDL_GetPerformanceCounter() - start <= budget && (job = texture_loader_poll()) != NULL) {
+		shared_texture_t* shared = (shared_texture_t*)job->owner;
+		if (shared != NULL) {
+			shared->job = NULL;
+			if (job->pixels != NULL || job->dtex.base != NULL) {
+				texture_mgr_stage(shared, job);
+			}
+			else {
+				fprintf(stderr, "failed to load texture: %s.\n", shared->path);
+				shared->failed = true;
+			}
+		}
+		texture_loader_free_job(job);
+	}
+
+	// Streaming gets whatever is left of the budget
+	texture_mgr_stream(start, budget);
+}
+
+void texture_mgr_shutdown(void) {
+	texture_loader_shutdown();
+
+	if (initialized) {
+		for (size_t i = 0; i < list_size(&textures); i++) {
+			shared_texture_t* shared = texture_mgr_slot((texture_handle_t)i);
+			if (shared != NULL) {
+				shared->job = NULL;
+			}
+		}
+	}
+	if (staging_pbo != 0) {
+		glDeleteBuffers(1, &staging_pbo);
+		staging_pbo = 0;
+	}
+	if (placeholder.id != 0) {
+		tbo_delete(&placeholder);
+		placeholder.id = 0;
+	}
+}
+
+void texture_mgr_pre_cook(list_t* textures) {
+	for (size_t i = 0; i < list_size(textures); ++i) {
+		const char* name = *(const char**)list_get(textures, i);
+		char* source_path = create_texture_path(name);
+		char* cooked_path = dtex_cooked_path(source_path);
+
+		// Also re-cooks files left behind by an older cooker or an edited source
+		if (!dtex_is_current(cooked_path, source_path)) {
+			dtex_cook(source_path, cooked_path, DTEX_FLAG_SRGB, DTEX_COMPRESSION_BC);
+		}
+
+		free(source_path);
+		free(cooked_path);
+	}
+}
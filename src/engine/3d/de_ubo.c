@@ -0,0 +1,32 @@
+/**
+* @file de_ubo.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_buffer.h"
+
+void ubo_init(ubo_t* ubo, GLsizeiptr size) {
+	ubo->size = size;
+	glGenBuffers(1, &ubo->id);
+	gl_state_bind_buffer(GL_UNIFORM_BUFFER, ubo->id);
+	glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+}
+
+void ubo_set_data(ubo_t* ubo, const GLvoid* data, GLsizeiptr size) {
+	// Fresh storage every time, the driver never waits for draws still reading the old contents
+	gl_state_bind_buffer(GL_UNIFORM_BUFFER, ubo->id);
+	glBufferData(GL_UNIFORM_BUFFER, ubo->size, NULL, GL_DYNAMIC_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+}
+
+void ubo_bind_base(ubo_t* ubo, GLuint binding) {
+	gl_state_bind_buffer_base(GL_UNIFORM_BUFFER, binding, ubo->id);
+}
+
+void ubo_delete(ubo_t* ubo) {
+	gl_state_forget_buffer(ubo->id);
+	glDeleteBuffers(1, &ubo->id);
+}
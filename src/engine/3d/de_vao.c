@@ -23,7 +23,7 @@ void vao_init(vao_t* vao) {
 }
 
 void vao_bind(vao_t* vao) {
-	glBindVertexArray(vao->id);
+	gl_state_bind_vertex_array(vao->id);
 }
 
 void vao_link_vbo_1f(const GLuint layout) {
@@ -106,12 +106,74 @@ void vao_link_vbo_3f3f3f() {
 	glEnableVertexAttribArray(2);
 }
 
+void vao_link_vbo_packed() {
+	// Position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, STRIDE_3f_2s_2h, (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// Normal attribute (octahedral, snorm16)
+	glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, STRIDE_3f_2s_2h, (void*)(STRIDE_3f));
+	glEnableVertexAttribArray(1);
+
+	// Texture attribute (half float)
+	glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, STRIDE_3f_2s_2h, (void*)(STRIDE_3f + 2 * sizeof(GLshort)));
+	glEnableVertexAttribArray(2);
+}
+
+void vao_link_vbo_packed_quantized() {
+	// Position attribute (int16, dequantized in the shader)
+	glVertexAttribPointer(0, 3, GL_SHORT, GL_FALSE, STRIDE_4s_2s_2h, (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// Normal attribute (octahedral, snorm16)
+	glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, STRIDE_4s_2s_2h, (void*)(4 * sizeof(GLshort)));
+	glEnableVertexAttribArray(1);
+
+	// Texture attribute (half float)
+	glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, STRIDE_4s_2s_2h, (void*)(6 * sizeof(GLshort)));
+	glEnableVertexAttribArray(2);
+}
+
+void vao_link_vbo_instances(GLintptr offset) {
+	// One column per location, advancing once per instance instead of once per vertex.
+	// Without base instance in 4.1 every batch points them at its own offset.
+	for (GLuint column = 0; column < 4; column++) {
+		GLuint layout = INSTANCE_MODEL_LAYOUT + column;
+		glVertexAttribPointer(layout, 4, GL_FLOAT, GL_FALSE, STRIDE_16f_12f, (void*)(offset + column * STRIDE_4f));
+		glVertexAttribDivisor(layout, 1);
+		glEnableVertexAttribArray(layout);
+	}
+
+	// Normal matrix, three columns padded to vec4
+	for (GLuint column = 0; column < 3; column++) {
+		GLuint layout = INSTANCE_NORMAL_LAYOUT + column;
+		glVertexAttribPointer(layout, 3, GL_FLOAT, GL_FALSE, STRIDE_16f_12f, (void*)(offset + (4 + column) * STRIDE_4f));
+		glVertexAttribDivisor(layout, 1);
+		glEnableVertexAttribArray(layout);
+	}
+}
+
+void vao_link_vbo_2f2f4ub(GLintptr offset) {
+	// Position attribute
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, STRIDE_2f_2f_4ub, (void*)offset);
+	glEnableVertexAttribArray(0);
+
+	// Texture attribute
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, STRIDE_2f_2f_4ub, (void*)(offset + STRIDE_2f));
+	glEnableVertexAttribArray(1);
+
+	// Color attribute (unorm8)
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, STRIDE_2f_2f_4ub, (void*)(offset + STRIDE_4f));
+	glEnableVertexAttribArray(2);
+}
+
 void vao_unbind(void) {
-	glBindVertexArray(0);
+	gl_state_bind_vertex_array(0);
 }
 
 void vao_delete(vao_t* vao) {
-	glDeleteVertexArrays(1, &vao->id);	
+	gl_state_forget_vertex_array(vao->id);
+	glDeleteVertexArrays(1, &vao->id);
 }
 
 void vao_destroy(vao_t* vao) {
@@ -21,20 +21,21 @@ void vbo_init(vbo_t* vbo) {
 	glGenBuffers(1, &vbo->id);
 }
 
-void vbo_set_data(vbo_t* vbo, GLfloat* vertices, GLsizeiptr size) {
+void vbo_set_data(vbo_t* vbo, const GLvoid* vertices, GLsizeiptr size) {
 	vbo_bind(vbo);
 	glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 }
 
 void vbo_bind(vbo_t* vbo) {
-	glBindBuffer(GL_ARRAY_BUFFER, vbo->id);
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, vbo->id);
 }
 
 void vbo_unbind(void) {
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, 0);
 }
 
 void vbo_delete(vbo_t* vbo) {
+	gl_state_forget_buffer(vbo->id);
 	glDeleteBuffers(1, &vbo->id);
 }
 
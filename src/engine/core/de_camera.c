@@ -17,3 +17,8 @@ mat4_t camera_perspective(const float z_near, const float z_far) {
 mat4_t camera_look_at(camera_t* camera) {
 	return mat4_look_at(&camera->eye, &camera->target, &camera->up);
 }
+
+float camera_projection_scale(void) {
+	ipair_t size = gfx_get_window_size();
+	return (float)size.second / (2.0f * tanf(deg_to_radf(FOV) * 0.5f));
+}
@@ -0,0 +1,143 @@
+/**
+* @file de_jobs.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_jobs.h"
+
+static SDL_Thread* workers[JOBS_MAX_WORKERS];
+static int worker_count = 0;
+static SDL_mutex* lock = NULL;
+static SDL_cond* wake = NULL;
+static SDL_cond* done = NULL;
+static bool stopping = false;
+
+// The batch being run. Parts are handed out one by one under the lock, a new batch
+// bumps the generation so sleeping workers know there is something to take.
+static job_func_t batch_func = NULL;
+static void* batch_data = NULL;
+static int batch_count = 0;
+static int batch_next = 0;
+static int batch_remaining = 0;
+static unsigned int batch_generation = 0;
+
+// Takes the parts left in the batch and runs them. Called with the lock held, returns with it held.
+static void jobs_work(void) {
+	while (batch_next < batch_count) {
+		job_func_t func = batch_func;
+		void* data = batch_data;
+		int part = batch_next++;
+		SDL_UnlockMutex(lock);
+
+		func(data, part);
+
+		SDL_LockMutex(lock);
+		if (--batch_remaining == 0) {
+			SDL_CondSignal(done);
+		}
+	}
+}
+
+static int jobs_worker(void* data) {
+	(void)data;
+	unsigned int generation = 0;
+	SDL_LockMutex(lock);
+	while (true) {
+		while (generation == batch_generation && !stopping) {
+			SDL_CondWait(wake, lock);
+		}
+		if (stopping) {
+			SDL_UnlockMutex(lock);
+			return 0;
+		}
+		generation = batch_generation;
+		jobs_work();
+	}
+}
+
+static void jobs_init(void) {
+	lock = SDL_CreateMutex();
+	wake = SDL_CreateCond();
+	done = SDL_CreateCond();
+	if (lock == NULL || wake == NULL || done == NULL) {
+		fprintf(stderr, "failed to create job sync: %s.\n", SDL_GetError());
+		exit(EXIT_FAILURE);
+	}
+
+	// The calling thread is one of the hands, the texture loader mostly sleeps
+	int count = SDL_GetCPUCount() - 1;
+	count = count < 1 ? 1 : count > JOBS_MAX_WORKERS ? JOBS_MAX_WORKERS : count;
+
+	stopping = false;
+	for (worker_count = 0; worker_count < count; worker_count++) {
+		workers[worker_count] = SDL_CreateThread(jobs_worker, "jobs", NULL);
+		if (workers[worker_count] == NULL) {
+			fprintf(stderr, "failed to create job thread: %s.\n", SDL_GetError());
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+void jobs_run(job_func_t func, void* data, int part_count) {
+	if (part_count <= 0) {
+		return;
+	}
+	// A single part is not worth waking anyone
+	if (part_count == 1) {
+		func(data, 0);
+		return;
+	}
+	if (worker_count == 0) {
+		jobs_init();
+	}
+
+	SDL_LockMutex(lock);
+	batch_func = func;
+	batch_data = data;
+	batch_count = part_count;
+	batch_next = 0;
+	batch_remaining = part_count;
+	batch_generation++;
+	SDL_CondBroadcast(wake);
+
+	jobs_work();
+	while (batch_remaining > 0) {
+		SDL_CondWait(done, lock);
+	}
+	batch_func = NULL;
+	batch_data = NULL;
+	SDL_UnlockMutex(lock);
+}
+
+int jobs_thread_count(void) {
+	if (worker_count == 0) {
+		jobs_init();
+	}
+	return worker_count + 1;
+}
+
+void jobs_shutdown(void) {
+	if (worker_count == 0) {
+		return;
+	}
+
+	SDL_LockMutex(lock);
+	stopping = true;
+	SDL_CondBroadcast(wake);
+	SDL_UnlockMutex(lock);
+
+	for (int i = 0; i < worker_count; i++) {
+		SDL_WaitThread(workers[i], NULL);
+	}
+	worker_count = 0;
+
+	SDL_DestroyCond(done);
+	SDL_DestroyCond(wake);
+	SDL_DestroyMutex(lock);
+	done = NULL;
+	wake = NULL;
+	lock = NULL;
+}
@@ -36,12 +36,19 @@ void handle_mouse_click(int mouse_x, int mouse_y, const mat4_t* view_matrix, con
 
             ray_t ray = { *camera_position, ray_world };
 
-            // Check intersection with all objects
+            // Closest object along the ray wins
+            int closest = -1;
+            float closest_distance = FLT_MAX;
             for (int i = 0; i < object_count; ++i) {
-                if (game_object_ray_intersect(&objects[i], &ray, i)) {
-                    printf("Object %d clicked!\n", i);
+                float distance;
+                if (game_object_ray_intersect(&objects[i], &ray, &distance) && distance < closest_distance) {
+                    closest = i;
+                    closest_distance = distance;
                 }
             }
+            if (closest >= 0) {
+                printf("Object %d clicked!\n", closest);
+            }
         }
     }
 }
@@ -64,7 +71,7 @@ vec4_t mouse_ray_from_ndc(float x, float y) {
 
 vec4_t mouse_ray_eye(const mat4_t* inverse_projection_matrix, const vec4_t* ray_clip) {
     vec4_t ray_eye = mat4_mul_vec4_sse(inverse_projection_matrix, ray_clip);
-	ray_eye.z = -1.0f;
+	ray_eye.z = 1.0f; // the view matrix looks down +z
     ray_eye.w = 0.0f;
 	return ray_eye;
 }
@@ -74,7 +81,7 @@ vec3_t mouse_ray_world(const mat4_t* inverse_view_matrix, const vec4_t* ray_eye)
     vec3_t ray_world_vec3 = vec4_to_vec3(&ray_world);
 
     printf("Before normalized Ray World: (%f, %f, %f)\n", ray_world.x, ray_world.y, ray_world.z);
-    vec3_t ray_world_normalized = vec3_normalized(&ray_world_vec3);
+    vec3_t ray_world_normalized = vec3_normalized(ray_world_vec3);
 	return ray_world_normalized;
 }
 
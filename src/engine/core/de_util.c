@@ -48,3 +48,34 @@ bool file_exists(const char* path) {
     }
     return false;
 }
+
+// Cooked data records the stamp of its source and is rebuilt when the source no longer matches
+uint64_t file_stamp(const char* path) {
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) {
+		return 0;
+	}
+	uint64_t stamp = hash_bytes(&data.nFileSizeHigh, sizeof(data.nFileSizeHigh), HASH_SEED);
+	stamp = hash_bytes(&data.nFileSizeLow, sizeof(data.nFileSizeLow), stamp);
+	stamp = hash_bytes(&data.ftLastWriteTime, sizeof(data.ftLastWriteTime), stamp);
+	return stamp != 0 ? stamp : 1;
+}
+
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+uint32_t hash_name(const char* name) {
+	uint32_t hash = NAME_HASH_BASIS;
+	for (size_t i = 0; i < NAME_HASH_LENGTH && name[i] != '\0'; i++) {
+		hash ^= (unsigned char)name[i];
+		hash *= NAME_HASH_PRIME;
+	}
+	return hash;
+}
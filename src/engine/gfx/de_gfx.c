@@ -8,6 +8,7 @@
 */
 #include "../../include/de_gfx.h"
 #include "../../include/de_color.h"
+#include "../../include/de_gl_state.h"
 
 static SDL_Window* window = NULL;
 static SDL_GLContext* context = NULL;
@@ -87,6 +88,9 @@ void gfx_init(bool fullscreen, bool vsync) {
     // Enable v-sync (set 1 to enable, 0 to disable)
     SDL_GL_SetSwapInterval(vsync ? 1 : 0);
     glViewport(0, 0, GFX_WINDOW_WIDTH, GFX_WINDOW_HEIGHT);
+
+    // Fresh context, nothing the state cache may have seen before applies to it
+    gl_state_reset();
 }
 
 SDL_Window* gfx_get_window(void) {
@@ -131,11 +135,11 @@ void gfx_swap_screen(void) {
 }
 
 void gfx_set_2d_mode(void) {
-	glDisable(GL_DEPTH_TEST);
+	gl_state_set_capability(GL_DEPTH_TEST, false);
 }
 
 void gfx_set_3d_mode(void) {
-	glEnable(GL_DEPTH_TEST);
+	gl_state_set_capability(GL_DEPTH_TEST, true);
 }
 
 SDL_Surface* gfx_load_texture(const char* path) {
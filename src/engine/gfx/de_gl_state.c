@@ -0,0 +1,344 @@
+/**
+* @file de_gl_state.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_gl_state.h"
+
+#define GL_STATE_CAPABILITY_UNKNOWN -1
+
+typedef struct {
+	GLuint program;
+	GLuint vertex_array;
+	GLuint array_buffer;
+	GLuint element_buffer; // belongs to the vertex array, unknown after switching it
+	GLuint uniform_buffer;
+	GLuint pixel_unpack_buffer;
+	GLuint uniform_bindings[GL_STATE_UNIFORM_BINDINGS];
+
+	GLuint active_unit;
+	GLuint textures[GL_STATE_TEXTURE_UNITS]; // GL_TEXTURE_2D of each unit
+	GLuint samplers[GL_STATE_TEXTURE_UNITS];
+
+	GLint depth_test;
+	GLint blend;
+	GLint cull_face;
+	GLenum blend_source;
+	GLenum blend_destination;
+	GLenum depth_func;
+	GLint depth_mask;
+} gl_state_t;
+
+static gl_state_t state;
+static bool initialized = false;
+static gl_state_stats_t stats = { 0, 0 };
+
+// Returns true when the call has to reach the driver, and remembers the new value
+static bool gl_state_change(GLuint* shadow, GLuint value) {
+	if (*shadow == value) {
+		stats.skipped++;
+		return false;
+	}
+	*shadow = value;
+	stats.issued++;
+	return true;
+}
+
+static void gl_state_init(void) {
+	if (!initialized) {
+		gl_state_reset();
+	}
+}
+
+void gl_state_reset(void) {
+	state.program = GL_STATE_UNKNOWN;
+	state.vertex_array = GL_STATE_UNKNOWN;
+	state.array_buffer = GL_STATE_UNKNOWN;
+	state.element_buffer = GL_STATE_UNKNOWN;
+	state.uniform_buffer = GL_STATE_UNKNOWN;
+	state.pixel_unpack_buffer = GL_STATE_UNKNOWN;
+	for (int i = 0; i < GL_STATE_UNIFORM_BINDINGS; i++) {
+		state.uniform_bindings[i] = GL_STATE_UNKNOWN;
+	}
+	state.active_unit = GL_STATE_UNKNOWN;
+	for (int i = 0; i < GL_STATE_TEXTURE_UNITS; i++) {
+		state.textures[i] = GL_STATE_UNKNOWN;
+		state.samplers[i] = GL_STATE_UNKNOWN;
+	}
+	state.depth_test = GL_STATE_CAPABILITY_UNKNOWN;
+	state.blend = GL_STATE_CAPABILITY_UNKNOWN;
+	state.cull_face = GL_STATE_CAPABILITY_UNKNOWN;
+	state.blend_source = GL_STATE_UNKNOWN;
+	state.blend_destination = GL_STATE_UNKNOWN;
+	state.depth_func = GL_STATE_UNKNOWN;
+	state.depth_mask = GL_STATE_CAPABILITY_UNKNOWN;
+	initialized = true;
+}
+
+void gl_state_use_program(GLuint program) {
+	gl_state_init();
+	if (gl_state_change(&state.program, program)) {
+		glUseProgram(program);
+	}
+}
+
+void gl_state_bind_vertex_array(GLuint vertex_array) {
+	gl_state_init();
+	if (gl_state_change(&state.vertex_array, vertex_array)) {
+		glBindVertexArray(vertex_array);
+		state.element_buffer = GL_STATE_UNKNOWN;
+	}
+}
+
+static GLuint* gl_state_buffer(GLenum target) {
+	switch (target) {
+	case GL_ARRAY_BUFFER:
+		return &state.array_buffer;
+	case GL_ELEMENT_ARRAY_BUFFER:
+		return &state.element_buffer;
+	case GL_UNIFORM_BUFFER:
+		return &state.uniform_buffer;
+	case GL_PIXEL_UNPACK_BUFFER:
+		return &state.pixel_unpack_buffer;
+	default:
+		return NULL;
+	}
+}
+
+void gl_state_bind_buffer(GLenum target, GLuint buffer) {
+	gl_state_init();
+	GLuint* shadow = gl_state_buffer(target);
+	if (shadow == NULL || gl_state_change(shadow, buffer)) {
+		glBindBuffer(target, buffer);
+	}
+}
+
+void gl_state_bind_buffer_base(GLenum target, GLuint index, GLuint buffer) {
+	gl_state_init();
+	bool tracked = target == GL_UNIFORM_BUFFER && index < GL_STATE_UNIFORM_BINDINGS;
+	if (!tracked || gl_state_change(&state.uniform_bindings[index], buffer)) {
+		glBindBufferBase(target, index, buffer);
+		// Binds the generic target as well
+		GLuint* shadow = gl_state_buffer(target);
+		if (shadow != NULL) {
+			*shadow = buffer;
+		}
+	}
+}
+
+// Ranges move every frame, always issued. The binding is left unknown so the next
+// bind_base of the same buffer is not mistaken for a redundant one.
+void gl_state_bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+	gl_state_init();
+	glBindBufferRange(target, index, buffer, offset, size);
+	stats.issued++;
+	if (target == GL_UNIFORM_BUFFER && index < GL_STATE_UNIFORM_BINDINGS) {
+		state.uniform_bindings[index] = GL_STATE_UNKNOWN;
+	}
+	GLuint* shadow = gl_state_buffer(target);
+	if (shadow != NULL) {
+		*shadow = buffer;
+	}
+}
+
+void gl_state_active_texture(GLuint unit) {
+	gl_state_init();
+	if (gl_state_change(&state.active_unit, unit)) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+}
+
+void gl_state_bind_texture(GLenum target, GLuint texture) {
+	gl_state_init();
+	bool tracked = target == GL_TEXTURE_2D && state.active_unit < GL_STATE_TEXTURE_UNITS;
+	if (!tracked || gl_state_change(&state.textures[state.active_unit], texture)) {
+		glBindTexture(target, texture);
+	}
+}
+
+void gl_state_bind_sampler(GLuint unit, GLuint sampler) {
+	gl_state_init();
+	if (unit >= GL_STATE_TEXTURE_UNITS || gl_state_change(&state.samplers[unit], sampler)) {
+		glBindSampler(unit, sampler);
+	}
+}
+
+static GLint* gl_state_capability(GLenum capability) {
+	switch (capability) {
+	case GL_DEPTH_TEST:
+		return &state.depth_test;
+	case GL_BLEND:
+		return &state.blend;
+	case GL_CULL_FACE:
+		return &state.cull_face;
+	default:
+		return NULL;
+	}
+}
+
+void gl_state_set_capability(GLenum capability, bool enabled) {
+	gl_state_init();
+	GLint* shadow = gl_state_capability(capability);
+	if (shadow != NULL && *shadow == (GLint)enabled) {
+		stats.skipped++;
+		return;
+	}
+	if (shadow != NULL) {
+		*shadow = (GLint)enabled;
+	}
+	stats.issued++;
+	if (enabled) {
+		glEnable(capability);
+	}
+	else {
+		glDisable(capability);
+	}
+}
+
+void gl_state_blend_func(GLenum source, GLenum destination) {
+	gl_state_init();
+	if (state.blend_source == source && state.blend_destination == destination) {
+		stats.skipped++;
+		return;
+	}
+	state.blend_source = source;
+	state.blend_destination = destination;
+	stats.issued++;
+	glBlendFunc(source, destination);
+}
+
+void gl_state_depth_func(GLenum func) {
+	gl_state_init();
+	if (gl_state_change(&state.depth_func, func)) {
+		glDepthFunc(func);
+	}
+}
+
+void gl_state_depth_mask(GLboolean mask) {
+	gl_state_init();
+	if (state.depth_mask == (GLint)mask) {
+		stats.skipped++;
+		return;
+	}
+	state.depth_mask = (GLint)mask;
+	stats.issued++;
+	glDepthMask(mask);
+}
+
+void gl_state_forget_program(GLuint program) {
+	if (initialized && state.program == program) {
+		state.program = GL_STATE_UNKNOWN;
+	}
+}
+
+void gl_state_forget_vertex_array(GLuint vertex_array) {
+	if (initialized && state.vertex_array == vertex_array) {
+		state.vertex_array = 0;
+		state.element_buffer = GL_STATE_UNKNOWN;
+	}
+}
+
+void gl_state_forget_buffer(GLuint buffer) {
+	if (!initialized) {
+		return;
+	}
+	GLuint* shadows[] = { &state.array_buffer, &state.element_buffer, &state.uniform_buffer, &state.pixel_unpack_buffer };
+	for (int i = 0; i < 4; i++) {
+		if (*shadows[i] == buffer) {
+			*shadows[i] = 0;
+		}
+	}
+	for (int i = 0; i < GL_STATE_UNIFORM_BINDINGS; i++) {
+		if (state.uniform_bindings[i] == buffer) {
+			state.uniform_bindings[i] = 0;
+		}
+	}
+}
+
+void gl_state_forget_texture(GLuint texture) {
+	if (!initialized) {
+		return;
+	}
+	for (int i = 0; i < GL_STATE_TEXTURE_UNITS; i++) {
+		if (state.textures[i] == texture) {
+			state.textures[i] = 0;
+		}
+	}
+}
+
+gl_state_stats_t gl_state_stats(void) {
+	return stats;
+}
+
+void gl_state_reset_stats(void) {
+	stats = (gl_state_stats_t){ 0, 0 };
+}
+
+static bool gl_state_check(const char* name, GLuint shadow, GLint actual) {
+	if (shadow == GL_STATE_UNKNOWN || shadow == (GLuint)actual) {
+		return true;
+	}
+	fprintf(stderr, "gl state out of sync: %s is %d, cached %u.\n", name, actual, shadow);
+	return false;
+}
+
+// Reads the tracked state back from the driver, a full pipeline stall. Debugging only,
+// a mismatch means something called GL without going through here.
+bool gl_state_validate(void) {
+	gl_state_init();
+	GLint value = 0;
+	bool valid = true;
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &value);
+	valid &= gl_state_check("program", state.program, value);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value);
+	valid &= gl_state_check("vertex array", state.vertex_array, value);
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &value);
+	valid &= gl_state_check("array buffer", state.array_buffer, value);
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &value);
+	valid &= gl_state_check("element buffer", state.element_buffer, value);
+	glGetIntegerv(GL_UNIFORM_BUFFER_BINDING, &value);
+	valid &= gl_state_check("uniform buffer", state.uniform_buffer, value);
+	glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &value);
+	valid &= gl_state_check("pixel unpack buffer", state.pixel_unpack_buffer, value);
+	for (GLuint i = 0; i < GL_STATE_UNIFORM_BINDINGS; i++) {
+		glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, i, &value);
+		valid &= gl_state_check("uniform binding", state.uniform_bindings[i], value);
+	}
+
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &value);
+	GLint active_unit = value - GL_TEXTURE0;
+	valid &= gl_state_check("active texture", state.active_unit, active_unit);
+	for (GLuint i = 0; i < GL_STATE_TEXTURE_UNITS; i++) {
+		// Switching units behind the cache's back, the active one is put back below
+		glActiveTexture(GL_TEXTURE0 + i);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &value);
+		valid &= gl_state_check("texture", state.textures[i], value);
+		glGetIntegerv(GL_SAMPLER_BINDING, &value);
+		valid &= gl_state_check("sampler", state.samplers[i], value);
+	}
+	glActiveTexture(GL_TEXTURE0 + active_unit);
+
+	GLint capabilities[] = { state.depth_test, state.blend, state.cull_face };
+	GLenum names[] = { GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE };
+	for (int i = 0; i < 3; i++) {
+		if (capabilities[i] != GL_STATE_CAPABILITY_UNKNOWN) {
+			valid &= gl_state_check("capability", (GLuint)capabilities[i], glIsEnabled(names[i]));
+		}
+	}
+	glGetIntegerv(GL_DEPTH_FUNC, &value);
+	valid &= gl_state_check("depth func", state.depth_func, value);
+	glGetIntegerv(GL_BLEND_SRC_RGB, &value);
+	valid &= gl_state_check("blend source", state.blend_source, value);
+	glGetIntegerv(GL_BLEND_DST_RGB, &value);
+	valid &= gl_state_check("blend destination", state.blend_destination, value);
+	if (state.depth_mask != GL_STATE_CAPABILITY_UNKNOWN) {
+		GLboolean mask = GL_TRUE;
+		glGetBooleanv(GL_DEPTH_WRITEMASK, &mask);
+		valid &= gl_state_check("depth mask", (GLuint)state.depth_mask, mask);
+	}
+	return valid;
+}
@@ -0,0 +1,623 @@
+/**
+* @file de_bc.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_bc.h"
+
+#define BC_PIXELS 16
+#define BC_MAX_THREADS 16
+#define BC_POWER_ITERATIONS 8
+
+static const int bc7_weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static int bc_clamp(int value, int low, int high) {
+	return value < low ? low : value > high ? high : value;
+}
+
+static int bc_block_bytes(bc_format_t format) {
+	return format == BC1 ? 8 : 16;
+}
+
+// Reads a 4x4 block as RGBA floats, edges are clamped for sizes that aren't multiples of 4
+static void bc_fetch_block(const unsigned char* pixels, int width, int height, int channels, int block_x, int block_y, float block[BC_PIXELS][4]) {
+	for (int y = 0; y < BC_BLOCK_DIM; y++) {
+		int source_y = bc_clamp(block_y * BC_BLOCK_DIM + y, 0, height - 1);
+		for (int x = 0; x < BC_BLOCK_DIM; x++) {
+			int source_x = bc_clamp(block_x * BC_BLOCK_DIM + x, 0, width - 1);
+			const unsigned char* texel = pixels + ((size_t)source_y * width + source_x) * channels;
+			float* out = block[y * BC_BLOCK_DIM + x];
+			out[0] = texel[0];
+			out[1] = texel[1];
+			out[2] = texel[2];
+			out[3] = channels == 4 ? texel[3] : 255.0f;
+		}
+	}
+}
+
+// Principal axis of the block colors, the line the endpoints are fitted on
+static void bc_principal_axis(float block[BC_PIXELS][4], int components, float mean[4], float axis[4]) {
+	float covariance[4][4] = { 0 };
+	for (int c = 0; c < 4; c++) {
+		mean[c] = 0.0f;
+		for (int i = 0; i < BC_PIXELS; i++) {
+			mean[c] += block[i][c];
+		}
+		mean[c] /= BC_PIXELS;
+	}
+	for (int i = 0; i < BC_PIXELS; i++) {
+		for (int a = 0; a < components; a++) {
+			for (int b = 0; b < components; b++) {
+				covariance[a][b] += (block[i][a] - mean[a]) * (block[i][b] - mean[b]);
+			}
+		}
+	}
+
+	for (int c = 0; c < 4; c++) {
+		axis[c] = c < components ? 1.0f : 0.0f;
+	}
+	for (int iteration = 0; iteration < BC_POWER_ITERATIONS; iteration++) {
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float length = 0.0f;
+		for (int a = 0; a < components; a++) {
+			for (int b = 0; b < components; b++) {
+				next[a] += covariance[a][b] * axis[b];
+			}
+			length = fmaxf(length, fabsf(next[a]));
+		}
+		if (length < FLT_EPSILON) {
+			break;
+		}
+		for (int a = 0; a < components; a++) {
+			axis[a] = next[a] / length;
+		}
+	}
+}
+
+static void bc_fit_endpoints(float block[BC_PIXELS][4], int components, float e0[4], float e1[4]) {
+	float mean[4];
+	float axis[4];
+	bc_principal_axis(block, components, mean, axis);
+
+	float t_min = FLT_MAX;
+	float t_max = -FLT_MAX;
+	for (int i = 0; i < BC_PIXELS; i++) {
+		float t = 0.0f;
+		for (int c = 0; c < components; c++) {
+			t += (block[i][c] - mean[c]) * axis[c];
+		}
+		t_min = fminf(t_min, t);
+		t_max = fmaxf(t_max, t);
+	}
+
+	float axis_length = 0.0f;
+	for (int c = 0; c < components; c++) {
+		axis_length += axis[c] * axis[c];
+	}
+	if (axis_length > FLT_EPSILON) {
+		t_min /= axis_length;
+		t_max /= axis_length;
+	}
+
+	for (int c = 0; c < 4; c++) {
+		e0[c] = fminf(fmaxf(mean[c] + t_max * axis[c], 0.0f), 255.0f);
+		e1[c] = fminf(fmaxf(mean[c] + t_min * axis[c], 0.0f), 255.0f);
+	}
+}
+
+// Index of the nearest palette entry, four entries per SSE compare
+static int bc_nearest(const float* pixel, const __m128* palette, int groups, int components, float* error) {
+	__m128 best = _mm_set1_ps(FLT_MAX);
+	__m128i best_index = _mm_set1_epi32(0);
+	__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+	const __m128i step = _mm_set1_epi32(4);
+
+	for (int g = 0; g < groups; g++) {
+		__m128 distance = _mm_setzero_ps();
+		for (int c = 0; c < components; c++) {
+			__m128 delta = _mm_sub_ps(palette[g * 4 + c], _mm_set1_ps(pixel[c]));
+			distance = _mm_add_ps(distance, _mm_mul_ps(delta, delta));
+		}
+		__m128 closer = _mm_cmplt_ps(distance, best);
+		best = _mm_min_ps(best, distance);
+		best_index = _mm_or_si128(_mm_and_si128(_mm_castps_si128(closer), index), _mm_andnot_si128(_mm_castps_si128(closer), best_index));
+		index = _mm_add_epi32(index, step);
+	}
+
+	float distances[4];
+	int indices[4];
+	_mm_storeu_ps(distances, best);
+	_mm_storeu_si128((__m128i*)indices, best_index);
+
+	int lane = 0;
+	for (int i = 1; i < 4; i++) {
+		if (distances[i] < distances[lane] || (distances[i] == distances[lane] && indices[i] < indices[lane])) {
+			lane = i;
+		}
+	}
+	*error += distances[lane];
+	return indices[lane];
+}
+
+// Least squares endpoints for fixed interpolation weights (fraction of e1 per pixel)
+static bool bc_refit(float block[BC_PIXELS][4], const float weights[BC_PIXELS], int components, float e0[4], float e1[4]) {
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[4] = { 0 }, bx[4] = { 0 };
+	for (int i = 0; i < BC_PIXELS; i++) {
+		float b = weights[i];
+		float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < components; c++) {
+			ax[c] += a * block[i][c];
+			bx[c] += b * block[i][c];
+		}
+	}
+
+	float determinant = aa * bb - ab * ab;
+	if (fabsf(determinant) < FLT_EPSILON) {
+		return false;
+	}
+	for (int c = 0; c < components; c++) {
+		e0[c] = fminf(fmaxf((bb * ax[c] - ab * bx[c]) / determinant, 0.0f), 255.0f);
+		e1[c] = fminf(fmaxf((aa * bx[c] - ab * ax[c]) / determinant, 0.0f), 255.0f);
+	}
+	return true;
+}
+
+// BC1 color
+static uint16_t bc1_pack_565(const float color[4]) {
+	int r = bc_clamp((int)(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+	int g = bc_clamp((int)(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+	int b = bc_clamp((int)(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void bc1_unpack_565(uint16_t packed, int color[3]) {
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+static void bc1_palette(uint16_t c0, uint16_t c1, bool four_colors, int palette[4][4]) {
+	bc1_unpack_565(c0, palette[0]);
+	bc1_unpack_565(c1, palette[1]);
+	for (int c = 0; c < 3; c++) {
+		if (four_colors) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		else {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[0][3] = palette[1][3] = palette[2][3] = 255;
+	palette[3][3] = four_colors ? 255 : 0;
+}
+
+static float bc1_select(float block[BC_PIXELS][4], uint16_t c0, uint16_t c1, uint32_t* indices) {
+	int palette[4][4];
+	bc1_palette(c0, c1, true, palette);
+
+	__m128 lanes[4];
+	for (int c = 0; c < 3; c++) {
+		lanes[c] = _mm_setr_ps((float)palette[0][c], (float)palette[1][c], (float)palette[2][c], (float)palette[3][c]);
+	}
+	lanes[3] = _mm_setzero_ps();
+
+	float error = 0.0f;
+	*indices = 0;
+	for (int i = 0; i < BC_PIXELS; i++) {
+		*indices |= (uint32_t)bc_nearest(block[i], lanes, 1, 3, &error) << (2 * i);
+	}
+	return error;
+}
+
+static void bc1_encode_color(float block[BC_PIXELS][4], unsigned char* out) {
+	float e0[4], e1[4];
+	bc_fit_endpoints(block, 3, e0, e1);
+
+	uint16_t c0 = bc1_pack_565(e0);
+	uint16_t c1 = bc1_pack_565(e1);
+	uint32_t indices;
+	float error = bc1_select(block, c0, c1, &indices);
+
+	// One refit from the chosen indices usually recovers what the 565 rounding lost
+	static const float weight_of_index[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+	float weights[BC_PIXELS];
+	for (int i = 0; i < BC_PIXELS; i++) {
+		weights[i] = weight_of_index[(indices >> (2 * i)) & 3];
+	}
+	if (bc_refit(block, weights, 3, e0, e1)) {
+		uint16_t r0 = bc1_pack_565(e0);
+		uint16_t r1 = bc1_pack_565(e1);
+		uint32_t refit_indices;
+		float refit_error = bc1_select(block, r0, r1, &refit_indices);
+		if (refit_error < error) {
+			c0 = r0;
+			c1 = r1;
+			indices = refit_indices;
+		}
+	}
+
+	// c0 > c1 selects the four color mode, swapping the endpoints swaps 0/1 and 2/3
+	if (c0 < c1) {
+		uint16_t swap = c0;
+		c0 = c1;
+		c1 = swap;
+		indices ^= 0x55555555u;
+	}
+	else if (c0 == c1) {
+		indices = 0;
+	}
+
+	out[0] = (unsigned char)(c0 & 0xff);
+	out[1] = (unsigned char)(c0 >> 8);
+	out[2] = (unsigned char)(c1 & 0xff);
+	out[3] = (unsigned char)(c1 >> 8);
+	for (int i = 0; i < 4; i++) {
+		out[4 + i] = (unsigned char)(indices >> (8 * i));
+	}
+}
+
+static void bc1_decode_color(const unsigned char* block, bool force_four_colors, unsigned char* rgba, int stride) {
+	uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+	uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+	uint32_t indices = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) | ((uint32_t)block[7] << 24);
+
+	int palette[4][4];
+	bc1_palette(c0, c1, force_four_colors || c0 > c1, palette);
+	for (int i = 0; i < BC_PIXELS; i++) {
+		const int* color = palette[(indices >> (2 * i)) & 3];
+		unsigned char* out = rgba + (i / BC_BLOCK_DIM) * stride + (i % BC_BLOCK_DIM) * 4;
+		out[0] = (unsigned char)color[0];
+		out[1] = (unsigned char)color[1];
+		out[2] = (unsigned char)color[2];
+		out[3] = (unsigned char)color[3];
+	}
+}
+
+// BC3 alpha
+static void bc3_alpha_palette(int a0, int a1, int palette[8]) {
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1) {
+		for (int i = 1; i < 7; i++) {
+			palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+		}
+	}
+	else {
+		for (int i = 1; i < 5; i++) {
+			palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+static void bc3_encode_alpha(float block[BC_PIXELS][4], unsigned char* out) {
+	int a0 = 0;
+	int a1 = 255;
+	for (int i = 0; i < BC_PIXELS; i++) {
+		a0 = a0 > (int)block[i][3] ? a0 : (int)block[i][3];
+		a1 = a1 < (int)block[i][3] ? a1 : (int)block[i][3];
+	}
+
+	int palette[8];
+	bc3_alpha_palette(a0, a1, palette);
+
+	uint64_t indices = 0;
+	for (int i = 0; i < BC_PIXELS && a0 != a1; i++) {
+		int best = 0;
+		int best_error = INT32_MAX;
+		for (int p = 0; p < 8; p++) {
+			int error = abs(palette[p] - (int)block[i][3]);
+			if (error < best_error) {
+				best = p;
+				best_error = error;
+			}
+		}
+		indices |= (uint64_t)best << (3 * i);
+	}
+
+	out[0] = (unsigned char)a0;
+	out[1] = (unsigned char)a1;
+	for (int i = 0; i < 6; i++) {
+		out[2 + i] = (unsigned char)(indices >> (8 * i));
+	}
+}
+
+static void bc3_decode_alpha(const unsigned char* block, unsigned char* rgba, int stride) {
+	int palette[8];
+	bc3_alpha_palette(block[0], block[1], palette);
+
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; i++) {
+		indices |= (uint64_t)block[2 + i] << (8 * i);
+	}
+	for (int i = 0; i < BC_PIXELS; i++) {
+		rgba[(i / BC_BLOCK_DIM) * stride + (i % BC_BLOCK_DIM) * 4 + 3] = (unsigned char)palette[(indices >> (3 * i)) & 7];
+	}
+}
+
+// BC7 mode 6: one subset, RGBA endpoints of 7 bits plus a shared low bit each, 4 bit indices
+typedef struct {
+	int endpoints[2][4]; // 7 bit
+	int pbits[2];
+	unsigned char indices[BC_PIXELS];
+	float error;
+} bc7_mode6_t;
+
+static void bc7_quantize(const float endpoint[4], int quantized[4], int* pbit) {
+	float best_error = FLT_MAX;
+	for (int p = 0; p < 2; p++) {
+		int candidate[4];
+		float error = 0.0f;
+		for (int c = 0; c < 4; c++) {
+			candidate[c] = bc_clamp((int)floorf((endpoint[c] - p) * 0.5f + 0.5f), 0, 127);
+			float delta = (float)((candidate[c] << 1) | p) - endpoint[c];
+			error += delta * delta;
+		}
+		if (error < best_error) {
+			best_error = error;
+			*pbit = p;
+			memcpy(quantized, candidate, sizeof(candidate));
+		}
+	}
+}
+
+static void bc7_palette(const int endpoints[2][4], const int pbits[2], int palette[16][4]) {
+	for (int c = 0; c < 4; c++) {
+		int e0 = (endpoints[0][c] << 1) | pbits[0];
+		int e1 = (endpoints[1][c] << 1) | pbits[1];
+		for (int i = 0; i < 16; i++) {
+			palette[i][c] = ((64 - bc7_weights[i]) * e0 + bc7_weights[i] * e1 + 32) >> 6;
+		}
+	}
+}
+
+static void bc7_select(float block[BC_PIXELS][4], bc7_mode6_t* mode) {
+	int palette[16][4];
+	bc7_palette(mode->endpoints, mode->pbits, palette);
+
+	__m128 lanes[16];
+	for (int g = 0; g < 4; g++) {
+		for (int c = 0; c < 4; c++) {
+			lanes[g * 4 + c] = _mm_setr_ps((float)palette[g * 4][c], (float)palette[g * 4 + 1][c], (float)palette[g * 4 + 2][c], (float)palette[g * 4 + 3][c]);
+		}
+	}
+
+	mode->error = 0.0f;
+	for (int i = 0; i < BC_PIXELS; i++) {
+		mode->indices[i] = (unsigned char)bc_nearest(block[i], lanes, 4, 4, &mode->error);
+	}
+}
+
+static void bc7_write_bits(unsigned char* out, int* position, uint32_t value, int count) {
+	for (int i = 0; i < count; i++, (*position)++) {
+		if (value & (1u << i)) {
+			out[*position >> 3] |= (unsigned char)(1u << (*position & 7));
+		}
+	}
+}
+
+static uint32_t bc7_read_bits(const unsigned char* block, int* position, int count) {
+	uint32_t value = 0;
+	for (int i = 0; i < count; i++, (*position)++) {
+		value |= (uint32_t)((block[*position >> 3] >> (*position & 7)) & 1) << i;
+	}
+	return value;
+}
+
+static void bc7_encode_block(float block[BC_PIXELS][4], unsigned char* out) {
+	float e0[4], e1[4];
+	bc_fit_endpoints(block, 4, e0, e1);
+
+	bc7_mode6_t best;
+	bc7_quantize(e1, best.endpoints[0], &best.pbits[0]);
+	bc7_quantize(e0, best.endpoints[1], &best.pbits[1]);
+	bc7_select(block, &best);
+
+	for (int pass = 0; pass < BC7_REFINE_PASSES; pass++) {
+		float weights[BC_PIXELS];
+		for (int i = 0; i < BC_PIXELS; i++) {
+			weights[i] = bc7_weights[best.indices[i]] / 64.0f;
+		}
+		if (!bc_refit(block, weights, 4, e0, e1)) {
+			break;
+		}
+
+		bc7_mode6_t candidate;
+		bc7_quantize(e0, candidate.endpoints[0], &candidate.pbits[0]);
+		bc7_quantize(e1, candidate.endpoints[1], &candidate.pbits[1]);
+		bc7_select(block, &candidate);
+		if (candidate.error >= best.error) {
+			break;
+		}
+		best = candidate;
+	}
+
+	// The first index is stored with its top bit implied zero, flip the line when it's set
+	if (best.indices[0] & 8) {
+		for (int c = 0; c < 4; c++) {
+			int swap = best.endpoints[0][c];
+			best.endpoints[0][c] = best.endpoints[1][c];
+			best.endpoints[1][c] = swap;
+		}
+		int swap = best.pbits[0];
+		best.pbits[0] = best.pbits[1];
+		best.pbits[1] = swap;
+		for (int i = 0; i < BC_PIXELS; i++) {
+			best.indices[i] = (unsigned char)(15 - best.indices[i]);
+		}
+	}
+
+	memset(out, 0, 16);
+	int position = 0;
+	bc7_write_bits(out, &position, 1u << 6, 7);
+	for (int c = 0; c < 4; c++) {
+		bc7_write_bits(out, &position, (uint32_t)best.endpoints[0][c], 7);
+		bc7_write_bits(out, &position, (uint32_t)best.endpoints[1][c], 7);
+	}
+	bc7_write_bits(out, &position, (uint32_t)best.pbits[0], 1);
+	bc7_write_bits(out, &position, (uint32_t)best.pbits[1], 1);
+	for (int i = 0; i < BC_PIXELS; i++) {
+		bc7_write_bits(out, &position, best.indices[i], i == 0 ? 3 : 4);
+	}
+}
+
+static void bc7_decode_block(const unsigned char* block, unsigned char* rgba, int stride) {
+	int position = 0;
+	if (bc7_read_bits(block, &position, 7) != (1u << 6)) {
+		// Only mode 6 is ever written by the encoder, anything else decodes as magenta
+		for (int i = 0; i < BC_PIXELS; i++) {
+			unsigned char* out = rgba + (i / BC_BLOCK_DIM) * stride + (i % BC_BLOCK_DIM) * 4;
+			out[0] = 255; out[1] = 0; out[2] = 255; out[3] = 255;
+		}
+		return;
+	}
+
+	int endpoints[2][4];
+	int pbits[2];
+	for (int c = 0; c < 4; c++) {
+		endpoints[0][c] = (int)bc7_read_bits(block, &position, 7);
+		endpoints[1][c] = (int)bc7_read_bits(block, &position, 7);
+	}
+	pbits[0] = (int)bc7_read_bits(block, &position, 1);
+	pbits[1] = (int)bc7_read_bits(block, &position, 1);
+
+	int palette[16][4];
+	bc7_palette(endpoints, pbits, palette);
+	for (int i = 0; i < BC_PIXELS; i++) {
+		int index = (int)bc7_read_bits(block, &position, i == 0 ? 3 : 4);
+		unsigned char* out = rgba + (i / BC_BLOCK_DIM) * stride + (i % BC_BLOCK_DIM) * 4;
+		for (int c = 0; c < 4; c++) {
+			out[c] = (unsigned char)palette[index][c];
+		}
+	}
+}
+
+// Images
+typedef struct {
+	bc_format_t format;
+	const unsigned char* pixels;
+	int width;
+	int height;
+	int channels;
+	unsigned char* blocks;
+	int first_row;
+	int last_row;
+} bc_encode_job_t;
+
+static int bc_encode_rows(void* data) {
+	const bc_encode_job_t* job = (const bc_encode_job_t*)data;
+	int blocks_x = (job->width + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	int block_bytes = bc_block_bytes(job->format);
+
+	float block[BC_PIXELS][4];
+	for (int by = job->first_row; by < job->last_row; by++) {
+		for (int bx = 0; bx < blocks_x; bx++) {
+			unsigned char* out = job->blocks + ((size_t)by * blocks_x + bx) * block_bytes;
+			bc_fetch_block(job->pixels, job->width, job->height, job->channels, bx, by, block);
+
+			switch (job->format) {
+			case BC1:
+				bc1_encode_color(block, out);
+				break;
+			case BC3:
+				bc3_encode_alpha(block, out);
+				bc1_encode_color(block, out + 8);
+				break;
+			case BC7:
+				bc7_encode_block(block, out);
+				break;
+			}
+		}
+	}
+	return 0;
+}
+
+size_t bc_image_size(bc_format_t format, int width, int height) {
+	size_t blocks_x = (size_t)(width + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	size_t blocks_y = (size_t)(height + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	return blocks_x * blocks_y * bc_block_bytes(format);
+}
+
+void bc_encode_image(bc_format_t format, const unsigned char* pixels, int width, int height, int channels, unsigned char* blocks) {
+	int rows = (height + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	int thread_count = SDL_GetCPUCount();
+	thread_count = thread_count < 1 ? 1 : thread_count > BC_MAX_THREADS ? BC_MAX_THREADS : thread_count;
+	thread_count = thread_count > rows ? rows : thread_count;
+
+	// Bands of block rows, the calling thread encodes the last one
+	bc_encode_job_t jobs[BC_MAX_THREADS];
+	SDL_Thread* threads[BC_MAX_THREADS] = { NULL };
+	for (int t = 0; t < thread_count; t++) {
+		jobs[t] = (bc_encode_job_t){ format, pixels, width, height, channels, blocks, rows * t / thread_count, rows * (t + 1) / thread_count };
+		if (t < thread_count - 1) {
+			threads[t] = SDL_CreateThread(bc_encode_rows, "bc_encoder", &jobs[t]);
+			if (threads[t] == NULL) {
+				bc_encode_rows(&jobs[t]);
+			}
+		}
+	}
+	bc_encode_rows(&jobs[thread_count - 1]);
+
+	for (int t = 0; t < thread_count - 1; t++) {
+		if (threads[t] != NULL) {
+			SDL_WaitThread(threads[t], NULL);
+		}
+	}
+}
+
+void bc_decode_image(bc_format_t format, const unsigned char* blocks, int width, int height, unsigned char* rgba) {
+	int blocks_x = (width + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	int blocks_y = (height + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	int block_bytes = bc_block_bytes(format);
+
+	unsigned char decoded[BC_PIXELS * 4];
+	for (int by = 0; by < blocks_y; by++) {
+		for (int bx = 0; bx < blocks_x; bx++) {
+			const unsigned char* block = blocks + ((size_t)by * blocks_x + bx) * block_bytes;
+			switch (format) {
+			case BC1:
+				bc1_decode_color(block, false, decoded, BC_BLOCK_DIM * 4);
+				break;
+			case BC3:
+				bc1_decode_color(block + 8, true, decoded, BC_BLOCK_DIM * 4);
+				bc3_decode_alpha(block, decoded, BC_BLOCK_DIM * 4);
+				break;
+			case BC7:
+				bc7_decode_block(block, decoded, BC_BLOCK_DIM * 4);
+				break;
+			}
+
+			for (int y = 0; y < BC_BLOCK_DIM && by * BC_BLOCK_DIM + y < height; y++) {
+				int columns = width - bx * BC_BLOCK_DIM < BC_BLOCK_DIM ? width - bx * BC_BLOCK_DIM : BC_BLOCK_DIM;
+				memcpy(rgba + ((size_t)(by * BC_BLOCK_DIM + y) * width + bx * BC_BLOCK_DIM) * 4, decoded + y * BC_BLOCK_DIM * 4, (size_t)columns * 4);
+			}
+		}
+	}
+}
+
+double bc_psnr(const unsigned char* pixels, const unsigned char* rgba, int width, int height, int channels) {
+	double squared = 0.0;
+	size_t count = (size_t)width * height;
+	for (size_t i = 0; i < count; i++) {
+		for (int c = 0; c < channels; c++) {
+			double delta = (double)pixels[i * channels + c] - rgba[i * 4 + c];
+			squared += delta * delta;
+		}
+	}
+
+	double mse = squared / ((double)count * channels);
+	return mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+}
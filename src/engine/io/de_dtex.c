@@ -0,0 +1,399 @@
+/**
+* @file de_dtex.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_dtex.h"
+#include "../../include/de_util.h"
+#include "../../include/de_buffer.h"
+#include "../../include/de_bc.h"
+
+#define DTEX_PAGE_SIZE 4096
+
+static float srgb_to_linear[256];
+static bool tables_ready = false;
+
+static void dtex_init_tables(void) {
+	for (int i = 0; i < 256; i++) {
+		float c = i / 255.0f;
+		srgb_to_linear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+	}
+	tables_ready = true;
+}
+
+static int dtex_max(int a, int b) {
+	return a > b ? a : b;
+}
+
+static float dtex_to_linear(unsigned char value, bool srgb) {
+	return srgb ? srgb_to_linear[value] : value / 255.0f;
+}
+
+static unsigned char dtex_from_linear(float value, bool srgb) {
+	value = value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
+	if (srgb) {
+		value = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+	}
+	return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+// Box filter over the whole source footprint of each texel, so odd sizes keep their
+// last row and column. Color is averaged in linear space and weighted by alpha, which
+// keeps transparent texels from bleeding their color into the edges.
+static void dtex_downsample(const unsigned char* source, int source_width, int source_height,
+	unsigned char* target, int width, int height, int channels, bool srgb) {
+	for (int y = 0; y < height; y++) {
+		int y0 = y * source_height / height;
+		int y1 = dtex_max((y + 1) * source_height / height, y0 + 1);
+
+		for (int x = 0; x < width; x++) {
+			int x0 = x * source_width / width;
+			int x1 = dtex_max((x + 1) * source_width / width, x0 + 1);
+
+			// A single channel is data, not color: averaged as is
+			if (channels == 1) {
+				float sum = 0.0f;
+				for (int sy = y0; sy < y1; sy++) {
+					for (int sx = x0; sx < x1; sx++) {
+						sum += source[(size_t)sy * source_width + sx];
+					}
+				}
+				target[(size_t)y * width + x] = (unsigned char)(sum / ((y1 - y0) * (x1 - x0)) + 0.5f);
+				continue;
+			}
+
+			float weighted[3] = { 0.0f, 0.0f, 0.0f };
+			float plain[3] = { 0.0f, 0.0f, 0.0f };
+			float alpha = 0.0f;
+			int taps = 0;
+
+			for (int sy = y0; sy < y1; sy++) {
+				for (int sx = x0; sx < x1; sx++) {
+					const unsigned char* texel = source + ((size_t)sy * source_width + sx) * channels;
+					float a = channels == 4 ? texel[3] / 255.0f : 1.0f;
+					for (int c = 0; c < 3; c++) {
+						float linear = dtex_to_linear(texel[c], srgb);
+						weighted[c] += linear * a;
+						plain[c] += linear;
+					}
+					alpha += a;
+					taps++;
+				}
+			}
+
+			unsigned char* out = target + ((size_t)y * width + x) * channels;
+			for (int c = 0; c < 3; c++) {
+				out[c] = dtex_from_linear(alpha > 0.0f ? weighted[c] / alpha : plain[c] / taps, srgb);
+			}
+			if (channels == 4) {
+				out[3] = (unsigned char)(alpha / taps * 255.0f + 0.5f);
+			}
+		}
+	}
+}
+
+static bool dtex_format_is_bc(dtex_format_t format) {
+	return format == DTEX_FORMAT_BC1 || format == DTEX_FORMAT_BC3 || format == DTEX_FORMAT_BC7;
+}
+
+static bc_format_t dtex_bc_format(dtex_format_t format) {
+	return format == DTEX_FORMAT_BC1 ? BC1 : format == DTEX_FORMAT_BC3 ? BC3 : BC7;
+}
+
+static size_t dtex_level_size(dtex_format_t format, uint32_t channels, uint32_t width, uint32_t height) {
+	if (dtex_format_is_bc(format)) {
+		return bc_image_size(dtex_bc_format(format), (int)width, (int)height);
+	}
+	return (size_t)width * height * channels;
+}
+
+static dtex_format_t dtex_choose_format(const unsigned char* pixels, int width, int height, int channels, dtex_compression_t compression) {
+	if (channels == 1) {
+		return DTEX_FORMAT_R8;
+	}
+	if (compression == DTEX_COMPRESSION_BC7) {
+		return DTEX_FORMAT_BC7;
+	}
+	if (compression == DTEX_COMPRESSION_NONE) {
+		return channels == 4 ? DTEX_FORMAT_RGBA8 : DTEX_FORMAT_RGB8;
+	}
+
+	// An alpha channel that is opaque everywhere costs BC3 twice the size of BC1 for nothing
+	if (channels == 4) {
+		size_t count = (size_t)width * height;
+		for (size_t i = 0; i < count; i++) {
+			if (pixels[i * 4 + 3] != 255) {
+				return DTEX_FORMAT_BC3;
+			}
+		}
+	}
+	return DTEX_FORMAT_BC1;
+}
+
+static const char* dtex_format_name(dtex_format_t format) {
+	switch (format) {
+	case DTEX_FORMAT_BC1: return "BC1";
+	case DTEX_FORMAT_BC3: return "BC3";
+	case DTEX_FORMAT_BC7: return "BC7";
+	case DTEX_FORMAT_RGBA8: return "RGBA8";
+	case DTEX_FORMAT_R8: return "R8";
+	default: return "RGB8";
+	}
+}
+
+bool dtex_cook(const char* source_path, const char* cooked_path, uint32_t flags, dtex_compression_t compression) {
+	int width, height, channels;
+	unsigned char* pixels = tbo_decode(source_path, &width, &height, &channels);
+	if (pixels == NULL) {
+		return false;
+	}
+
+	bool written = dtex_write(cooked_path, pixels, width, height, channels, flags, compression, DTEX_MAX_LEVELS, file_stamp(source_path));
+	free(pixels);
+	return written;
+}
+
+bool dtex_write(const char* cooked_path, const unsigned char* pixels, int width, int height, int channels, uint32_t flags, dtex_compression_t compression, int max_levels, uint64_t source_stamp) {
+	if (!tables_ready) {
+		dtex_init_tables();
+	}
+
+	int level_count = 1;
+	while (level_count < max_levels && level_count < DTEX_MAX_LEVELS && ((width >> level_count) > 0 || (height >> level_count) > 0)) {
+		level_count++;
+	}
+
+	dtex_format_t format = dtex_choose_format(pixels, width, height, channels, compression);
+	dtex_header_t header = { DTEX_MAGIC, DTEX_VERSION, (uint32_t)width, (uint32_t)height, (uint32_t)channels, flags, (uint32_t)level_count, (uint32_t)format, 0, source_stamp };
+	dtex_level_t levels[DTEX_MAX_LEVELS];
+	const unsigned char* images[DTEX_MAX_LEVELS];
+	unsigned char* blocks[DTEX_MAX_LEVELS] = { NULL };
+
+	uint32_t offset = (uint32_t)(sizeof(dtex_header_t) + sizeof(dtex_level_t) * level_count);
+	images[0] = pixels;
+	for (int i = 0; i < level_count; i++) {
+		levels[i].width = (uint32_t)dtex_max(width >> i, 1);
+		levels[i].height = (uint32_t)dtex_max(height >> i, 1);
+		levels[i].size = (uint32_t)dtex_level_size(format, (uint32_t)channels, levels[i].width, levels[i].height);
+		levels[i].offset = offset;
+		offset += levels[i].size;
+
+		// Mips are always filtered from the uncompressed level above, never from blocks
+		if (i > 0) {
+			unsigned char* mip = (unsigned char*)malloc((size_t)levels[i].width * levels[i].height * channels);
+			if (mip == NULL) {
+				fprintf(stderr, "failed to allocate memory for texture mip.\n");
+				exit(EXIT_FAILURE);
+			}
+			dtex_downsample(images[i - 1], (int)levels[i - 1].width, (int)levels[i - 1].height,
+				mip, (int)levels[i].width, (int)levels[i].height, channels, (flags & DTEX_FLAG_SRGB) != 0);
+			images[i] = mip;
+		}
+
+		if (dtex_format_is_bc(format)) {
+			blocks[i] = (unsigned char*)malloc(levels[i].size);
+			if (blocks[i] == NULL) {
+				fprintf(stderr, "failed to allocate memory for texture blocks.\n");
+				exit(EXIT_FAILURE);
+			}
+			bc_encode_image(dtex_bc_format(format), images[i], (int)levels[i].width, (int)levels[i].height, channels, blocks[i]);
+		}
+	}
+
+	if (dtex_format_is_bc(format)) {
+		unsigned char* decoded = (unsigned char*)malloc((size_t)width * height * 4);
+		if (decoded == NULL) {
+			fprintf(stderr, "failed to allocate memory for texture blocks.\n");
+			exit(EXIT_FAILURE);
+		}
+		bc_decode_image(dtex_bc_format(format), blocks[0], width, height, decoded);
+		printf("Texture %s: %s %dx%d, PSNR %.2f dB\n", cooked_path, dtex_format_name(format), width, height,
+			bc_psnr(pixels, decoded, width, height, channels));
+		free(decoded);
+	}
+
+	bool written = false;
+	FILE* file = fopen(cooked_path, "wb");
+	if (file != NULL) {
+		written = fwrite(&header, sizeof(dtex_header_t), 1, file) == 1
+			&& fwrite(levels, sizeof(dtex_level_t), level_count, file) == (size_t)level_count;
+		for (int i = 0; i < level_count && written; i++) {
+			const unsigned char* data = blocks[i] != NULL ? blocks[i] : images[i];
+			written = fwrite(data, 1, levels[i].size, file) == levels[i].size;
+		}
+		fclose(file);
+	}
+	if (!written) {
+		fprintf(stderr, "failed to write cooked texture: %s.\n", cooked_path);
+		remove(cooked_path);
+	}
+
+	for (int i = 0; i < level_count; i++) {
+		if (i > 0) {
+			free((void*)images[i]);
+		}
+		free(blocks[i]);
+	}
+	return written;
+}
+
+static bool dtex_validate(const dtex_t* dtex) {
+	if (dtex->size < sizeof(dtex_header_t)) {
+		return false;
+	}
+	const dtex_header_t* header = dtex->header;
+	if (header->magic != DTEX_MAGIC || header->version != DTEX_VERSION
+		|| header->width == 0 || header->height == 0
+		|| header->level_count == 0 || header->level_count > DTEX_MAX_LEVELS
+		|| (header->channels != 1 && header->channels != 3 && header->channels != 4) || header->format > DTEX_FORMAT_R8
+		|| (header->format == DTEX_FORMAT_RGB8 && header->channels != 3)
+		|| (header->format == DTEX_FORMAT_RGBA8 && header->channels != 4)
+		|| ((header->format == DTEX_FORMAT_R8) != (header->channels == 1))) {
+		return false;
+	}
+	if (dtex->size < sizeof(dtex_header_t) + sizeof(dtex_level_t) * header->level_count) {
+		return false;
+	}
+	// Levels follow each other from the end of the table, each half the size of the one
+	// before: uploads and dtex_data_size measure ranges between offsets
+	size_t expected_offset = sizeof(dtex_header_t) + sizeof(dtex_level_t) * header->level_count;
+	for (uint32_t i = 0; i < header->level_count; i++) {
+		const dtex_level_t* level = &dtex->levels[i];
+		uint32_t width = header->width >> i;
+		uint32_t height = header->height >> i;
+		if (level->width != (width > 0 ? width : 1) || level->height != (height > 0 ? height : 1)
+			|| level->offset != expected_offset
+			|| level->size != dtex_level_size((dtex_format_t)header->format, header->channels, level->width, level->height)
+			|| (size_t)level->offset + level->size > dtex->size) {
+			return false;
+		}
+		expected_offset += level->size;
+	}
+	return true;
+}
+
+bool dtex_open(dtex_t* dtex, const char* cooked_path) {
+	*dtex = (dtex_t){ 0 };
+
+	dtex->file = CreateFileA(cooked_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (dtex->file == INVALID_HANDLE_VALUE) {
+		dtex->file = NULL;
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(dtex->file, &size) || size.QuadPart == 0) {
+		dtex_close(dtex);
+		return false;
+	}
+	dtex->size = (size_t)size.QuadPart;
+
+	dtex->mapping = CreateFileMappingA(dtex->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (dtex->mapping != NULL) {
+		dtex->base = (const unsigned char*)MapViewOfFile(dtex->mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (dtex->base == NULL) {
+		dtex_close(dtex);
+		return false;
+	}
+
+	dtex->header = (const dtex_header_t*)dtex->base;
+	dtex->levels = (const dtex_level_t*)(dtex->base + sizeof(dtex_header_t));
+	if (!dtex_validate(dtex)) {
+		fprintf(stderr, "invalid cooked texture: %s.\n", cooked_path);
+		dtex_close(dtex);
+		return false;
+	}
+	return true;
+}
+
+// A source edited after the cook no longer matches the stamp. A missing source does not
+// make the cooked copy stale, builds may ship without the images.
+static bool dtex_matches_source(const dtex_t* dtex, const char* source_path) {
+	uint64_t stamp = file_stamp(source_path);
+	return stamp == 0 || stamp == dtex->header->source_stamp;
+}
+
+// Falls back to the source when the cooked copy is out of date
+bool dtex_open_cooked(dtex_t* dtex, const char* source_path) {
+	char* cooked_path = dtex_cooked_path(source_path);
+	bool opened = file_exists(cooked_path) && dtex_open(dtex, cooked_path);
+	if (opened && !dtex_matches_source(dtex, source_path)) {
+		fprintf(stderr, "cooked texture %s is older than its source, decoding the source.\n", cooked_path);
+		dtex_close(dtex);
+		opened = false;
+	}
+	free(cooked_path);
+	return opened;
+}
+
+void dtex_close(dtex_t* dtex) {
+	if (dtex->base != NULL) {
+		UnmapViewOfFile(dtex->base);
+	}
+	if (dtex->mapping != NULL) {
+		CloseHandle(dtex->mapping);
+	}
+	if (dtex->file != NULL) {
+		CloseHandle(dtex->file);
+	}
+	*dtex = (dtex_t){ 0 };
+}
+
+bool dtex_is_valid(const char* cooked_path) {
+	dtex_t dtex;
+	if (!file_exists(cooked_path) || !dtex_open(&dtex, cooked_path)) {
+		return false;
+	}
+	dtex_close(&dtex);
+	return true;
+}
+
+bool dtex_is_current(const char* cooked_path, const char* source_path) {
+	dtex_t dtex;
+	if (!file_exists(cooked_path) || !dtex_open(&dtex, cooked_path)) {
+		return false;
+	}
+	bool current = dtex_matches_source(&dtex, source_path);
+	dtex_close(&dtex);
+	return current;
+}
+
+bool dtex_is_compressed(const dtex_t* dtex) {
+	return dtex_format_is_bc((dtex_format_t)dtex->header->format);
+}
+
+char* dtex_cooked_path(const char* source_path) {
+	// "./data/images/icon.png" cooks to "./data/binary/icon.png.dtex"
+	const char* name = source_path;
+	for (const char* c = source_path; *c != '\0'; c++) {
+		if (*c == '/' || *c == '\\') {
+			name = c + 1;
+		}
+	}
+	char* binary_path = create_binary_path(name);
+	char* cooked_path = concat(binary_path, DTEX_EXTENSION);
+	free(binary_path);
+	return cooked_path;
+}
+
+const unsigned char* dtex_data(const dtex_t* dtex) {
+	return dtex->base + dtex->levels[0].offset;
+}
+
+size_t dtex_data_size(const dtex_t* dtex) {
+	const dtex_level_t* last = &dtex->levels[dtex->header->level_count - 1];
+	return (size_t)last->offset + last->size - dtex->levels[0].offset;
+}
+
+void dtex_prefetch(const dtex_t* dtex) {
+	// Fault the pages in on the calling thread so the GL thread copies from memory
+	volatile unsigned char sink = 0;
+	for (size_t i = 0; i < dtex->size; i += DTEX_PAGE_SIZE) {
+		sink ^= dtex->base[i];
+	}
+	(void)sink;
+}
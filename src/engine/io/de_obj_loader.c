@@ -9,19 +9,41 @@
 #include "../../include/de_obj_loader.h"
 #include "../../include/de_collection.h"
 
-void obj_load(mesh_t* mesh, const char* path) {
+#define OBJ_WELD_INIT_CAPACITY 1024
+#define OBJ_MAX_POLYGON 16
+
+// Open-addressing table mapping a (position, uv, normal) triple to a welded vertex index
+typedef struct {
+	itriple_t* keys;
+	int* values;
+	size_t capacity;
+	size_t size;
+} obj_weld_table_t;
+
+static void obj_weld_init(obj_weld_table_t* table, size_t capacity);
+static int obj_weld_find_or_add(obj_weld_table_t* table, const itriple_t* key, int value);
+static void obj_weld_free(obj_weld_table_t* table);
+static bool obj_parse_corner(char** cursor, itriple_t* corner);
+static int obj_resolve_index(int index, size_t count);
+static void obj_generate_normals(list_t* vertices, list_t* faces, list_t* indices);
+
+bool obj_load(mesh_t* mesh, const char* path) {
 	FILE* file = fopen(path, "r");
 	if (file == NULL) {
 		fprintf(stderr, "failed to open file: %s.\n", path);
-		return;
+		return false;
 	}
 
-	list_t positions, normals, uvs, vertices, faces;
+	list_t positions, normals, uvs, vertices, faces, indices;
 	list_init(&positions, sizeof(vec3_t));
 	list_init(&normals, sizeof(vec3_t));
 	list_init(&uvs, sizeof(tex2_t));
 	list_init(&vertices, sizeof(vertex_t));
 	list_init(&faces, sizeof(face_t));
+	list_init(&indices, sizeof(unsigned int));
+
+	obj_weld_table_t weld;
+	obj_weld_init(&weld, OBJ_WELD_INIT_CAPACITY);
 
 	char line[256];
 	while (fgets(line, sizeof(line), file)) {
@@ -44,22 +66,48 @@ void obj_load(mesh_t* mesh, const char* path) {
 			}
 		}
 		else if (strncmp(line, "f ", 2) == 0) {
-			face_t face;
-			if (sscanf_s(line, "f %d/%d/%d %d/%d/%d %d/%d/%d",
-				&face.vertex[0], &face.uv[0], &face.normal[0],
-				&face.vertex[1], &face.uv[1], &face.normal[1],
-				&face.vertex[2], &face.uv[2], &face.normal[2]) == 9) {
+			// Corners may be v, v/vt, v//vn or v/vt/vn, polygons are split into a fan
+			itriple_t corners[OBJ_MAX_POLYGON];
+			itriple_t extra;
+			int corner_count = 0;
+			bool valid = true;
+			char* cursor = line + 2;
+			while (corner_count < OBJ_MAX_POLYGON && obj_parse_corner(&cursor, &corners[corner_count])) {
+				itriple_t* corner = &corners[corner_count];
+				corner->first  = obj_resolve_index(corner->first, list_size(&positions));
+				corner->second = obj_resolve_index(corner->second, list_size(&uvs));
+				corner->third  = obj_resolve_index(corner->third, list_size(&normals));
+				valid = valid && corner->first >= 0;
+				corner_count++;
+			}
+			if (corner_count == OBJ_MAX_POLYGON && obj_parse_corner(&cursor, &extra)) {
+				fprintf(stderr, "face with more than %d corners skipped in %s.\n", OBJ_MAX_POLYGON, path);
+				continue;
+			}
+			// A face with any corner missing its position is dropped whole
+			if (!valid) {
+				fprintf(stderr, "face with an invalid position skipped in %s.\n", path);
+				continue;
+			}
+
+			for (int c = 2; c < corner_count; c++) {
+				const itriple_t* triangle[3] = { &corners[0], &corners[c - 1], &corners[c] };
+				face_t face;
 				for (int i = 0; i < 3; i++) {
-					face.vertex[i] -= 1;  // Adjust for 1-based indexing
-					face.uv[i] -= 1;
-					face.normal[i] -= 1;
-
-					// Create a vertex_t for each face vertex
-					vertex_t vertex;
-					vertex.position = *(vec3_t*)list_get(&positions, face.vertex[i]);
-					vertex.normal = *(vec3_t*)list_get(&normals, face.normal[i]);
-					vertex.uv = *(tex2_t*)list_get(&uvs, face.uv[i]);
-					list_add(&vertices, &vertex);
+					face.vertex[i] = triangle[i]->first;
+					face.uv[i]     = triangle[i]->second;
+					face.normal[i] = triangle[i]->third;
+
+					// Reuse the vertex when this position/uv/normal triple was already emitted
+					unsigned int index = (unsigned int)obj_weld_find_or_add(&weld, triangle[i], (int)list_size(&vertices));
+					if (index == list_size(&vertices)) {
+						vertex_t vertex;
+						vertex.position = *(vec3_t*)list_get(&positions, face.vertex[i]);
+						vertex.normal = face.normal[i] >= 0 ? *(vec3_t*)list_get(&normals, face.normal[i]) : vec3_zero();
+						vertex.uv = face.uv[i] >= 0 ? *(tex2_t*)list_get(&uvs, face.uv[i]) : (tex2_t){ 0.0f, 0.0f };
+						list_add(&vertices, &vertex);
+					}
+					list_add(&indices, &index);
 				}
 				list_add(&faces, &face);
 			}
@@ -67,18 +115,35 @@ void obj_load(mesh_t* mesh, const char* path) {
 	}
 	fclose(file);
 
+	obj_generate_normals(&vertices, &faces, &indices);
+
 	int vertex_count = (int)list_size(&vertices);
 	int normal_count = (int)list_size(&normals);
 	int uv_count     = (int)list_size(&uvs);
 	int face_count   = (int)list_size(&faces);
+	int index_count  = (int)list_size(&indices);
 
 	// Transfer data to mesh
 	mesh->vertex_count = vertex_count;
 	mesh->face_count   = face_count;
+	mesh->index_count  = index_count;
+	mesh->format       = VERTEX_FORMAT_FLOAT;
+	mesh->index_type   = GL_UNSIGNED_INT;
+	mesh->dequant_scale  = vec3_one();
+	mesh->dequant_offset = vec3_zero();
+	mesh->lods[0].index_offset = 0;
+	mesh->lods[0].index_count  = index_count;
+	mesh->lods[0].error        = 0.0f;
+	mesh->lod_count = 1;
+
+	mesh->meshlets = NULL;
+	mesh->meshlet_count = 0;
+	mesh->meshlet_draws = (meshlet_draw_list_t){ 0 };
 
 	mesh->vertices = (vertex_t*)malloc(sizeof(vertex_t) * mesh->vertex_count);
 	mesh->faces = (face_t*)malloc(sizeof(face_t) * mesh->face_count);
-	if (mesh->vertices == NULL || mesh->faces == NULL) {
+	mesh->indices = (unsigned int*)malloc(sizeof(unsigned int) * mesh->index_count);
+	if (mesh->vertices == NULL || mesh->faces == NULL || mesh->indices == NULL) {
 		fprintf(stderr, "failed to allocate memory for mesh vertices or faces.\n");
 		exit(EXIT_FAILURE);
 	}
@@ -89,10 +154,164 @@ void obj_load(mesh_t* mesh, const char* path) {
 	for (int i = 0; i < mesh->face_count; i++) {
 		mesh->faces[i] = *(face_t*)list_get(&faces, i);
 	}
+	memcpy(mesh->indices, indices.array, sizeof(unsigned int) * mesh->index_count);
 
 	list_free(&positions);
 	list_free(&normals);
 	list_free(&uvs);
 	list_free(&vertices);
 	list_free(&faces);
+	list_free(&indices);
+	obj_weld_free(&weld);
+	return true;
+}
+
+static bool obj_parse_corner(char** cursor, itriple_t* corner) {
+	char* s = *cursor;
+	char* end;
+
+	long position = strtol(s, &end, 10);
+	if (end == s) {
+		return false;
+	}
+	long uv = 0;
+	long normal = 0;
+
+	s = end;
+	if (*s == '/') {
+		s++;
+		if (*s != '/') {
+			uv = strtol(s, &end, 10);
+			s = end;
+		}
+		if (*s == '/') {
+			s++;
+			normal = strtol(s, &end, 10);
+			s = end;
+		}
+	}
+
+	corner->first  = (int)position;
+	corner->second = (int)uv;
+	corner->third  = (int)normal;
+	*cursor = s;
+	return true;
+}
+
+static int obj_resolve_index(int index, size_t count) {
+	// OBJ indices are 1-based, negative ones count back from the last element, 0 is absent
+	int resolved = index > 0 ? index - 1 : (int)count + index;
+	if (index == 0 || resolved < 0 || resolved >= (int)count) {
+		return -1;
+	}
+	return resolved;
+}
+
+static void obj_generate_normals(list_t* vertices, list_t* faces, list_t* indices) {
+	// Corners without a vn get the area weighted average of the faces sharing the vertex
+	bool missing = false;
+	size_t face_count = list_size(faces);
+	for (size_t f = 0; f < face_count; f++) {
+		const face_t* face = (face_t*)list_get(faces, f);
+		const unsigned int* index = (unsigned int*)list_get(indices, f * 3);
+
+		if (face->normal[0] >= 0 && face->normal[1] >= 0 && face->normal[2] >= 0) {
+			continue;
+		}
+		missing = true;
+
+		vertex_t* v0 = (vertex_t*)list_get(vertices, index[0]);
+		vertex_t* v1 = (vertex_t*)list_get(vertices, index[1]);
+		vertex_t* v2 = (vertex_t*)list_get(vertices, index[2]);
+		vec3_t ab = vec3_sub(&v1->position, &v0->position);
+		vec3_t ac = vec3_sub(&v2->position, &v0->position);
+		vec3_t normal = vec3_cross(&ab, &ac);
+
+		vertex_t* corners[3] = { v0, v1, v2 };
+		for (int i = 0; i < 3; i++) {
+			if (face->normal[i] < 0) {
+				corners[i]->normal = vec3_add(&corners[i]->normal, &normal);
+			}
+		}
+	}
+	if (!missing) {
+		return;
+	}
+
+	for (size_t f = 0; f < face_count; f++) {
+		const face_t* face = (face_t*)list_get(faces, f);
+		const unsigned int* index = (unsigned int*)list_get(indices, f * 3);
+		for (int i = 0; i < 3; i++) {
+			if (face->normal[i] < 0) {
+				vertex_t* vertex = (vertex_t*)list_get(vertices, index[i]);
+				float length = vec3_magnitude(&vertex->normal);
+				if (length > FLT_EPSILON) {
+					vertex->normal = vec3_div(&vertex->normal, length);
+				}
+			}
+		}
+	}
+}
+
+static size_t obj_weld_hash(const itriple_t* key) {
+	size_t hash = (size_t)(unsigned int)key->first * 73856093u;
+	hash ^= (size_t)(unsigned int)key->second * 19349663u;
+	hash ^= (size_t)(unsigned int)key->third * 83492791u;
+	return hash;
+}
+
+static void obj_weld_init(obj_weld_table_t* table, size_t capacity) {
+	table->size = 0;
+	table->capacity = capacity;
+	table->keys = (itriple_t*)malloc(sizeof(itriple_t) * capacity);
+	table->values = (int*)malloc(sizeof(int) * capacity);
+	if (table->keys == NULL || table->values == NULL) {
+		fprintf(stderr, "failed to allocate memory for obj weld table.\n");
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < capacity; i++) {
+		table->values[i] = -1;
+	}
+}
+
+static void obj_weld_grow(obj_weld_table_t* table) {
+	obj_weld_table_t grown;
+	obj_weld_init(&grown, table->capacity * 2);
+	for (size_t i = 0; i < table->capacity; i++) {
+		if (table->values[i] >= 0) {
+			obj_weld_find_or_add(&grown, &table->keys[i], table->values[i]);
+		}
+	}
+	obj_weld_free(table);
+	*table = grown;
+}
+
+static int obj_weld_find_or_add(obj_weld_table_t* table, const itriple_t* key, int value) {
+	if ((table->size + 1) * 2 > table->capacity) {
+		obj_weld_grow(table);
+	}
+
+	size_t mask = table->capacity - 1;
+	size_t slot = obj_weld_hash(key) & mask;
+	while (table->values[slot] >= 0) {
+		const itriple_t* current = &table->keys[slot];
+		if (current->first == key->first && current->second == key->second && current->third == key->third) {
+			return table->values[slot];
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	table->keys[slot] = *key;
+	table->values[slot] = value;
+	table->size++;
+	return value;
+}
+
+static void obj_weld_free(obj_weld_table_t* table) {
+	free(table->keys);
+	free(table->values);
+	table->keys = NULL;
+	table->values = NULL;
+	table->size = 0;
+	table->capacity = 0;
 }
@@ -0,0 +1,64 @@
+/**
+* @file de_frustum.c
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#include "../../include/de_frustum.h"
+
+static plane_t frustum_make_plane(const mat4_t* m, int row, float sign) {
+	plane_t plane;
+	plane.normal.x = m->m[3][0] + sign * m->m[row][0];
+	plane.normal.y = m->m[3][1] + sign * m->m[row][1];
+	plane.normal.z = m->m[3][2] + sign * m->m[row][2];
+	plane.distance = m->m[3][3] + sign * m->m[row][3];
+
+	float length = vec3_magnitude(&plane.normal);
+	if (length > 0.0f) {
+		plane.normal = vec3_div(&plane.normal, length);
+		plane.distance /= length;
+	}
+	return plane;
+}
+
+frustum_t frustum_from_matrix(const mat4_t* matrix) {
+	// Gribb/Hartmann: clip space planes are w +/- x, y, z. With a view-projection
+	// matrix the planes are in world space, with a model-view-projection in object space.
+	frustum_t frustum;
+	frustum.planes[FRUSTUM_LEFT]   = frustum_make_plane(matrix, 0, 1.0f);
+	frustum.planes[FRUSTUM_RIGHT]  = frustum_make_plane(matrix, 0, -1.0f);
+	frustum.planes[FRUSTUM_BOTTOM] = frustum_make_plane(matrix, 1, 1.0f);
+	frustum.planes[FRUSTUM_TOP]    = frustum_make_plane(matrix, 1, -1.0f);
+	frustum.planes[FRUSTUM_NEAR]   = frustum_make_plane(matrix, 2, 1.0f);
+	frustum.planes[FRUSTUM_FAR]    = frustum_make_plane(matrix, 2, -1.0f);
+	return frustum;
+}
+
+bool frustum_test_sphere(const frustum_t* frustum, const vec3_t* center, float radius) {
+	for (int i = 0; i < FRUSTUM_PLANES; i++) {
+		const plane_t* plane = &frustum->planes[i];
+		if (vec3_dot(&plane->normal, center) + plane->distance < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool frustum_test_aabb(const frustum_t* frustum, const aabb_t* aabb) {
+	for (int i = 0; i < FRUSTUM_PLANES; i++) {
+		const plane_t* plane = &frustum->planes[i];
+
+		// Corner furthest along the plane normal, if it is outside so is the box
+		vec3_t corner = {
+			plane->normal.x >= 0.0f ? aabb->max.x : aabb->min.x,
+			plane->normal.y >= 0.0f ? aabb->max.y : aabb->min.y,
+			plane->normal.z >= 0.0f ? aabb->max.z : aabb->min.z
+		};
+		if (vec3_dot(&plane->normal, &corner) + plane->distance < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
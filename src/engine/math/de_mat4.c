@@ -105,10 +105,12 @@ vec4_t mat4_mul_vec4(const mat4_t* m, const vec4_t* v) {
 
 vec4_t mat4_mul_vec4_sse(const mat4_t* m, const vec4_t* v) {
     vec4_t result;
-    __m128 col1 = _mm_load_ps(&m->m[0][0]);
-    __m128 col2 = _mm_load_ps(&m->m[1][0]);
-    __m128 col3 = _mm_load_ps(&m->m[2][0]);
-    __m128 col4 = _mm_load_ps(&m->m[3][0]);
+    // Rows are stored contiguously, transpose them into columns (unaligned, mat4_t is not 16-byte aligned)
+    __m128 col1 = _mm_loadu_ps(&m->m[0][0]);
+    __m128 col2 = _mm_loadu_ps(&m->m[1][0]);
+    __m128 col3 = _mm_loadu_ps(&m->m[2][0]);
+    __m128 col4 = _mm_loadu_ps(&m->m[3][0]);
+    _MM_TRANSPOSE4_PS(col1, col2, col3, col4);
 
     __m128 vec = _mm_set_ps(v->w, v->z, v->y, v->x);
 
@@ -119,7 +121,7 @@ vec4_t mat4_mul_vec4_sse(const mat4_t* m, const vec4_t* v) {
         _mm_mul_ps(_mm_shuffle_ps(vec, vec, 0xFF), col4))
     );
 
-    _mm_store_ps(&result.x, res);
+    _mm_storeu_ps(&result.x, res);
     return result;
 }
 
@@ -175,50 +177,75 @@ float mat4_determinant(const mat4_t* mat) {
     return det;
 }
 
+// Inverse transpose of the upper 3x3 scaled by its determinant: its rows are the cross products
+// of the other two rows. Normals come out unnormalized, only a mirroring matrix needs the sign fixed.
+mat3_t mat4_normal_matrix(const mat4_t* mat) {
+    const float (*m)[4] = mat->m;
+    mat3_t normal;
+    for (byte row = 0; row < 3; row++) {
+        byte a = (row + 1) % 3;
+        byte b = (row + 2) % 3;
+        normal.m[row][0] = m[a][1] * m[b][2] - m[a][2] * m[b][1];
+        normal.m[row][1] = m[a][2] * m[b][0] - m[a][0] * m[b][2];
+        normal.m[row][2] = m[a][0] * m[b][1] - m[a][1] * m[b][0];
+    }
+
+    float determinant = m[0][0] * normal.m[0][0] + m[0][1] * normal.m[0][1] + m[0][2] * normal.m[0][2];
+    if (determinant < 0.0f) {
+        for (byte row = 0; row < 3; row++) {
+            for (byte column = 0; column < 3; column++) {
+                normal.m[row][column] = -normal.m[row][column];
+            }
+        }
+    }
+    return normal;
+}
+
 bool mat4_inverse(const mat4_t* mat, mat4_t* result) {
-    float det = mat4_determinant(mat);
+    const float (*m)[4] = mat->m;
+
+    // 2x2 sub-determinants of the top two rows (s) and the bottom two rows (c)
+    float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+    float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+    float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+    float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+    float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+    float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+    float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+    float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+    float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+    float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+    float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+    float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+    float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
     if (fabs(det) < FLT_EPSILON) { // Handle numerical stability
         return false; // Matrix is not invertible
     }
 
     float inv_det = 1.0f / det;
 
-    // Precompute reusable sub-determinants
-    float sub1 = mat->m[2][2] * mat->m[3][3] - mat->m[2][3] * mat->m[3][2];
-    float sub2 = mat->m[2][1] * mat->m[3][3] - mat->m[2][3] * mat->m[3][1];
-    float sub3 = mat->m[2][1] * mat->m[3][2] - mat->m[2][2] * mat->m[3][1];
-    float sub4 = mat->m[2][0] * mat->m[3][3] - mat->m[2][3] * mat->m[3][0];
-    float sub5 = mat->m[2][0] * mat->m[3][2] - mat->m[2][2] * mat->m[3][0];
-    float sub6 = mat->m[2][0] * mat->m[3][1] - mat->m[2][1] * mat->m[3][0];
-
-    // Compute the adjugate matrix (cofactor matrix transposed)
-    result->m[0][0] = (mat->m[1][1] * sub1 - mat->m[1][2] * sub2 + mat->m[1][3] * sub3) * inv_det;
-    result->m[0][1] = -(mat->m[0][1] * sub1 - mat->m[0][2] * sub2 + mat->m[0][3] * sub3) * inv_det;
-    result->m[0][2] = (mat->m[0][1] * sub4 - mat->m[0][2] * sub5 + mat->m[0][3] * sub6) * inv_det;
-    result->m[0][3] = -(mat->m[0][1] * (mat->m[1][2] * mat->m[2][3] - mat->m[1][3] * mat->m[2][2]) -
-        mat->m[0][2] * (mat->m[1][1] * mat->m[2][3] - mat->m[1][3] * mat->m[2][1]) +
-        mat->m[0][3] * (mat->m[1][1] * mat->m[2][2] - mat->m[1][2] * mat->m[2][1])) * inv_det;
-
-    result->m[1][0] = -(mat->m[1][0] * sub1 - mat->m[1][2] * sub4 + mat->m[1][3] * sub5) * inv_det;
-    result->m[1][1] = (mat->m[0][0] * sub1 - mat->m[0][2] * sub4 + mat->m[0][3] * sub5) * inv_det;
-    result->m[1][2] = -(mat->m[0][0] * sub2 - mat->m[0][1] * sub4 + mat->m[0][3] * sub6) * inv_det;
-    result->m[1][3] = (mat->m[0][0] * (mat->m[1][2] * mat->m[2][3] - mat->m[1][3] * mat->m[2][2]) -
-        mat->m[0][1] * (mat->m[1][0] * mat->m[2][3] - mat->m[1][3] * mat->m[2][0]) +
-        mat->m[0][3] * (mat->m[1][0] * mat->m[2][2] - mat->m[1][2] * mat->m[2][0])) * inv_det;
-
-    result->m[2][0] = (mat->m[1][0] * sub2 - mat->m[1][1] * sub4 + mat->m[1][3] * sub6) * inv_det;
-    result->m[2][1] = -(mat->m[0][0] * sub2 - mat->m[0][1] * sub4 + mat->m[0][3] * sub6) * inv_det;
-    result->m[2][2] = (mat->m[0][0] * sub3 - mat->m[0][1] * sub5 + mat->m[0][2] * sub6) * inv_det;
-    result->m[2][3] = -(mat->m[0][0] * (mat->m[1][1] * mat->m[2][3] - mat->m[1][3] * mat->m[2][1]) -
-        mat->m[0][1] * (mat->m[1][0] * mat->m[2][3] - mat->m[1][3] * mat->m[2][0]) +
-        mat->m[0][3] * (mat->m[1][0] * mat->m[2][1] - mat->m[1][1] * mat->m[2][0])) * inv_det;
-
-    result->m[3][0] = -(mat->m[1][0] * sub3 - mat->m[1][1] * sub5 + mat->m[1][2] * sub6) * inv_det;
-    result->m[3][1] = (mat->m[0][0] * sub3 - mat->m[0][1] * sub5 + mat->m[0][2] * sub6) * inv_det;
-    result->m[3][2] = -(mat->m[0][0] * sub4 - mat->m[0][1] * sub5 + mat->m[0][2] * sub6) * inv_det;
-    result->m[3][3] = (mat->m[0][0] * (mat->m[1][1] * mat->m[2][2] - mat->m[1][2] * mat->m[2][1]) -
-        mat->m[0][1] * (mat->m[1][0] * mat->m[2][2] - mat->m[1][2] * mat->m[2][0]) +
-        mat->m[0][2] * (mat->m[1][0] * mat->m[2][1] - mat->m[1][1] * mat->m[2][0])) * inv_det;
+    // Adjugate (cofactor matrix transposed) scaled by 1/det
+    result->m[0][0] = ( m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * inv_det;
+    result->m[0][1] = (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * inv_det;
+    result->m[0][2] = ( m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * inv_det;
+    result->m[0][3] = (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * inv_det;
+
+    result->m[1][0] = (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * inv_det;
+    result->m[1][1] = ( m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * inv_det;
+    result->m[1][2] = (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * inv_det;
+    result->m[1][3] = ( m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * inv_det;
+
+    result->m[2][0] = ( m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * inv_det;
+    result->m[2][1] = (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * inv_det;
+    result->m[2][2] = ( m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * inv_det;
+    result->m[2][3] = (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * inv_det;
+
+    result->m[3][0] = (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * inv_det;
+    result->m[3][1] = ( m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * inv_det;
+    result->m[3][2] = (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * inv_det;
+    result->m[3][3] = ( m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * inv_det;
 
     return true;
 }
@@ -0,0 +1,49 @@
+/**
+* @file de_atlas.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_collection.h"
+#include "de_texture_manager.h"
+
+#define ATLAS_EXTENSION ".atlas"
+#define ATLAS_MAX_SIZE 4096
+#define ATLAS_PADDING 4    // texels of extruded border around each sprite
+#define ATLAS_MIP_LEVELS 3 // deeper levels would blend neighbouring sprites through the padding
+#define ATLAS_COMPRESSION DTEX_COMPRESSION_BC7 // card faces carry small print, worth the slower cook
+#define ATLAS_NAME_LENGTH 64
+
+typedef struct {
+	float u0;
+	float v0;
+	float u1;
+	float v1;
+} uv_rect_t;
+
+typedef struct {
+	char name[ATLAS_NAME_LENGTH];
+	int x; // texels, bottom-left origin like the texture itself
+	int y;
+	int width;
+	int height;
+	uv_rect_t uv;
+} atlas_sprite_t;
+
+typedef struct {
+	char name[ATLAS_NAME_LENGTH]; // texture name, "cards.atlas" cooks to data/binary/cards.atlas.dtex
+	texture_handle_t texture;
+	int width;
+	int height;
+	list_t sprites; // atlas_sprite_t
+} atlas_t;
+
+bool atlas_cook(list_t* images, const char* atlas_name);
+bool atlas_is_cooked(list_t* images, const char* atlas_name); // false when the list or any image changed
+bool atlas_load(atlas_t* atlas, const char* atlas_name);
+const atlas_sprite_t* atlas_find(const atlas_t* atlas, const char* sprite_name);
+void atlas_delete(atlas_t* atlas);
@@ -0,0 +1,24 @@
+/**
+* @file de_bc.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+
+#define BC_BLOCK_DIM 4
+#define BC7_REFINE_PASSES 2 // least squares endpoint refits per block, more is slower and rarely better
+
+typedef enum {
+	BC1, // opaque RGB, 8 bytes per block
+	BC3, // RGB plus interpolated alpha, 16 bytes per block
+	BC7  // RGBA, mode 6 only, 16 bytes per block
+} bc_format_t;
+
+size_t bc_image_size(bc_format_t format, int width, int height);
+void bc_encode_image(bc_format_t format, const unsigned char* pixels, int width, int height, int channels, unsigned char* blocks);
+void bc_decode_image(bc_format_t format, const unsigned char* blocks, int width, int height, unsigned char* rgba);
+double bc_psnr(const unsigned char* pixels, const unsigned char* rgba, int width, int height, int channels);
@@ -8,6 +8,8 @@
 */
 #pragma once
 #include "pch.h"
+#include "de_dtex.h"
+#include "de_gl_state.h"
 
 typedef struct {
     GLuint id;
@@ -21,6 +23,35 @@ typedef struct {
 	GLuint id;
 } ebo_t;
 
+typedef struct {
+	GLuint id;
+	GLsizeiptr size;
+} ubo_t;
+
+// Ring of STREAM_BUFFER_FRAMES segments for data rewritten every frame. The CPU fills one
+// segment while the GPU may still read the ones of the frames before, a fence per segment
+// says when it is free again. Writes map unsynchronized and never touch storage in use.
+#define STREAM_BUFFER_FRAMES 3
+
+typedef struct {
+	GLuint id;
+	GLenum target;
+	GLsizeiptr segment_size;
+	GLsizeiptr alignment;  // of every write, the uniform buffer offset alignment for uniforms
+	int segment;           // written this frame
+	GLsizeiptr head;       // bytes used in the segment
+	GLsync fences[STREAM_BUFFER_FRAMES];
+
+	GLintptr map_offset;   // of the open stream_buffer_map, -1 when none is open
+	GLsizeiptr map_size;
+	bool staged;           // the open map went to staging, the driver refused to map
+	void* staging;
+	GLsizeiptr staging_size;
+
+	int orphans;           // segments still in use when their turn came, replaced instead of waited on
+	int grows;             // frames that did not fit a segment
+} stream_buffer_t;
+
 typedef struct {
     GLuint id;
     char* path;
@@ -29,6 +60,15 @@ typedef struct {
     int channels;
 } tbo_t;
 
+typedef struct {
+    GLint wrap_s;
+    GLint wrap_t;
+    GLint min_filter;
+    GLint mag_filter;
+} sampler_t;
+
+#define SAMPLER_DEFAULT (sampler_t){ GL_REPEAT, GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR }
+
 // Buffer
 void buffer_init(vao_t* vao, vbo_t* vbo, ebo_t* ebo);
 void buffer_bind(vao_t* vao, vbo_t* vbo, ebo_t* ebo);
@@ -50,6 +90,10 @@ void vao_link_vbo_3f3f();
 void vao_link_vbo_3f2f3f();
 void vao_link_vbo_3f3f2f();
 void vao_link_vbo_3f3f3f();
+void vao_link_vbo_packed();
+void vao_link_vbo_packed_quantized();
+void vao_link_vbo_instances(GLintptr offset);
+void vao_link_vbo_2f2f4ub(GLintptr offset);
 
 void vao_delete(vao_t* vao);
 void vao_destroy(vao_t* vao);
@@ -57,7 +101,7 @@ void vao_destroy(vao_t* vao);
 // Vertex Buffer Object (VBO)
 vbo_t* vbo_new(void);
 void vbo_init(vbo_t* vbo);
-void vbo_set_data(vbo_t* vbo, GLfloat* vertices, GLsizeiptr size);
+void vbo_set_data(vbo_t* vbo, const GLvoid* vertices, GLsizeiptr size);
 void vbo_bind(vbo_t* vbo);
 void vbo_unbind(void);
 void vbo_delete(vbo_t* vbo);
@@ -66,18 +110,44 @@ void vbo_destroy(vbo_t* vbo);
 // Element Buffer Object (EBO)
 ebo_t* ebo_new(void);
 void ebo_init(ebo_t* ebo);
-void ebo_set_data(ebo_t* ebo, GLuint* indices, GLsizeiptr size);
+void ebo_set_data(ebo_t* ebo, const GLvoid* indices, GLsizeiptr size);
 void ebo_bind(ebo_t* ebo);
 void ebo_unbind(void);
 void ebo_delete(ebo_t* ebo);
 void ebo_destroy(ebo_t* ebo);
 
+// Uniform Buffer Object (UBO)
+void ubo_init(ubo_t* ubo, GLsizeiptr size);
+void ubo_set_data(ubo_t* ubo, const GLvoid* data, GLsizeiptr size);
+void ubo_bind_base(ubo_t* ubo, GLuint binding);
+void ubo_delete(ubo_t* ubo);
+
+// Streaming ring buffer
+void stream_buffer_init(stream_buffer_t* stream, GLenum target, GLsizeiptr segment_size);
+void stream_buffer_begin_frame(stream_buffer_t* stream);
+void* stream_buffer_map(stream_buffer_t* stream, GLsizeiptr size, GLintptr* offset);
+void stream_buffer_unmap(stream_buffer_t* stream);
+GLintptr stream_buffer_write(stream_buffer_t* stream, const GLvoid* data, GLsizeiptr size);
+void stream_buffer_bind(stream_buffer_t* stream);
+void stream_buffer_bind_range(stream_buffer_t* stream, GLuint binding, GLintptr offset, GLsizeiptr size);
+void stream_buffer_delete(stream_buffer_t* stream);
+
 // Texture Buffer Object (TBO)
 tbo_t* tbo_new(void);
 void tbo_init(tbo_t* tbo, const char* path);
 void tbo_bind(tbo_t* tbo);
 void tbo_bind_slot(tbo_t* tbo, GLuint slot);
 bool tbo_load(tbo_t* tbo);
+bool tbo_sampler_reads_mips(const sampler_t* sampler);
+bool tbo_load_sampler(tbo_t* tbo, const sampler_t* sampler);
+unsigned char* tbo_decode(const char* path, int* width, int* height, int* channels);
+void tbo_upload(tbo_t* tbo, const sampler_t* sampler, const GLvoid* pixels);
+bool tbo_supports_dtex(const dtex_t* dtex);
+void tbo_upload_dtex(tbo_t* tbo, const sampler_t* sampler, const dtex_t* dtex, const GLvoid* data);
+void tbo_upload_dtex_from(tbo_t* tbo, const sampler_t* sampler, const dtex_t* dtex, int first_level, const GLvoid* data);
+void tbo_upload_dtex_level(tbo_t* tbo, const dtex_t* dtex, int level, const GLvoid* pixels);
+void tbo_evict_level(tbo_t* tbo, int level);
+void tbo_set_level_range(tbo_t* tbo, int base_level, int max_level);
 void tbo_map_texture(tbo_t* tbo, GLuint texture_unit);
 void tbo_unbind(void);
 void tbo_delete(tbo_t* tbo);
@@ -33,6 +33,7 @@ typedef struct {
 
 mat4_t camera_perspective(const float near, const float far);
 mat4_t camera_look_at(camera_t* camera);
+float camera_projection_scale(void); // pixels per world unit at distance 1
 
 orbit_camera_t* orbit_camera_new(void);
 void orbit_camera_update(orbit_camera_t* camera);
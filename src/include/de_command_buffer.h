@@ -0,0 +1,75 @@
+/**
+* @file de_command_buffer.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_mesh.h"
+#include "de_buffer.h"
+#include "de_vector.h"
+#include "de_matrix.h"
+#include "de_collection.h"
+#include "de_mesh_manager.h"
+#include "de_shader_manager.h"
+#include "de_texture_manager.h"
+
+// Rendering work written down instead of sent to the driver. Recording makes no GL call,
+// so any thread can fill a buffer; only the GL thread executes one, in recorded order.
+// Data too big for a command, matrices and meshlet ranges, is copied into
+// the payload of the buffer and referenced by its offset there.
+typedef enum {
+	COMMAND_BIND_PROGRAM,   // also points its texture sampler at unit 0
+	COMMAND_BIND_MATERIAL,
+	COMMAND_BIND_TEXTURE,
+	COMMAND_BIND_MESH,
+	COMMAND_BIND_INSTANCES,
+	COMMAND_UNIFORM_VEC3,
+	COMMAND_UNIFORM_MAT4,
+	COMMAND_DRAW,
+	COMMAND_DRAW_INSTANCED,
+	COMMAND_DRAW_MESHLETS
+} command_type_t;
+
+typedef struct {
+	command_type_t type;
+	union {
+		struct { program_handle_t program; GLint uniform_texture; } program;
+		struct { int index; } material;
+		struct { texture_handle_t texture; GLuint unit; } texture;
+		struct { mesh_handle_t mesh; stream_buffer_t* stream; GLintptr offset; } instances;
+		struct { GLint location; vec3_t value; } vec3;
+		struct { GLint location; size_t payload; } mat4;
+		struct { mesh_handle_t mesh; int lod; int instance_count; } draw;     // DRAW and DRAW_INSTANCED
+		struct { mesh_handle_t mesh; int range_count; size_t payload; } meshlets; // offsets, then counts
+		mesh_handle_t mesh;
+	};
+} command_t;
+
+typedef struct {
+	list_t commands;        // command_t
+	unsigned char* payload;
+	size_t payload_size;
+	size_t payload_capacity;
+} command_buffer_t;
+
+void command_buffer_init(command_buffer_t* buffer);
+void command_buffer_reset(command_buffer_t* buffer);
+void command_buffer_free(command_buffer_t* buffer);
+
+void command_buffer_bind_program(command_buffer_t* buffer, program_handle_t program, GLint uniform_texture);
+void command_buffer_bind_material(command_buffer_t* buffer, int material);
+void command_buffer_bind_texture(command_buffer_t* buffer, texture_handle_t texture, GLuint unit);
+void command_buffer_bind_mesh(command_buffer_t* buffer, mesh_handle_t mesh);
+void command_buffer_bind_instances(command_buffer_t* buffer, mesh_handle_t mesh, stream_buffer_t* stream, GLintptr offset);
+void command_buffer_uniform_vec3(command_buffer_t* buffer, GLint location, vec3_t value);
+void command_buffer_uniform_mat4(command_buffer_t* buffer, GLint location, const mat4_t* matrix);
+void command_buffer_draw(command_buffer_t* buffer, mesh_handle_t mesh, int lod);
+void command_buffer_draw_instanced(command_buffer_t* buffer, mesh_handle_t mesh, int lod, int instance_count);
+// Culls the meshlets of the object straight into the payload, draws what survived
+void command_buffer_draw_meshlets(command_buffer_t* buffer, mesh_handle_t mesh, const mat4_t* model, const mat4_t* view_projection, const vec3_t* eye);
+
+void command_buffer_execute(const command_buffer_t* buffer);
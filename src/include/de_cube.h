@@ -10,25 +10,22 @@
 #include "de_light.h"
 #include "de_material.h"
 #include "de_game_object.h"
+#include "de_render_queue.h"
 
+// View, projection, eye and lights come from the frame block, see de_frame.h
 typedef struct {
 	material_t material;
-	directional_light_t light;
 	game_object_t go;
 
-	GLint uniform_material_ambient;
-	GLint uniform_material_specular;
-	GLint uniform_material_shininess;
-	GLint uniform_material_diffuse_map;
-
-	GLint uniform_light_direction;
-	GLint uniform_light_ambient;
-	GLint uniform_light_diffuse;
-	GLint uniform_light_specular;
+	GLint uniform_dequant_scale;
+	GLint uniform_dequant_offset;
 } cube_t;
 
 void cube_init(cube_t* cube, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model);
+void cube_init_with_format(cube_t* cube, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model, vertex_format_t format);
+void cube_init_instanced(cube_t* cube, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model, vertex_format_t format);
 void cube_render(cube_t* cube, mat4_t* view, mat4_t* projection);
+void cube_submit(cube_t* cube, render_queue_t* queue);
 void cube_update(cube_t* cube);
 void cube_delete(cube_t* cube);
 
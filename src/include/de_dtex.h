@@ -0,0 +1,80 @@
+/**
+* @file de_dtex.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+
+// Cooked texture container: header, level table, then the pixels of every mip level,
+// bottom row first (GL orientation). Levels are either tightly packed bytes ready for
+// glTexImage2D or BC blocks ready for glCompressedTexImage2D. Single channel data, like
+// distance fields, is never compressed.
+#define DTEX_MAGIC 0x58455444u // "DTEX"
+#define DTEX_VERSION 3
+#define DTEX_EXTENSION ".dtex"
+#define DTEX_MAX_LEVELS 16
+
+#define DTEX_FLAG_SRGB 0x1u // color data, mips were filtered in linear space
+
+typedef enum {
+	DTEX_FORMAT_RGB8,
+	DTEX_FORMAT_RGBA8,
+	DTEX_FORMAT_BC1,
+	DTEX_FORMAT_BC3,
+	DTEX_FORMAT_BC7,
+	DTEX_FORMAT_R8
+} dtex_format_t;
+
+typedef enum {
+	DTEX_COMPRESSION_NONE,
+	DTEX_COMPRESSION_BC,  // BC1 when every texel is opaque, BC3 otherwise
+	DTEX_COMPRESSION_BC7  // higher quality, slower to cook
+} dtex_compression_t;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t channels;
+	uint32_t flags;
+	uint32_t level_count;
+	uint32_t format; // dtex_format_t
+	uint32_t reserved;
+	uint64_t source_stamp; // file_stamp of the source image, 0 when cooked from memory
+} dtex_header_t;
+
+typedef struct {
+	uint32_t width;
+	uint32_t height;
+	uint32_t offset; // from the start of the file
+	uint32_t size;
+} dtex_level_t;
+
+typedef struct {
+	const dtex_header_t* header;
+	const dtex_level_t* levels;
+	const unsigned char* base; // mapped view of the whole file
+	size_t size;
+
+	HANDLE file;
+	HANDLE mapping;
+} dtex_t;
+
+bool dtex_cook(const char* source_path, const char* cooked_path, uint32_t flags, dtex_compression_t compression);
+bool dtex_write(const char* cooked_path, const unsigned char* pixels, int width, int height, int channels, uint32_t flags, dtex_compression_t compression, int max_levels, uint64_t source_stamp);
+bool dtex_open(dtex_t* dtex, const char* cooked_path);
+bool dtex_open_cooked(dtex_t* dtex, const char* source_path);
+void dtex_close(dtex_t* dtex);
+bool dtex_is_valid(const char* cooked_path);
+bool dtex_is_current(const char* cooked_path, const char* source_path);
+bool dtex_is_compressed(const dtex_t* dtex);
+
+char* dtex_cooked_path(const char* source_path);
+const unsigned char* dtex_data(const dtex_t* dtex);
+size_t dtex_data_size(const dtex_t* dtex);
+void dtex_prefetch(const dtex_t* dtex);
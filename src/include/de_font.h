@@ -0,0 +1,82 @@
+/**
+* @file de_font.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_atlas.h"
+#include "de_color.h"
+#include "de_vector.h"
+#include "de_collection.h"
+#include "de_sprite_batch.h"
+#include "de_texture_manager.h"
+
+// Signed distance field fonts. A TrueType font is cooked once into pages holding, for every
+// glyph, the distance of each texel to the outline, so one bake stays sharp at any size.
+// The edge is at 0.5, inside is above it. Printable ASCII only, other bytes draw as '?'.
+#define FONT_EXTENSION ".font"
+#define FONT_NAME_LENGTH 64
+#define FONT_FIRST_GLYPH 32
+#define FONT_LAST_GLYPH 126
+#define FONT_GLYPH_COUNT (FONT_LAST_GLYPH - FONT_FIRST_GLYPH + 1)
+#define FONT_SDF_SIZE 48     // pixels per em the field is baked at
+#define FONT_SDF_SPREAD 6    // texels of distance on each side of the edge
+#define FONT_SDF_UPSCALE 4   // outlines are rasterized this much larger, distances measured there
+#define FONT_PAGE_SIZE 512
+#define FONT_MAX_PAGES 4
+#define FONT_PADDING 4       // texels between glyphs, as deep as the mips reach
+#define FONT_MIP_LEVELS 3
+
+typedef struct {
+	int page;       // -1 for glyphs with nothing to draw, like the space
+	uv_rect_t uv;
+	float x;        // top-left of the quad from the pen on the baseline, y down
+	float y;
+	float width;
+	float height;
+	float advance;
+} font_glyph_t;
+
+typedef struct {
+	char name[FONT_NAME_LENGTH]; // "consola.font" cooks to data/binary/consola.font and consola.font0.dtex...
+	float size;                  // pixels per em of every metric below, FONT_SDF_SIZE
+	float ascent;
+	float line_height;
+	font_glyph_t glyphs[FONT_GLYPH_COUNT];
+	float* kerning;              // FONT_GLYPH_COUNT squared, first glyph major; NULL without pairs
+	int page_count;
+	texture_handle_t pages[FONT_MAX_PAGES];
+} font_t;
+
+bool font_cook(const char* font_file, const char* font_name);
+bool font_is_cooked(const char* font_file, const char* font_name);
+bool font_load(font_t* font, const char* font_name);
+const font_glyph_t* font_glyph(const font_t* font, char c);
+float font_kerning(const font_t* font, char first, char second);
+void font_delete(font_t* font);
+
+// Text is laid out from its top-left corner in pixels, size is the height of an em.
+// Drawn through a sprite batch running an SDF program, one draw per font page.
+typedef struct {
+	texture_handle_t texture;
+	uv_rect_t uv;
+	vec2_t position; // top-left, from the top-left of the text
+	vec2_t size;
+} text_glyph_t;
+
+// Layout of a string that does not change, done once and drawn as often as needed
+typedef struct {
+	list_t glyphs; // text_glyph_t
+	vec2_t bounds;
+} text_run_t;
+
+void text_run_init(text_run_t* run, const font_t* font, const char* text, float size);
+void text_run_draw(const text_run_t* run, sprite_batch_t* batch, vec2_t position, color_t color, int layer);
+void text_run_free(text_run_t* run);
+
+void text_draw(sprite_batch_t* batch, const font_t* font, const char* text, float size, vec2_t position, color_t color, int layer);
+vec2_t text_measure(const font_t* font, const char* text, float size);
@@ -0,0 +1,29 @@
+/**
+* @file de_frame.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_light.h"
+#include "de_vector.h"
+#include "de_matrix.h"
+
+// Everything the shaders read that is the same for every object drawn in a frame
+typedef struct {
+	mat4_t view;
+	mat4_t projection;
+	vec3_t eye;
+
+	directional_light_t directional_light;
+	point_light_t point_light;
+	spot_light_t spot_light;
+	bool spot_light_on;
+} frame_t;
+
+frame_t frame_init(void);
+void frame_upload(const frame_t* frame);
+void frame_shutdown(void);
@@ -0,0 +1,36 @@
+/**
+* @file de_frustum.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_vector.h"
+#include "de_matrix.h"
+#include "de_model.h"
+
+typedef enum {
+	FRUSTUM_LEFT,
+	FRUSTUM_RIGHT,
+	FRUSTUM_BOTTOM,
+	FRUSTUM_TOP,
+	FRUSTUM_NEAR,
+	FRUSTUM_FAR,
+	FRUSTUM_PLANES
+} frustum_plane_t;
+
+typedef struct {
+	vec3_t normal; // points inside the frustum
+	float distance;
+} plane_t;
+
+typedef struct {
+	plane_t planes[FRUSTUM_PLANES];
+} frustum_t;
+
+frustum_t frustum_from_matrix(const mat4_t* matrix);
+bool frustum_test_sphere(const frustum_t* frustum, const vec3_t* center, float radius);
+bool frustum_test_aabb(const frustum_t* frustum, const aabb_t* aabb);
@@ -14,33 +14,46 @@
 #include "de_vector.h"
 #include "de_matrix.h"
 #include "de_program.h"
+#include "de_frustum.h"
+#include "de_mesh_manager.h"
+#include "de_shader_manager.h"
+#include "de_texture_manager.h"
 
 typedef struct {
 	mat4_t model;
     vec3_t scale;
     vec3_t rotation;
     vec3_t position;
+    bool dirty; // transform changed since the model matrix was built
 
-    vao_t vao;
+    aabb_t world_bounds;
+    sphere_t world_sphere;
+
+    vao_t vao; // 2d objects only, 3d objects draw the buffers of their shared mesh
     vbo_t vbo;
     ebo_t ebo;
-    tbo_t tbo;
+    texture_handle_t texture;
     
-    program_t program;
-	mesh_t mesh;
+    program_handle_t program;
+	mesh_handle_t mesh;
+    int lod;
+    bool instanced; // program reads the model matrix per instance, drawn through a render queue only
 
     GLint uniform_model;
-    GLint uniform_view;
-    GLint uniform_projection;
     GLint uniform_texture;
 } game_object_t;
 
 void game_object_init(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture);
-void game_object_3d_init(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model);
+void game_object_3d_init(game_object_t* go, const char* vertex_shader, const char* fragment_shader, const char* texture, const char* model, vertex_format_t format, shader_key_t features);
+mesh_t* game_object_get_mesh(const game_object_t* go);
 
 void game_object_update_model_matrix(game_object_t* go);
 void game_object_scale(game_object_t* go, const vec3_t* scale);
 void game_object_rotate(game_object_t* go, const vec3_t* rotation);
 void game_object_translate(game_object_t* go, const vec3_t* position);
+void game_object_select_lod(game_object_t* go, const vec3_t* eye);
+void game_object_request_texture(const game_object_t* go, const vec3_t* eye);
 
-bool game_object_ray_intersect(const game_object_t* go, const ray_t* ray, int i);
+void game_object_update_bounds(game_object_t* go);
+bool game_object_in_frustum(const game_object_t* go, const frustum_t* frustum);
+bool game_object_ray_intersect(const game_object_t* go, const ray_t* ray, float* distance);
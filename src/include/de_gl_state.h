@@ -0,0 +1,48 @@
+/**
+* @file de_gl_state.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+
+// Shadow of the GL state the engine changes. Every bind goes through here and only reaches
+// the driver when it changes something, which only holds as long as nothing calls GL directly.
+#define GL_STATE_TEXTURE_UNITS    16
+#define GL_STATE_UNIFORM_BINDINGS 16
+#define GL_STATE_UNKNOWN          0xFFFFFFFFu
+
+typedef struct {
+	int issued;  // calls that reached the driver
+	int skipped; // calls that would not have changed anything
+} gl_state_stats_t;
+
+void gl_state_reset(void);
+
+void gl_state_use_program(GLuint program);
+void gl_state_bind_vertex_array(GLuint vertex_array);
+void gl_state_bind_buffer(GLenum target, GLuint buffer);
+void gl_state_bind_buffer_base(GLenum target, GLuint index, GLuint buffer);
+void gl_state_bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+void gl_state_active_texture(GLuint unit);
+void gl_state_bind_texture(GLenum target, GLuint texture); // on the active unit
+void gl_state_bind_sampler(GLuint unit, GLuint sampler);
+
+void gl_state_set_capability(GLenum capability, bool enabled);
+void gl_state_blend_func(GLenum source, GLenum destination);
+void gl_state_depth_func(GLenum func);
+void gl_state_depth_mask(GLboolean mask);
+
+// Deleting a bound object sets its bindings back to 0, a program in use stays in use
+// until the next one and its name can be handed out again before that
+void gl_state_forget_program(GLuint program);
+void gl_state_forget_vertex_array(GLuint vertex_array);
+void gl_state_forget_buffer(GLuint buffer);
+void gl_state_forget_texture(GLuint texture);
+
+gl_state_stats_t gl_state_stats(void);
+void gl_state_reset_stats(void);
+bool gl_state_validate(void);
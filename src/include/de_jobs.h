@@ -0,0 +1,21 @@
+/**
+* @file de_jobs.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+
+// A pool of persistent worker threads for work split in independent parts, started on
+// first use. The calling thread runs parts too and returns once every part is done, so
+// anything the parts wrote is ready to use. One batch at a time, from the main thread.
+#define JOBS_MAX_WORKERS 7
+
+typedef void (*job_func_t)(void* data, int part);
+
+void jobs_run(job_func_t func, void* data, int part_count);
+int jobs_thread_count(void); // workers plus the calling thread
+void jobs_shutdown(void);
@@ -20,6 +20,12 @@ typedef struct {
 material_t material_init(void);
 material_t* material_new(vec3_t ambient, vec3_t diffuse, vec3_t specular, float shininess);
 
+// Uniform buffers, shared by every object with the same material
+int material_buffer(const material_t* material); // index of the buffer, created on first use
+void material_bind_buffer(int index);
+void material_bind(const material_t* material);
+void material_shutdown(void);
+
 material_t material_emerald(void);
 material_t material_jade(void);
 material_t material_obsidian(void);
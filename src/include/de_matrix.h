@@ -48,6 +48,9 @@ mat4_t mat4_mul_mat4_sse(const mat4_t* a, const mat4_t* b);
 float mat4_determinant(const mat4_t* mat);
 bool mat4_inverse(const mat4_t* mat, mat4_t* result);
 
+// Normal matrix function
+mat3_t mat4_normal_matrix(const mat4_t* mat);
+
 // 3d Camera functions
 mat4_t mat4_look_at(const vec3_t* eye, const vec3_t* target, const vec3_t* up);
 mat4_t mat4_perspective(const float fov, const float aspect, const float near, const float far);
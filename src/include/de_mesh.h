@@ -9,18 +9,96 @@
 #pragma once
 #include "pch.h"
 #include "de_model.h"
+#include "de_buffer.h"
 #include "de_vector.h"
+#include "de_matrix.h"
+
+typedef enum {
+	VERTEX_FORMAT_FLOAT,            // 3f position, 3f normal, 2f uv (32 bytes)
+	VERTEX_FORMAT_PACKED,           // 3f position, oct normal, half uv (20 bytes)
+	VERTEX_FORMAT_PACKED_QUANTIZED  // 4s position, oct normal, half uv (16 bytes)
+} vertex_format_t;
+
+#define MESH_MAX_LODS 4
+
+typedef struct {
+	int index_offset; // first index of this level in mesh->indices
+	int index_count;
+	float error;      // object-space deviation from lod 0
+} mesh_lod_t;
+
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+
+typedef struct {
+	int index_offset; // first index of this cluster in mesh->indices
+	int index_count;
+	int vertex_count; // unique vertices referenced
+
+	vec3_t center;    // bounding sphere
+	float radius;
+	vec3_t cone_axis; // average facing of the triangles
+	float cone_cutoff; // sine of the cone half angle, 1 disables cone culling
+} meshlet_t;
+
+typedef struct {
+	GLsizei* counts;
+	const GLvoid** offsets;
+	int range_count;     // merged index ranges to draw
+	int visible_count;   // meshlets that passed culling
+} meshlet_draw_list_t;
 
 typedef struct {
 	vertex_t* vertices; 
 	face_t* faces;
+	unsigned int* indices;
 	
 	int vertex_count;
 	int face_count;
+	int index_count;
+
+	vertex_format_t format;
+	GLenum index_type;
+	vec3_t dequant_scale;
+	vec3_t dequant_offset;
+
+	aabb_t bounds;     // object space
+	sphere_t sphere;
+
+	mesh_lod_t lods[MESH_MAX_LODS];
+	int lod_count;
+
+	meshlet_t* meshlets; // clusters of lod 0
+	int meshlet_count;
+	meshlet_draw_list_t meshlet_draws;
 } mesh_t;
 
 mesh_t* mesh_new(void);
-void mesh_load_obj(mesh_t* mesh, const char* path);
+bool mesh_load_obj(mesh_t* mesh, const char* path);
+bool mesh_import(mesh_t* mesh, const char* file_path);
+void mesh_process(mesh_t* mesh); // bounds, lods and meshlets of a freshly parsed mesh
 unsigned int* mesh_index_to_gl_buffer(mesh_t* mesh);
+unsigned short* mesh_index_to_gl_buffer_u16(mesh_t* mesh);
 float* mesh_vertex_to_gl_buffer(mesh_t* mesh);
+packed_vertex_t* mesh_vertex_to_packed_buffer(mesh_t* mesh);
+quantized_vertex_t* mesh_vertex_to_quantized_buffer(mesh_t* mesh);
+void mesh_compute_bounds(mesh_t* mesh);
+size_t mesh_vertex_stride(vertex_format_t format);
+void mesh_upload(mesh_t* mesh, vao_t* vao, vbo_t* vbo, ebo_t* ebo, vertex_format_t format);
+void mesh_draw(mesh_t* mesh);
+void mesh_draw_lod(mesh_t* mesh, int lod);
+void mesh_draw_lod_instanced(mesh_t* mesh, int lod, int instance_count);
+
+// Level of detail
+void mesh_build_lods(mesh_t* mesh, int lod_count, float ratio);
+int mesh_select_lod(const mesh_t* mesh, int current_lod, float distance, float scale, float pixels_per_unit);
+
+// Meshlets
+void mesh_build_meshlets(mesh_t* mesh);
+void mesh_cull_meshlets(mesh_t* mesh, const mat4_t* model, const mat4_t* view_projection, const vec3_t* eye);
+void mesh_draw_meshlets(mesh_t* mesh);
+void mesh_cull_meshlets_into(const mesh_t* mesh, const mat4_t* model, const mat4_t* view_projection, const vec3_t* eye, meshlet_draw_list_t* draws);
+void mesh_draw_meshlet_list(const mesh_t* mesh, const meshlet_draw_list_t* draws);
+void mesh_delete_meshlets(mesh_t* mesh);
+
 void mesh_delete(mesh_t* mesh);
@@ -0,0 +1,35 @@
+/**
+* @file de_mesh_manager.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_mesh.h"
+#include "de_buffer.h"
+
+typedef int mesh_handle_t;
+#define MESH_HANDLE_INVALID -1
+
+typedef struct {
+	char* path;             // registry key, together with the vertex format
+	vertex_format_t format;
+	int ref_count;
+
+	mesh_t* mesh;
+	vao_t vao;
+	vbo_t vbo;
+	ebo_t ebo;
+} shared_mesh_t;
+
+mesh_handle_t mesh_mgr_acquire(const char* path, vertex_format_t format);
+mesh_handle_t mesh_mgr_adopt(const char* name, mesh_t* mesh, vertex_format_t format);
+void mesh_mgr_retain(mesh_handle_t handle);
+void mesh_mgr_release(mesh_handle_t handle);
+shared_mesh_t* mesh_mgr_get(mesh_handle_t handle);
+void mesh_mgr_bind(mesh_handle_t handle);
+void mesh_mgr_bind_instances(mesh_handle_t handle, stream_buffer_t* instances, GLintptr offset);
+int mesh_mgr_count(void);
@@ -9,6 +9,7 @@
 #pragma once
 #include "pch.h"
 #include "de_vector.h"
+#include "de_shader.h"
 
 typedef struct {
     int first;
@@ -64,6 +65,20 @@ typedef struct {
     tex2_t uv;
 } vertex_t;
 
+// Packed vertex: float position, octahedral normal (2x snorm16), half-float uv
+typedef struct {
+    vec3_t position;
+    int16_t normal[2];
+    uint16_t uv[2];
+} packed_vertex_t;
+
+// Quantized vertex: int16 position dequantized with a per-mesh scale and offset
+typedef struct {
+    int16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+} quantized_vertex_t;
+
 typedef struct {
 	int vertex[3];
 	int uv[3];
@@ -75,8 +90,20 @@ typedef struct {
     vec3_t direction;
 } ray_t;
 
+typedef struct {
+    vec3_t min;
+    vec3_t max;
+} aabb_t;
+
+typedef struct {
+    vec3_t center;
+    float radius;
+} sphere_t;
+
 typedef struct {
     char* name;
     char* vert;
     char* frag;
+    char* defines;    // NULL for none
+    shader_key_t key; // features compiled in, on top of the defines
 } recipe_t;
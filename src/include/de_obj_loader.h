@@ -10,4 +10,4 @@
 #include "pch.h"
 #include "de_mesh.h"
 
-void obj_load(mesh_t* mesh, const char* path);
+bool obj_load(mesh_t* mesh, const char* path); // false when the file cannot be opened, the mesh is left untouched
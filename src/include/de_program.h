@@ -12,19 +12,56 @@
 #include "de_matrix.h"
 #include "de_shader.h"
 
+// One active uniform, attribute or uniform block, keyed by NAME_HASH of its name
+typedef struct {
+    uint32_t hash;
+    GLint location; // uniform or attribute location, block index for blocks
+    GLenum type;    // 0 marks a free slot, GL_UNIFORM_BLOCK for blocks
+    GLint size;     // array length, data size in bytes for blocks
+} program_symbol_t;
+
+// Open addressing with linear probing, capacity is a power of two
+typedef struct {
+    program_symbol_t* symbols;
+    uint32_t mask;
+} program_table_t;
+
 typedef struct {
     GLuint id;
+
+    // Filled by reflection once the program links, empty before that
+    program_table_t uniforms;
+    program_table_t attributes;
+    program_table_t blocks;
 } program_t;
 
+// A compile and link that has been issued but whose status has not been read back yet.
+// Status queries block, so many builds are begun before any of them is ended.
+typedef struct {
+    program_t* program;
+    shader_t vertex_shader;
+    shader_t fragment_shader;
+} program_build_t;
+
 // Program initialization functions
 program_t* program_new(void);
 void program_init(program_t* program);
 bool program_compile(program_t* program, const GLchar* vertex_path, const GLchar* fragment_path);
+bool program_compile_defines(program_t* program, const GLchar* vertex_path, const GLchar* fragment_path, const GLchar* defines);
 bool program_link(program_t* program, shader_t* vertex_shader, shader_t* fragment_shader);
-bool program_save_binary(program_t* program, const char* binary_path);
-program_t* program_load_binary(const char* binray_Path);
+void program_link_begin(program_t* program, shader_t* vertex_shader, shader_t* fragment_shader);
+bool program_link_end(program_t* program);
+bool program_save_binary(program_t* program, const char* binary_path, uint64_t source_hash);
+bool program_load_binary(program_t* program, const char* binary_path, uint64_t source_hash);
 GLenum program_get_supported_bin_formats(void);
 
+// Batched compilation functions
+bool program_parallel_compile_supported(void);
+void program_set_max_compiler_threads(GLuint count);
+bool program_build_begin(program_build_t* build, program_t* program, const GLchar* vertex_path, const GLchar* fragment_path, const GLchar* defines);
+bool program_build_is_done(const program_build_t* build);
+bool program_build_end(program_build_t* build);
+
 // Program management functions
 void program_set(program_t* program);
 void program_unset(void);
@@ -32,7 +69,14 @@ void program_delete(program_t* program);
 void program_destroy(program_t* program);
 void program_detach_shader(program_t* program, shader_t* shader);
 
-// Shader uniform functions
+// Reflection functions, lookups take NAME_HASH(name) and return -1 for names the program does not use
+void program_reflect(program_t* program);
+GLint program_find_uniform(const program_t* program, uint32_t name_hash);
+GLint program_find_attribute(const program_t* program, uint32_t name_hash);
+GLint program_find_uniform_block(const program_t* program, uint32_t name_hash);
+const program_symbol_t* program_find_symbol(const program_table_t* table, uint32_t name_hash);
+
+// Shader uniform functions, a location of -1 is skipped without reaching the driver
 GLint program_get_uniform_location(program_t* program, const GLchar* name);
 void program_set_uniform1i(GLint location, GLint value);
 void program_set_uniform1f(GLint location, GLfloat value);
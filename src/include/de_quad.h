@@ -1,4 +1,5 @@
 #pragma once
+#include "de_atlas.h"
 #include "de_game_object.h"
 
 typedef struct {
@@ -6,6 +7,7 @@ typedef struct {
 } quad_t;
 
 void quad_init(quad_t* quad, const char* vertex_shader, const char* fragment_shader, const char* texture);
+void quad_init_sprite(quad_t* quad, const char* vertex_shader, const char* fragment_shader, const atlas_t* atlas, const char* sprite_name);
 void quad_render(quad_t* quad);
 void quad_update(quad_t* quad);
 void quad_delete(quad_t* quad);
@@ -0,0 +1,100 @@
+/**
+* @file de_render_queue.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_vector.h"
+#include "de_matrix.h"
+#include "de_collection.h"
+#include "de_jobs.h"
+#include "de_command_buffer.h"
+#include "de_mesh_manager.h"
+#include "de_shader_manager.h"
+#include "de_texture_manager.h"
+
+typedef enum {
+	RENDER_PASS_OPAQUE,      // front to back
+	RENDER_PASS_TRANSPARENT  // back to front, after every opaque draw
+} render_pass_t;
+
+// Sort key, most significant field first: pass, program, material, texture, mesh, depth.
+// Draws sharing a program end up next to each other, then the ones sharing a material, a
+// texture and a mesh. The transparent pass moves depth right after the pass instead.
+// Handles wider than their field only group less well, the queue compares the real
+// handles before changing any state.
+#define RENDER_KEY_PASS_BITS     4
+#define RENDER_KEY_PROGRAM_BITS  12
+#define RENDER_KEY_MATERIAL_BITS 10
+#define RENDER_KEY_TEXTURE_BITS  12
+#define RENDER_KEY_MESH_BITS     12
+#define RENDER_KEY_DEPTH_BITS    14
+#define RENDER_KEY_STATE_BITS    (RENDER_KEY_PROGRAM_BITS + RENDER_KEY_MATERIAL_BITS + RENDER_KEY_TEXTURE_BITS + RENDER_KEY_MESH_BITS)
+
+// The sorted entries are split in ranges recorded in parallel, each into its own command
+// buffer, then replayed in order on the GL thread. Smaller queues are not worth splitting.
+#define RENDER_QUEUE_MAX_RANGES (JOBS_MAX_WORKERS + 1)
+#define RENDER_QUEUE_RANGE_MIN  128
+
+typedef struct {
+	program_handle_t program;
+	int material;             // buffer index, see material_buffer
+	texture_handle_t texture; // bound to unit 0
+	mesh_handle_t mesh;
+	int lod;
+	const mat4_t* model;      // read when the queue runs, not when the item is submitted
+	bool instanced;           // program reads the model from the instance buffer, see SHADER_INSTANCED
+
+	GLint uniform_model;
+	GLint uniform_texture;
+	GLint uniform_dequant_scale;  // -1 for programs without packed vertices
+	GLint uniform_dequant_offset;
+} render_item_t;
+
+// Per object data of instanced programs, laid out for vao_link_vbo_instances
+typedef struct {
+	float model[MAT4];  // column major
+	float normal[12];   // normal matrix, three columns padded to vec4
+} render_instance_t;
+
+typedef struct {
+	int draws;
+	int instances;      // items drawn by instanced draws
+	int program_switches;
+	int material_switches;
+	int texture_switches;
+	int mesh_switches;
+} render_stats_t;
+
+typedef struct {
+	uint64_t key;
+	uint32_t index; // into items
+} render_entry_t;
+
+typedef struct {
+	list_t items;   // render_item_t, in submission order
+	list_t entries; // render_entry_t, sorted by key when the queue runs
+	list_t scratch; // render_entry_t, the other half of the radix sort
+	stream_buffer_t instances; // render_instance_t, instanced items in draw order
+	GLintptr instance_offset;  // of this frame's instances
+	command_buffer_t commands[RENDER_QUEUE_MAX_RANGES]; // recorded by render_queue_execute
+	int range_count;
+
+	mat4_t view_projection; // meshlet culling
+	vec3_t eye;             // depth of the items and meshlet cone culling
+	render_stats_t stats;   // of the last render_queue_execute
+} render_queue_t;
+
+void render_queue_init(render_queue_t* queue);
+void render_queue_begin(render_queue_t* queue, const mat4_t* view, const mat4_t* projection, const vec3_t* eye);
+void render_queue_submit(render_queue_t* queue, render_pass_t pass, const render_item_t* item, const vec3_t* center);
+void render_queue_sort(render_queue_t* queue);
+render_stats_t render_queue_execute(render_queue_t* queue);
+void render_queue_free(render_queue_t* queue);
+
+uint64_t render_queue_key(render_pass_t pass, const render_item_t* item, float depth);
+void render_entries_sort(list_t* entries, list_t* scratch);
@@ -14,10 +14,26 @@ typedef struct {
     GLuint id;
 } shader_t;
 
+// Permutation key, every set bit compiles one feature in through a #define
+typedef uint32_t shader_key_t;
+#define SHADER_KEY_NONE      0u
+#define SHADER_PACKED_VERTEX (1u << 0) // DE_PACKED_VERTEX: dequantized positions, oct encoded normals
+#define SHADER_TWO_SIDED     (1u << 1) // DE_TWO_SIDED: back faces flip the normal and sample texture1
+#define SHADER_INSTANCED     (1u << 2) // DE_INSTANCED: model and normal matrix per instance, see vao_link_vbo_instances
+#define SHADER_KEY_COUNT     3
+
+#define SHADER_DEFINES_SIZE  256
+#define SHADER_INCLUDE_DEPTH 8
+
 shader_t* shader_new(void);
 void shader_init_frag_shader(shader_t* shader);
 void shader_init_vert_shader(shader_t* shader);
 bool shader_compile(shader_t* shader, const GLchar* path);
+bool shader_compile_defines(shader_t* shader, const GLchar* path, const GLchar* defines);
+bool shader_compile_begin(shader_t* shader, const GLchar* path, const GLchar* defines);
+bool shader_compile_end(shader_t* shader);
 void shader_delete(shader_t* shader);
 void shader_destroy(shader_t* shader);
 char* shader_load_file(const char* path);
+char* shader_preprocess(const char* path, const char* defines);
+void shader_key_defines(shader_key_t key, char* defines, size_t size);
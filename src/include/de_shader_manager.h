@@ -8,6 +8,42 @@
 */
 #pragma once
 #include "pch.h"
+#include "de_program.h"
 #include "de_collection.h"
 
-void shader_mgr_pre_compile(list_t* recipes);
+#define PROGRAM_EXTENSION ".program"
+
+typedef int program_handle_t;
+#define PROGRAM_HANDLE_INVALID -1
+
+typedef struct {
+	char* vert;      // registry key, together with frag and defines
+	char* frag;
+	char* defines;   // injected after #version, empty for none
+	int ref_count;
+
+	bool pending;         // compile and link issued, status not read back yet
+	bool failed;          // the build finished with errors, the program is unusable
+	uint64_t source_hash; // written with the binary once the build succeeds, includes expanded
+	double load_seconds;  // time callers spent loading the binary or building the program
+	program_build_t build;
+	program_t program;
+} shared_program_t;
+
+program_handle_t shader_mgr_acquire(const char* vert, const char* frag, const char* defines);
+program_handle_t shader_mgr_acquire_async(const char* vert, const char* frag, const char* defines);
+program_handle_t shader_mgr_acquire_variant(const char* vert, const char* frag, shader_key_t key);
+program_handle_t shader_mgr_acquire_variant_async(const char* vert, const char* frag, shader_key_t key);
+bool shader_mgr_is_ready(program_handle_t handle);
+void shader_mgr_retain(program_handle_t handle);
+void shader_mgr_release(program_handle_t handle);
+shared_program_t* shader_mgr_get(program_handle_t handle);
+program_t* shader_mgr_program(program_handle_t handle);
+int shader_mgr_count(void);
+
+int shader_mgr_poll(void);
+void shader_mgr_finish(void);
+void shader_mgr_report(void);
+
+void shader_mgr_pre_load(list_t* recipes);
+void shader_mgr_shutdown(void);
@@ -0,0 +1,75 @@
+/**
+* @file de_sprite_batch.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_atlas.h"
+#include "de_color.h"
+#include "de_buffer.h"
+#include "de_vector.h"
+#include "de_matrix.h"
+#include "de_collection.h"
+#include "de_render_queue.h"
+#include "de_shader_manager.h"
+#include "de_texture_manager.h"
+
+// 2D quads in pixels, origin at the top-left of the window. Sprites are collected during the
+// frame and drawn by sprite_batch_end: sorted by layer then texture page, written to a
+// streaming vertex buffer in that order and drawn with one call per run of the same page.
+// Lower layers are drawn first. Within a layer sprites of the same page keep their order,
+// sprites of different pages do not, overlapping ones that care go on their own layer.
+#define SPRITE_LAYER_MIN (-32768)
+#define SPRITE_LAYER_MAX 32767
+
+typedef struct {
+	texture_handle_t texture; // the page, every sprite of an atlas shares it
+	uv_rect_t uv;
+	vec2_t position; // center
+	vec2_t size;
+	float rotation;  // radians, clockwise on screen, around the center
+	color_t color;   // multiplies the texture
+	int layer;
+} sprite_t;
+
+typedef struct {
+	float x;
+	float y;
+	float u;
+	float v;
+	GLubyte color[4];
+} sprite_vertex_t;
+
+typedef struct {
+	int draws;
+	int sprites;
+} sprite_stats_t;
+
+typedef struct {
+	program_handle_t program;
+	GLint uniform_projection;
+	GLint uniform_texture;
+
+	vao_t vao;
+	ebo_t ebo;                // the same two triangles for every quad, up to index_capacity quads
+	int index_capacity;
+	stream_buffer_t vertices; // sprite_vertex_t, four per sprite in draw order
+
+	list_t sprites;  // sprite_t, this frame's in submission order
+	list_t entries;  // render_entry_t, sorted by sprite_batch_end
+	list_t scratch;  // render_entry_t, the other half of the radix sort
+	sprite_stats_t stats; // of the last sprite_batch_end
+} sprite_batch_t;
+
+void sprite_batch_init(sprite_batch_t* batch, const char* vertex_shader, const char* fragment_shader);
+void sprite_batch_begin(sprite_batch_t* batch);
+void sprite_batch_draw(sprite_batch_t* batch, const sprite_t* sprite);
+sprite_stats_t sprite_batch_end(sprite_batch_t* batch);
+void sprite_batch_free(sprite_batch_t* batch);
+
+sprite_t sprite_from_texture(texture_handle_t texture, vec2_t position, vec2_t size);
+sprite_t sprite_from_atlas(const atlas_t* atlas, const char* sprite_name, vec2_t position);
@@ -0,0 +1,49 @@
+/**
+* @file de_static_batch.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_frustum.h"
+#include "de_material.h"
+#include "de_collection.h"
+#include "de_game_object.h"
+#include "de_render_queue.h"
+
+// Props that never move once the scene is loaded, moved into world space a single time.
+// Objects sharing a texture and a material become one mesh drawn by one draw call,
+// each object stays a meshlet of it so the render queue still culls them one by one.
+typedef struct {
+	mesh_handle_t mesh; // retained until the batch is built
+	mat4_t model;
+	sphere_t sphere;    // world space
+} static_source_t;
+
+typedef struct {
+	texture_handle_t texture;
+	material_t material;
+	list_t sources;     // static_source_t, emptied by static_batch_build
+	mesh_handle_t mesh; // merged, MESH_HANDLE_INVALID until static_batch_build
+} static_group_t;
+
+typedef struct {
+	program_handle_t program; // DE_PACKED_VERTEX variant of the batch shaders
+	GLint uniform_model;
+	GLint uniform_texture;
+	GLint uniform_dequant_scale;
+	GLint uniform_dequant_offset;
+
+	mat4_t model;  // identity, the vertices are already in world space
+	list_t groups; // static_group_t
+} static_batch_t;
+
+void static_batch_init(static_batch_t* batch, const char* vertex_shader, const char* fragment_shader);
+void static_batch_add(static_batch_t* batch, const game_object_t* go, const material_t* material);
+void static_batch_build(static_batch_t* batch);
+void static_batch_submit(static_batch_t* batch, render_queue_t* queue, const frustum_t* frustum);
+void static_batch_request_textures(const static_batch_t* batch, const vec3_t* eye);
+void static_batch_free(static_batch_t* batch);
@@ -0,0 +1,29 @@
+/**
+* @file de_texture_loader.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_dtex.h"
+
+typedef struct texture_job_t {
+	char* path;
+	void* owner;           // set to NULL by the owner to cancel, the workers never read it
+
+	unsigned char* pixels; // tightly packed and flipped, NULL when decoding failed
+	int width;
+	int height;
+	int channels;
+	dtex_t dtex;           // mapped cooked texture, used instead of pixels when present
+
+	struct texture_job_t* next;
+} texture_job_t;
+
+texture_job_t* texture_loader_submit(const char* path, void* owner);
+texture_job_t* texture_loader_poll(void);
+void texture_loader_free_job(texture_job_t* job);
+void texture_loader_shutdown(void);
@@ -0,0 +1,51 @@
+/**
+* @file de_texture_manager.h
+* @author Hudson Schumaker
+* @version 1.0.0
+*
+* Dodoi-Engine is a game engine developed by Dodoi-Lab.
+* @copyright Copyright (c) 2025, Dodoi-Lab
+*/
+#pragma once
+#include "pch.h"
+#include "de_buffer.h"
+#include "de_collection.h"
+#include "de_texture_loader.h"
+
+typedef int texture_handle_t;
+#define TEXTURE_HANDLE_INVALID -1
+
+typedef struct {
+	char* path;        // registry key, together with the sampler state
+	sampler_t sampler;
+	int ref_count;
+
+	tbo_t tbo;
+	bool ready;         // false until the pixels are uploaded, the placeholder is bound meanwhile
+	texture_job_t* job; // decode in flight for async textures
+	bool failed;        // the async decode failed, the placeholder stays bound for good
+
+	bool streamed;         // resident mips follow the on-screen size passed to texture_mgr_request
+	dtex_t dtex;           // stays mapped while streamed, finer levels are read from it on demand
+	int resident_level;    // finest mip level in video memory
+	int tail_level;        // this level and the coarser ones load up front and never leave
+	float screen_size;     // largest projected size requested this frame, in pixels
+	size_t resident_bytes;
+} shared_texture_t;
+
+texture_handle_t texture_mgr_acquire(const char* path, const sampler_t* sampler);
+texture_handle_t texture_mgr_acquire_async(const char* path, const sampler_t* sampler);
+texture_handle_t texture_mgr_acquire_streamed(const char* path, const sampler_t* sampler);
+void texture_mgr_retain(texture_handle_t handle);
+void texture_mgr_release(texture_handle_t handle);
+shared_texture_t* texture_mgr_get(texture_handle_t handle);
+void texture_mgr_bind(texture_handle_t handle, GLuint slot);
+bool texture_mgr_is_ready(texture_handle_t handle);
+bool texture_mgr_has_failed(texture_handle_t handle);
+int texture_mgr_count(void);
+void texture_mgr_request(texture_handle_t handle, float screen_size);
+void texture_mgr_set_stream_budget(size_t bytes);
+size_t texture_mgr_stream_usage(void);
+void texture_mgr_update(float budget_ms);
+void texture_mgr_shutdown(void);
+void texture_mgr_pre_cook(list_t* textures);
@@ -22,3 +22,19 @@ char* concat(const char* s1, const char* s2);
 
 // File functions
 bool file_exists(const char* path);
+uint64_t file_stamp(const char* path); // size and last write time hashed, 0 when the file is missing
+
+// Hashing, FNV-1a. Pass the previous result as seed to hash several buffers as one
+#define HASH_SEED 0xcbf29ce484222325ull
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed);
+
+// Shader symbol names, FNV-1a (32 bit). NAME_HASH works on string literals and folds to a
+// constant, hash_name gives the same value at run time. Only the first NAME_HASH_LENGTH characters count
+#define NAME_HASH_LENGTH 32
+#define NAME_HASH_BASIS 2166136261u
+#define NAME_HASH_PRIME 16777619u
+#define NAME_HASH_IN(s, i) ((i) < sizeof(s) - 1)
+#define NAME_HASH_STEP(h, s, i) (((h) ^ (uint32_t)(unsigned char)(s)[NAME_HASH_IN(s, i) ? (i) : 0] * NAME_HASH_IN(s, i)) * (NAME_HASH_IN(s, i) ? NAME_HASH_PRIME : 1u))
+#define NAME_HASH_4(h, s, i) NAME_HASH_STEP(NAME_HASH_STEP(NAME_HASH_STEP(NAME_HASH_STEP(h, s, i), s, (i) + 1), s, (i) + 2), s, (i) + 3)
+#define NAME_HASH(s) ((uint32_t)NAME_HASH_4(NAME_HASH_4(NAME_HASH_4(NAME_HASH_4(NAME_HASH_4(NAME_HASH_4(NAME_HASH_4(NAME_HASH_4(NAME_HASH_BASIS, s, 0), s, 4), s, 8), s, 12), s, 16), s, 20), s, 24), s, 28))
+uint32_t hash_name(const char* name);
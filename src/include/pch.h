@@ -24,6 +24,7 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_mixer.h>
+#include <SDL_ttf.h>
 
 // Window settings
 #define WINDOW_WIDTH 1080
@@ -56,6 +57,17 @@
 #define STRIDE_3f_3f 6 * sizeof(GLfloat)
 #define STRIDE_3f_3f_2f 8 * sizeof(GLfloat)
 #define STRIDE_3f_3f_3f 9 * sizeof(GLfloat)
+#define STRIDE_3f_2s_2h 3 * sizeof(GLfloat) + 2 * sizeof(GLshort) + 2 * sizeof(GLhalf)
+#define STRIDE_4s_2s_2h 6 * sizeof(GLshort) + 2 * sizeof(GLhalf)
+#define STRIDE_16f_12f 28 * sizeof(GLfloat) // instance: mat4 model, mat3 normal matrix in vec4 columns
+#define STRIDE_2f_2f_4ub 4 * sizeof(GLfloat) + 4 * sizeof(GLubyte) // sprite: position, uv, rgba8 color
+
+// Level of detail
+#define MESH_LOD_RATIO 0.5f      // triangles kept per level
+#define MESH_LOD_THRESHOLD 1.0f  // max projected error in pixels
+
+// Meshlets
+#define MESHLET_MIN_TRIANGLES 1024 // meshes smaller than this are culled as a whole
 
 // MVP
 #define EYE "eye"
@@ -65,30 +77,27 @@
 #define POSITION "aPosition"
 #define NORMAL "aNormal"
 #define TEX_COORD "aTexCoord"
+#define DEQUANT_SCALE "dequantScale"
+#define DEQUANT_OFFSET "dequantOffset"
+
+// Instancing, per instance attributes after the vertex ones
+#define INSTANCE_MODEL "aModel"
+#define INSTANCE_NORMAL "aNormalMatrix"
+#define INSTANCE_MODEL_LAYOUT 3  // mat4, locations 3 to 6
+#define INSTANCE_NORMAL_LAYOUT 7 // mat3, locations 7 to 9
 
 // Texture
 #define TEXTURE "texture0"
 #define TEXTURE1 "texture1"
+#define TEXTURE_UPLOAD_BUDGET_MS 2.0f // per frame, finished decodes wait for the next one
+#define TEXTURE_STREAM_BUDGET_MB 128  // video memory for streamed mips, the least needed go first past it
+#define TEXTURE_STREAM_TAIL_SIZE 64   // mips this size and smaller load with the texture and stay
 
-// Light
-#define LIGHT_COLOR "light.color"
-#define LIGHT_POSITION "light.position"
-#define LIGHT_DIRECTION "light.direction"
-#define LIGHT_AMBIENT "light.ambient"
-#define LIGHT_DIFFUSE "light.diffuse"
-#define LIGHT_SPECULAR "light.specular"
-
-// Attenuation
-#define LIGHT_LINEAR "light.linear"
-#define LIGHT_CONSTANT "light.constant"
-#define LIGHT_QUADRATIC "light.quadratic"
-
-// Material
-#define MATERIAL_AMBIENT "material.ambient"
-#define MATERIAL_DIFFUSE "material.diffuse"
-#define MATERIAL_SPECULAR "material.specular"
-#define MATERIAL_SHININESS "material.shininess"
-#define MATERIAL_DIFFUSE_MAP "material.diffuseMap"
+// Uniform blocks, every program binds them to the same points
+#define FRAME_BLOCK "FrameBlock"       // camera and lights, uploaded once per frame
+#define MATERIAL_BLOCK "MaterialBlock" // one buffer per distinct material
+#define FRAME_BINDING 0
+#define MATERIAL_BINDING 1
 
 // Dodoi-Engine folders
 #define MAP_FOLDER "./data/maps/"
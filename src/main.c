@@ -14,15 +14,29 @@
 #include "playground/title_screen.h"
 #include "playground/splash_screen.h"
 #include "include/de_shader_manager.h"
+#include "include/de_atlas.h"
+#include "include/de_font.h"
+#include "include/de_jobs.h"
+#include "include/de_frame.h"
+#include "include/de_material.h"
+#include "include/de_texture_manager.h"
 
 void shaders(void);
+void textures(void);
+void atlases(void);
+void fonts(void);
 bpair_t args(int argc, char* argv[]);
 
 int main(int argc, char* argv[]) {	
 	bpair_t arg = args(argc, argv);
 	gfx_init(arg.first, arg.second);
 
+	// Shaders compile in the driver while the textures are cooked
 	shaders();
+	textures();
+	atlases();
+	fonts();
+	shader_mgr_finish();
 	splash_screen_init();
 	title_screen_init();
 
@@ -32,6 +46,11 @@ int main(int argc, char* argv[]) {
 	short r = scene_manager_set_scene(splash_screen);
 	scene_manager_set_scene(title_screen);
 
+	texture_mgr_shutdown();
+	shader_mgr_shutdown();
+	material_shutdown();
+	frame_shutdown();
+	jobs_shutdown();
 	return 0;
 }
 
@@ -49,15 +68,79 @@ bpair_t args(int argc, char* argv[]) {
 }
 
 void shaders(void) {
-	recipe_t basic = { "basic", "basic.vert", "basic.frag" };
-	recipe_t cube = { "cube", "cube.vert", "cube.frag" };
-	recipe_t direction_light = { "directional-light", "directional-light.vert", "directional-light.frag" };
+	recipe_t basic = { "basic", "basic.vert", "basic.frag", NULL, SHADER_KEY_NONE };
+	recipe_t cube = { "cube", "cube.vert", "cube.frag", NULL, SHADER_KEY_NONE };
+	recipe_t direction_light = { "directional-light", "directional-light.vert", "directional-light.frag", NULL, SHADER_KEY_NONE };
+	recipe_t direction_light_packed = { "directional-light-packed", "directional-light.vert", "directional-light.frag", NULL, SHADER_PACKED_VERTEX };
+	recipe_t direction_light_instanced = { "directional-light-instanced", "directional-light.vert", "directional-light.frag", NULL, SHADER_PACKED_VERTEX | SHADER_INSTANCED };
+	recipe_t sprite = { "sprite", "sprite.vert", "sprite.frag", NULL, SHADER_KEY_NONE };
+	recipe_t sdf_text = { "sdf-text", "sprite.vert", "sdf-text.frag", NULL, SHADER_KEY_NONE };
 
 	list_t shader_recipes;
 	list_init(&shader_recipes, sizeof(recipe_t));
 	list_add(&shader_recipes, &basic);
 	list_add(&shader_recipes, &cube);
 	list_add(&shader_recipes, &direction_light);
+	list_add(&shader_recipes, &direction_light_packed);
+	list_add(&shader_recipes, &direction_light_instanced);
+	list_add(&shader_recipes, &sprite);
+	list_add(&shader_recipes, &sdf_text);
 
-	shader_mgr_pre_compile(&shader_recipes);
+	// Every program a scene asks for afterwards is already in the registry
+	shader_mgr_pre_load(&shader_recipes);
+	list_free(&shader_recipes);
+}
+
+void textures(void) {
+	const char* icon = "icon.png";
+	const char* grid = "grid.jpg";
+	const char* crate = "crate.jpg";
+
+	list_t texture_names;
+	list_init(&texture_names, sizeof(char*));
+	list_add(&texture_names, &icon);
+	list_add(&texture_names, &grid);
+	list_add(&texture_names, &crate);
+
+	texture_mgr_pre_cook(&texture_names);
+}
+
+void atlases(void) {
+	static const char* ranks[] = { "2", "3", "4", "5", "6", "7", "8", "9", "10", "j", "q", "k", "a" };
+	static const char* suits[] = { "cop", "esp", "our", "pa" };
+	static const char* extras[] = {
+		"jokerblack.png", "jokergreen.png", "jokerredblue.png",
+		"jokerblack1.png", "jokercolor1.png", "jokergreen1.png",
+		"cback01.png", "cback02.png", "cback03.png", "cback04.png",
+		"newback11.png", "newback22.png", "newback23.png", "newback24.png", "newback25.png", "newback33.png"
+	};
+	static char faces[13 * 4][16];
+
+	list_t card_names;
+	list_init(&card_names, sizeof(char*));
+	for (int r = 0; r < 13; r++) {
+		for (int s = 0; s < 4; s++) {
+			char* face = faces[r * 4 + s];
+			snprintf(face, sizeof(faces[0]), "%s%s.png", ranks[r], suits[s]);
+			list_add(&card_names, &face);
+		}
+	}
+	for (int i = 0; i < (int)(sizeof(extras) / sizeof(extras[0])); i++) {
+		list_add(&card_names, (void*)&extras[i]);
+	}
+
+	if (!atlas_is_cooked(&card_names, "cards")) {
+		atlas_cook(&card_names, "cards");
+	}
+	list_free(&card_names);
+}
+
+void fonts(void) {
+	if (font_is_cooked("consola.ttf", "consola")) {
+		return;
+	}
+
+	// Consolas ships with Windows, a copy in data/fonts takes its place.
+	// Without either the title screen goes without its labels.
+	font_cook("consola.ttf", "consola");
 }
@@ -9,6 +9,7 @@
 #include "splash_screen.h"
 #include "../include/de_gfx.h"
 #include "../include/de_cube.h"
+#include "../include/de_frame.h"
 #include "../include/de_util.h"
 #include "../include/de_math.h"
 #include "../include/de_camera.h"
@@ -19,6 +20,7 @@ static scene_t* splash_screen = NULL;
 
 static mat4_t projection;
 static mat4_t view;
+static frame_t frame;
 
 static cube_t cube;
 static cube_t _floor;
@@ -30,8 +32,6 @@ static vec3_t cube_pos = { 0.0f, 2.0f, -10.0f };
 static vec3_t floor_pos = { 0.0f, 0.0f, 0.0f };
 static float angle = 45.0f;
 
-static mesh_t* mesh = NULL;
-
 void check_gl_error(const char* function) {
     GLenum error = glGetError();
     while (error != GL_NO_ERROR) {
@@ -79,6 +79,7 @@ void splash_screen_load(void) {
 	cube_set_scale(&_floor, &scale);
 
     camera = fps_camera_new(position, target);
+    frame = frame_init();
 
 	gfx_set_clear_color(0.0f, 0.2f, 0.0f, 1.0f);
 
@@ -192,6 +193,12 @@ void splash_screen_render(void) {
     gfx_set_3d_mode();
 	gfx_clear_screen();
 
+	// Camera and lights for every program, uploaded once
+	frame.view = view;
+	frame.projection = projection;
+	frame.eye = camera->coords.eye;
+	frame_upload(&frame);
+
 	cube_render(&cube, &view, &projection);
 	cube_render(&_floor, &view, &projection);
 	
@@ -202,6 +209,7 @@ short splash_screen_run(void) {
     while (running) {
         splash_screen_input();
         splash_screen_update();
+        texture_mgr_update(TEXTURE_UPLOAD_BUDGET_MS);
         splash_screen_render();
         scene_manager_calculate_delta_time();
     }
@@ -9,10 +9,14 @@
 #include "title_screen.h"
 #include "../include/de_gfx.h"
 #include "../include/de_cube.h"
+#include "../include/de_frame.h"
 #include "../include/de_util.h"
 #include "../include/de_math.h"
 #include "../include/de_mouse.h"
 #include "../include/de_camera.h"
+#include "../include/de_static_batch.h"
+#include "../include/de_sprite_batch.h"
+#include "../include/de_font.h"
 
 static bool running = false;
 static scene_t* title_screen = NULL;
@@ -20,11 +24,39 @@ static fps_camera_t* camera = NULL;
 
 static mat4_t projection;
 static mat4_t view;
+static frame_t frame;
+static render_queue_t queue;
+static render_stats_t last_stats;
 
 static cube_t cube;
 static cube_t cube2;
 static cube_t cube3;
-static cube_t _floor;
+
+// The floor and the crates around it never move, merged at load
+#define SCENERY_CRATES 16
+#define SCENERY_RADIUS 16.0f
+static static_batch_t scenery;
+
+// Static cubes past the floor, drawn as instanced batches
+#define FIELD_SIZE 64
+#define FIELD_SPACING 1.5f
+static cube_t field[FIELD_SIZE * FIELD_SIZE];
+
+// A hand of cards fanned over the scene, one draw for the whole atlas page
+#define HAND_CARDS 13
+#define HAND_CARD_HEIGHT 160.0f
+#define HAND_SPREAD 0.9f // radians from the first card to the last
+static sprite_batch_t sprites;
+static sprite_stats_t last_sprite_stats;
+static atlas_t cards;
+
+// Labels over everything else, the title laid out once and the stats every frame
+#define LABEL_SIZE 20.0f
+#define LABEL_MARGIN 12.0f
+static sprite_batch_t labels;
+static font_t font;
+static text_run_t title;
+static bool labels_ready = false; // false without a cooked font, the scene runs without labels
 
 static vec3_t target = { 0.0f, 0.0f, 0.0f };
 static vec3_t position = { 0.0f, 1.0f, -5.0f };
@@ -32,7 +64,6 @@ static vec3_t position = { 0.0f, 1.0f, -5.0f };
 static vec3_t cube_pos = { 0.0f, 2.0f, 10.0f };
 static vec3_t cube2_pos = { 10.0f, 2.0f, 10.0f };
 static vec3_t cube3_pos = { -10.0f, 3.0f, 10.0f };
-static vec3_t floor_pos = { 0.0f, .0f, 0.0f };
 static float angle = 15.0f;
 
 void title_screen_init(void) {
@@ -54,10 +85,9 @@ void title_screen_init(void) {
 }
 
 void title_screen_load(void) {
-    cube_init(&cube, "directional-light.vert", "directional-light.frag", "icon.png", "cube.obj");
-    cube_init(&cube2, "directional-light.vert", "directional-light.frag", "icon.png", "cube.obj");
-    cube_init(&cube3, "directional-light.vert", "directional-light.frag", "crate.jpg", "crate.obj");
-    cube_init(&_floor, "directional-light.vert", "directional-light.frag", "grid.jpg", "floor.obj");
+    cube_init_with_format(&cube, "directional-light.vert", "directional-light.frag", "icon.png", "cube.obj", VERTEX_FORMAT_PACKED_QUANTIZED);
+    cube_init_with_format(&cube2, "directional-light.vert", "directional-light.frag", "icon.png", "cube.obj", VERTEX_FORMAT_PACKED_QUANTIZED);
+    cube_init_with_format(&cube3, "directional-light.vert", "directional-light.frag", "crate.jpg", "crate.obj", VERTEX_FORMAT_PACKED_QUANTIZED);
 
     cube2.material = material_chrome();
     cube3.material = material_red_rubber();
@@ -65,12 +95,60 @@ void title_screen_load(void) {
     cube_set_position(&cube, &cube_pos);
     cube_set_position(&cube2, &cube2_pos);
     cube_set_position(&cube3, &cube3_pos);
-    cube_set_position(&_floor, &floor_pos);
 
-    vec3_t scale = vec3_new(20.0f, 0.1f, 20.0f);
-    cube_set_scale(&_floor, &scale);
+    // Loaded like any other cube, only their world space copy is kept
+    static_batch_init(&scenery, "directional-light.vert", "directional-light.frag");
+    cube_t prop;
+    cube_init_with_format(&prop, "directional-light.vert", "directional-light.frag", "grid.jpg", "floor.obj", VERTEX_FORMAT_PACKED);
+    vec3_t floor_scale = vec3_new(20.0f, 0.1f, 20.0f);
+    cube_set_scale(&prop, &floor_scale);
+    cube_update(&prop);
+    static_batch_add(&scenery, &prop.go, &prop.material);
+    cube_delete(&prop);
+
+    for (int i = 0; i < SCENERY_CRATES; i++) {
+        float crate_angle = TWO_PI * (float)i / SCENERY_CRATES;
+        vec3_t crate_pos = vec3_new(cosf(crate_angle) * SCENERY_RADIUS, 0.0f, sinf(crate_angle) * SCENERY_RADIUS);
+        vec3_t crate_rotation = vec3_new(0.0f, (float)(i * 37 % 90), 0.0f);
+        cube_init_with_format(&prop, "directional-light.vert", "directional-light.frag", "crate.jpg", "crate.obj", VERTEX_FORMAT_PACKED);
+        prop.material = material_red_rubber();
+        cube_set_position(&prop, &crate_pos);
+        cube_set_rotation(&prop, &crate_rotation);
+        cube_update(&prop);
+        static_batch_add(&scenery, &prop.go, &prop.material);
+        cube_delete(&prop);
+    }
+    static_batch_build(&scenery);
+
+    vec3_t field_scale = vec3_new(0.5f, 0.5f, 0.5f);
+    for (int i = 0; i < FIELD_SIZE * FIELD_SIZE; i++) {
+        vec3_t field_pos = vec3_new((i % FIELD_SIZE - FIELD_SIZE / 2) * FIELD_SPACING, 0.5f, 25.0f + (i / FIELD_SIZE) * FIELD_SPACING);
+        cube_init_instanced(&field[i], "directional-light.vert", "directional-light.frag", "icon.png", "cube.obj", VERTEX_FORMAT_PACKED_QUANTIZED);
+        field[i].material = i % 2 == 0 ? material_brass() : material_chrome();
+        cube_set_scale(&field[i], &field_scale);
+        cube_set_position(&field[i], &field_pos);
+        cube_update(&field[i]);
+    }
+
+    sprite_batch_init(&sprites, "sprite.vert", "sprite.frag");
+    if (!atlas_load(&cards, "cards")) {
+        fprintf(stderr, "failed to load atlas: cards.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    labels_ready = font_load(&font, "consola");
+    if (labels_ready) {
+        sprite_batch_init(&labels, "sprite.vert", "sdf-text.frag");
+        text_run_init(&title, &font, "Dodoi Engine", LABEL_SIZE * 2.0f);
+    }
+    else {
+        fprintf(stderr, "failed to load font: consola, labels disabled.\n");
+        font_delete(&font);
+    }
 
     camera = fps_camera_new(position, target);
+    frame = frame_init();
+    render_queue_init(&queue);
     gfx_set_clear_color(0.5f, 0.5f, 0.0f, 1.0f);
 
     running = true;
@@ -182,29 +260,114 @@ void title_screen_update(void) {
     vec3_t rotation2 = { -angle, -angle, -angle };
     cube_set_rotation(&cube, &rotation);
     cube_update(&cube);
+    game_object_select_lod(&cube.go, &camera->coords.eye);
+    game_object_request_texture(&cube.go, &camera->coords.eye);
 
     cube_set_rotation(&cube2, &rotation2);
     cube_update(&cube2);
+    game_object_select_lod(&cube2.go, &camera->coords.eye);
+    game_object_request_texture(&cube2.go, &camera->coords.eye);
 
     cube_set_rotation(&cube3, &rotation);
     cube_update(&cube3);
+    game_object_select_lod(&cube3.go, &camera->coords.eye);
+    game_object_request_texture(&cube3.go, &camera->coords.eye);
 
-    //cube_set_rotation(&_floor, &rotation);
-    cube_update(&_floor);
+    static_batch_request_textures(&scenery, &camera->coords.eye);
 
     angle += 25.0f * scene_manager_get_delta_time();
     angle = normalize_anglef(angle);
 }
 
+static void title_screen_render_hand(void) {
+    static const char* ranks[] = { "2", "3", "4", "5", "6", "7", "8", "9", "10", "j", "q", "k", "a" };
+
+    // The cards turn around a pivot below the window, the deck sits under them on its own layer
+    ipair_t window = gfx_get_window_size();
+    vec2_t pivot = vec2_new(window.first * 0.5f, window.second + HAND_CARD_HEIGHT * 2.0f);
+    float radius = HAND_CARD_HEIGHT * 2.6f;
+
+    gfx_set_2d_mode();
+    sprite_batch_begin(&sprites);
+    sprite_t deck = sprite_from_atlas(&cards, "cback01.png", vec2_new(HAND_CARD_HEIGHT * 0.5f, window.second - HAND_CARD_HEIGHT * 0.5f));
+    vec2_scale(&deck.size, HAND_CARD_HEIGHT / deck.size.y);
+    deck.layer = -1;
+    sprite_batch_draw(&sprites, &deck);
+
+    for (int i = 0; i < HAND_CARDS; i++) {
+        char name[ATLAS_NAME_LENGTH];
+        snprintf(name, sizeof(name), "%sesp.png", ranks[i]);
+        float card_angle = HAND_SPREAD * ((float)i / (HAND_CARDS - 1) - 0.5f);
+        vec2_t offset = vec2_new(sinf(card_angle) * radius, -cosf(card_angle) * radius);
+        sprite_t card = sprite_from_atlas(&cards, name, vec2_add(&pivot, &offset));
+        vec2_scale(&card.size, HAND_CARD_HEIGHT / card.size.y);
+        card.rotation = card_angle;
+        sprite_batch_draw(&sprites, &card);
+    }
+
+    sprite_stats_t stats = sprite_batch_end(&sprites);
+    if (memcmp(&stats, &last_sprite_stats, sizeof(sprite_stats_t)) != 0) {
+        printf("Sprites: %d in %d draws\n", stats.sprites, stats.draws);
+        last_sprite_stats = stats;
+    }
+}
+
+static void title_screen_render_labels(const render_stats_t* stats) {
+    if (!labels_ready) {
+        return;
+    }
+
+    char line[128];
+    snprintf(line, sizeof(line), "%.0f fps\n%d draws, %d instanced\n%d sprites in %d draws",
+        1.0f / maxf(scene_manager_get_delta_time(), 0.0001f), stats->draws, stats->instances, last_sprite_stats.sprites, last_sprite_stats.draws);
+
+    sprite_batch_begin(&labels);
+    text_run_draw(&title, &labels, vec2_new(LABEL_MARGIN, LABEL_MARGIN), color_get_white(), 0);
+    text_draw(&labels, &font, line, LABEL_SIZE, vec2_new(LABEL_MARGIN, LABEL_MARGIN + title.bounds.y), color_get_yellow(), 0);
+    sprite_batch_end(&labels);
+}
+
 void title_screen_render(void) {
     gfx_set_3d_mode();
     gfx_clear_screen();
 
-    cube_render(&cube, &view, &projection);
-    cube_render(&cube2, &view, &projection);
-    cube_render(&cube3, &view, &projection);
-    cube_render(&_floor, &view, &projection);
+    // Camera and lights for every program, uploaded once
+    frame.view = view;
+    frame.projection = projection;
+    frame.eye = camera->coords.eye;
+    frame_upload(&frame);
+
+    mat4_t view_projection = mat4_mul_mat4(&projection, &view);
+    frustum_t frustum = frustum_from_matrix(&view_projection);
+
+    // Submitted in scene order, drawn sorted by state
+    render_queue_begin(&queue, &view, &projection, &camera->coords.eye);
+    cube_t* cubes[] = { &cube, &cube2, &cube3 };
+    for (int i = 0; i < 3; i++) {
+        if (game_object_in_frustum(&cubes[i]->go, &frustum)) {
+            cube_submit(cubes[i], &queue);
+        }
+    }
+    for (int i = 0; i < FIELD_SIZE * FIELD_SIZE; i++) {
+        if (game_object_in_frustum(&field[i].go, &frustum)) {
+            cube_submit(&field[i], &queue);
+        }
+    }
+    static_batch_submit(&scenery, &queue, &frustum);
+    gl_state_reset_stats();
+    render_stats_t stats = render_queue_execute(&queue);
+    if (memcmp(&stats, &last_stats, sizeof(render_stats_t)) != 0) {
+        gl_state_stats_t calls = gl_state_stats();
+        printf("Frame: %d draws, %d instanced, %d programs, %d materials, %d textures, %d meshes, %d state calls issued, %d skipped\n",
+            stats.draws, stats.instances, stats.program_switches, stats.material_switches, stats.texture_switches, stats.mesh_switches, calls.issued, calls.skipped);
+        last_stats = stats;
+#ifdef _DEBUG
+        gl_state_validate();
+#endif
+    }
 
+    title_screen_render_hand();
+    title_screen_render_labels(&stats);
     gfx_swap_screen();
 }
 
@@ -212,6 +375,7 @@ short title_screen_run(void) {
     while (running) {
         title_screen_input();
         title_screen_update();
+        texture_mgr_update(TEXTURE_UPLOAD_BUDGET_MS);
         title_screen_render();
         scene_manager_calculate_delta_time();
     }
@@ -222,7 +386,19 @@ void title_screen_unload(void) {
     cube_delete(&cube);
     cube_delete(&cube2);
     cube_delete(&cube3);
-    cube_delete(&_floor);
+    static_batch_free(&scenery);
+    for (int i = 0; i < FIELD_SIZE * FIELD_SIZE; i++) {
+        cube_delete(&field[i]);
+    }
+    render_queue_free(&queue);
+    sprite_batch_free(&sprites);
+    atlas_delete(&cards);
+    if (labels_ready) {
+        text_run_free(&title);
+        font_delete(&font);
+        sprite_batch_free(&labels);
+        labels_ready = false;
+    }
     printf("Title Screen: Unload\n");
 }
 